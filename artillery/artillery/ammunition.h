@@ -4,7 +4,8 @@
  * Author:
  *    Amber Robbins
  * Summary:
- *    Contains the logic that governs the bullets.
+ *    Contains the logic that governs the bullets. An AmmunitionT can fly
+ *    on any scalar; Ammunition is the one the game fires, on doubles.
  ************************************************************************/
 
 #ifndef ammunition_h
@@ -12,13 +13,21 @@
 
 #include "position.h"
 #include "motion.h"
+#include "uiDraw.h"
+#include "profiler.h"
+#include "trace.h"
+#include <cassert>
 #include <deque>
 #include <iostream>
 
-class Ammunition
+template <class T = double>
+class AmmunitionT
 {
 public:
-   Ammunition(const double area, const double mass, Position &pos)
+   // where it is: a Position for doubles, so it can be drawn
+   typedef typename PositionOf <T> ::type PositionType;
+
+   AmmunitionT(const double area, const double mass, const PositionT <T> &pos)
    {
 	  this->area = area;  // equals TRIPLE7_AREA
 	  this->mass = mass;  // equals TRIPLE7_MASS
@@ -27,6 +36,8 @@ public:
 	  this->position.setMetersXY(pos.getMetersX(), pos.getMetersY());
 	  
 	  this->alive = true; // ammo is alive when it is initially fired
+	  this->trailStride = 1;
+	  this->stepsSinceTrail = 0;
 
 	  resetAcceleration();
 	  
@@ -35,81 +46,130 @@ public:
    // getters
    double         getArea()         const { return area;         }
    double         getMass()         const { return mass;         }
-   Motion         getVelocity()     const { return velocity;     }
-   Motion         getAcceleration() const { return acceleration; }
-   Position       getPosition()     const
+   MotionT <T>    getVelocity()     const { return velocity;     }
+   MotionT <T>    getAcceleration() const { return acceleration; }
+   PositionType   getPosition()     const
    {
-	  return Position(position.getMetersX(), position.getMetersY());
+	  return PositionType(position.getMetersX(), position.getMetersY());
    }
 	
    bool isAlive() const { return alive; }
    void setIsAlive(const bool alive) { this->alive = alive; }
+
+   // how many advances between the points of the trail. When the time
+   // is warped, this many steps are drawn as one so the trail keeps
+   // its length on the screen
+   void setTrailStride(int steps) { assert(steps >= 1); trailStride = steps; }
    
 	
-   void applyDrag(Motion resistance)
+   void applyDrag(MotionT <T> resistance)
    {
 	  resetAcceleration();
 	  acceleration.add(resistance);
    }
    
-   void fire(const double initialVelocity, const Angle angle);
+   void fire(const T & initialVelocity, const AngleT <T> angle);
+   void launch(const T & initialVelocity, const AngleT <T> angle);
+   void launchRadians(const T & initialVelocity, const T & radians);
    void advance();
    void displayAmmunition() const;
-   void draw(ogstream& gout) const;
+   void draw(ogstream& gout, double interpolation = 1.0) const;
    
 private:
-   Position position;
-   Position projectilePath[20];  // path of the projectile
+   PositionT <T> position;
+   Position projectilePath[20];  // path of the projectile, only for drawing
    
-   Motion velocity;
-   Motion acceleration;
+   MotionT <T> velocity;
+   MotionT <T> acceleration;
 
    double area;
    double mass;
    bool alive;
+   int trailStride;       // advances between the points of the trail
+   int stepsSinceTrail;   // since the trail last moved along
    
    // Sets acceleration values to zero and the force
    // of gravity so they can be computed fresh again.
    void resetAcceleration() { acceleration.setMetersXY(0, -1 * GRAVITY); }
 };
 
+typedef AmmunitionT <double> Ammunition;
+
 /*******************************************
  * AMMUNITION :: FIRE
  * Sets up the initial position and
- * trajectory of the fired ammo.
+ * trajectory of the fired ammo, and
+ * tells the console about it.
  * *****************************************/
-void Ammunition::fire(const double initialVelocity, const Angle angle)
+template <class T>
+inline void AmmunitionT <T> ::fire(const T & initialVelocity, const AngleT <T> angle)
 {
    std::cout << "\nProjectile fired at: " << std::endl;
    angle.display();
 
-   velocity.setMovement(initialVelocity, angle);
+   launch(initialVelocity, angle);
    std::cout << std::endl;
+}
+
+/*******************************************
+ * AMMUNITION :: LAUNCH
+ * Fire without a word, for when we fire
+ * many rounds nobody is watching.
+ * *****************************************/
+template <class T>
+inline void AmmunitionT <T> ::launch(const T & initialVelocity, const AngleT <T> angle)
+{
+   launchRadians(initialVelocity, angle.getRadians());
+}
+
+/*******************************************
+ * AMMUNITION :: LAUNCH RADIANS
+ * The same, at exactly this angle. An Angle
+ * snaps onto 30, 45 and so on when it is
+ * near them, which is good for the barrel
+ * on the screen but not for aiming: every
+ * angle in the snap lands in one place.
+ * *****************************************/
+template <class T>
+inline void AmmunitionT <T> ::launchRadians(const T & initialVelocity, const T & radians)
+{
+   velocity.setMetersX(cos(radians) * initialVelocity);
+   velocity.setMetersY(sin(radians) * initialVelocity);
 
    // ammo originates at the position of the ptHowitzer
-   projectilePath[0].setMetersX(position.getMetersX());
-   projectilePath[0].setMetersY(position.getMetersY());
+   projectilePath[0].setMetersX(getValue(position.getMetersX()));
+   projectilePath[0].setMetersY(getValue(position.getMetersY()));
 }
 
 /*******************************************
  * AMMUNITION :: ADVANCE
  * Moves the bullet to a new position
- * and saves a trail of position values.
+ * and saves a trail of position values,
+ * one every trailStride advances. The
+ * head of the trail is always the bullet.
  * *****************************************/
-void Ammunition::advance()
+template <class T>
+inline void AmmunitionT <T> ::advance()
 {
+   ProfileScope scope(Profiler::INTEGRATE);
+   TRACE_SPAN("Ammunition::advance");
+
    // update position based on velocity
    position.addMetersX(velocity.getMetersX());
    position.addMetersY(velocity.getMetersY());
 
-   for (int i = 19; i >= 1; --i)
+   if (++stepsSinceTrail >= trailStride)
    {
-	  projectilePath[i] = projectilePath[i - 1];
+	  for (int i = 19; i >= 1; --i)
+	  {
+		 projectilePath[i] = projectilePath[i - 1];
+	  }
+	  stepsSinceTrail = 0;
    }
 
    // update projectile path
-   projectilePath[0].setMetersX(position.getMetersX());
-   projectilePath[0].setMetersY(position.getMetersY());
+   projectilePath[0].setMetersX(getValue(position.getMetersX()));
+   projectilePath[0].setMetersY(getValue(position.getMetersY()));
 
    // apply acceleration to velocity
    velocity.addMetersX(acceleration.getMetersX());
@@ -123,7 +183,8 @@ void Ammunition::advance()
  * to moniter the member variables of
  * ammuntion.
  * ******************************************/
-void Ammunition::displayAmmunition() const
+template <class T>
+inline void AmmunitionT <T> ::displayAmmunition() const
 {
    position.displayPosition("Position");
    velocity.displayPosition("Velocity");
@@ -133,13 +194,27 @@ void Ammunition::displayAmmunition() const
 /*******************************************
  * AMMUNITON :: DRAW
  * Draws the bullet and trail onto
- * the screen.
+ * the screen. Interpolation says how far
+ * we are between the last advance and the
+ * next: each point of the trail is drawn
+ * that far between where it was and where
+ * it is now.
  * *****************************************/
-void Ammunition::draw(ogstream& gout) const
+template <class T>
+inline void AmmunitionT <T> ::draw(ogstream& gout, const double interpolation) const
 {
    for (int i = 0; i < 20; i++)
    {
-	  gout.drawProjectile(projectilePath[i], 0.5 * (double)i);
+	  Position pos(projectilePath[i]);
+	  if (i < 19)
+	  {
+		 const Position & posPrevious = projectilePath[i + 1];
+		 pos.setMetersXY(posPrevious.getMetersX() + interpolation *
+						 (projectilePath[i].getMetersX() - posPrevious.getMetersX()),
+						 posPrevious.getMetersY() + interpolation *
+						 (projectilePath[i].getMetersY() - posPrevious.getMetersY()));
+	  }
+	  gout.drawProjectile(pos, 0.5 * (double)i);
    }
 }
 
@@ -0,0 +1,47 @@
+/***********************************************************************
+ * Source File:
+ *    Ammunition Pool : every round in the air
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    Flying the rounds. The rest of the pool is in ammunitionPool.h,
+ *    which needs no drag tables.
+ ************************************************************************/
+
+#include "ammunitionPool.h"
+#include "drag.h"
+#include "ground.h"
+
+using namespace std;
+
+/************************************************************************
+ * AMMUNITION POOL : ADVANCE
+ * The step the game takes for one round (drag, then advance), for all
+ * of them. One Drag goes from round to round so nothing is made per
+ * round. A round is down when it is below the ground under it.
+ *************************************************************************/
+int AmmunitionPool::advance(const Ground & ground)
+{
+   if (rounds.empty())
+      return 0;
+
+   int landed = 0;
+   Drag drag(&rounds[0]);
+   for (Ammunition & ammo : rounds)
+   {
+      if (!ammo.isAlive())
+         continue;
+
+      drag.setAmmunition(&ammo);
+      ammo.applyDrag(drag.getAcceleration());
+      ammo.advance();
+
+      Position pos = ammo.getPosition();
+      if (pos.getMetersY() < ground.getElevationMeters(pos))
+      {
+         ammo.setIsAlive(false);
+         landed++;
+      }
+   }
+   return landed;
+}
@@ -0,0 +1,159 @@
+/***********************************************************************
+ * Header File:
+ *    Ammunition Pool : every round in the air
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    Sustained fire and MRSI put many rounds in the air at once. They
+ *    all live in one block, sized when the pool is made, so firing and
+ *    landing never go to the heap in the frame loop. The live rounds
+ *    are kept packed at the front: one that lands trades places with
+ *    the last, so taking it out is O(1) and advancing them all is one
+ *    pass over memory that is next to each other.
+ ************************************************************************/
+
+#ifndef ammunitionPool_h
+#define ammunitionPool_h
+
+#include "ammunition.h"
+#include "angle.h"
+#include "constants.h"    // for TRIPLE7_AREA
+#include <cassert>
+#include <vector>
+
+class Ground;
+
+/*********************************************
+ * AMMUNITION POOL
+ *********************************************/
+class AmmunitionPool
+{
+public:
+   typedef std::vector <Ammunition> ::iterator       iterator;
+   typedef std::vector <Ammunition> ::const_iterator const_iterator;
+
+   AmmunitionPool(size_t capacity = DEFAULT_CAPACITY) : capacity(capacity), trailStride(1)
+   {
+      assert(capacity > 0);
+      rounds.reserve(capacity);
+   }
+
+   // fire a round without a word. NULL if there is no room for it
+   Ammunition * fire(const Position & posHowitzer, double velocity, const Angle & angle,
+                     double mass = TRIPLE7_MASS)
+   {
+      if (isFull())
+         return NULL;
+      rounds.push_back(Ammunition(TRIPLE7_AREA, mass, posHowitzer));   // never reallocates
+      Ammunition & ammo = rounds.back();
+      ammo.setTrailStride(trailStride);
+      ammo.launch(velocity, angle);
+      return &ammo;
+   }
+
+   // one step for every round: drag, advance, and any that went into
+   // the ground are no longer alive. They stay until compact() so the
+   // caller may see where they landed. Returns how many landed
+   int advance(const Ground & ground);
+
+   // take out every round that is no longer alive. The last live round
+   // takes the place of each, so the order of the rest is not kept
+   void compact()
+   {
+      size_t i = 0;
+      while (i < rounds.size())
+      {
+         if (rounds[i].isAlive())
+            i++;
+         else
+            remove(i);
+      }
+   }
+
+   // take out this one round in O(1)
+   void remove(size_t i)
+   {
+      assert(i < rounds.size());
+      if (i != rounds.size() - 1)
+         rounds[i] = rounds.back();
+      rounds.pop_back();
+   }
+
+   // draw them all
+   void draw(ogstream & gout, double interpolation = 1.0) const
+   {
+      for (const Ammunition & ammo : rounds)
+         ammo.draw(gout, interpolation);
+   }
+
+   // the trail of every round, now and from now on (see TimeWarp)
+   void setTrailStride(int steps)
+   {
+      trailStride = steps;
+      for (Ammunition & ammo : rounds)
+         ammo.setTrailStride(steps);
+   }
+
+   void clear() { rounds.clear(); }
+
+   size_t size()        const { return rounds.size();             }
+   size_t getCapacity() const { return capacity;                  }
+   bool   empty()       const { return rounds.empty();            }
+   bool   isFull()      const { return rounds.size() >= capacity; }
+
+   Ammunition &       operator [] (size_t i)       { return rounds[i]; }
+   const Ammunition & operator [] (size_t i) const { return rounds[i]; }
+   iterator       begin()       { return rounds.begin(); }
+   iterator       end()         { return rounds.end();   }
+   const_iterator begin() const { return rounds.begin(); }
+   const_iterator end()   const { return rounds.end();   }
+
+   static const size_t DEFAULT_CAPACITY = 4096;
+
+private:
+   std::vector <Ammunition> rounds;   // the live ones first
+   size_t capacity;
+   int trailStride;
+};
+
+/*********************************************
+ * SUSTAINED FIRE
+ * While it is on, a round every so many steps
+ *********************************************/
+class SustainedFire
+{
+public:
+   SustainedFire(int stepsBetween = 3) : stepsBetween(stepsBetween), stepsWaiting(0), on(false)
+   {
+      assert(stepsBetween >= 1);
+   }
+
+   // the first round goes on the next step
+   void toggle()
+   {
+      on = !on;
+      stepsWaiting = 0;
+   }
+   bool isOn() const { return on; }
+
+   // a step has come: fire a round on it?
+   bool update()
+   {
+      if (!on)
+         return false;
+      if (stepsWaiting > 0)
+      {
+         stepsWaiting--;
+         return false;
+      }
+      stepsWaiting = stepsBetween - 1;
+      return true;
+   }
+
+private:
+   int stepsBetween;
+   int stepsWaiting;   // before the next round
+   bool on;
+};
+
+#endif /* ammunitionPool_h */
@@ -11,80 +11,107 @@
 #define angle_h
 
 #include "constants.h"
+#include "dual.h"       // for getValue() and setValue()
 #include <cmath>
 #include <iostream>
 
-class Angle
+/**********************************************
+ * ANGLE T
+ * An angle in whatever scalar the physics is
+ * using. Angle is the one for doubles.
+ **********************************************/
+template <class T = double>
+class AngleT
 {
 public:
 	// default constructor
-	Angle() { setRadians(0); }
+	AngleT() { setRadians(0.0); }
 
 	// non-default constructor
-	Angle(const double radians) { setRadians(radians); }
+	AngleT(const T & radians) { setRadians(radians); }
 
 	// copy constructor
-	Angle(const Angle &angle) { setRadians(angle.getRadians()); }
+	AngleT(const AngleT &angle) { setRadians(angle.getRadians()); }
 
 	// getters
-	double getDegrees() const { return radians * 180 / PI; }
-	double getRadians() const { return radians; }
+	T getDegrees() const { return radians * 180 / PI; }
+	T getRadians() const { return radians; }
 
 	// setters
-	void setDegrees(const double degrees) { setRadians(degrees * PI / 180); }
-	void setRadians(const double radians)
+	void setDegrees(const T & degrees) { setRadians(degrees * PI / 180); }
+	void setRadians(const T & radians)
 	{
 		if (compare(radians, 0))
-			this->radians = 0;
+			this->radians = snap(radians, 0);
 		else if (compare(radians, PI / 6))
-			this->radians = (PI / 6);
+			this->radians = snap(radians, PI / 6);
 		else if (compare(radians, PI / 4))
-			this->radians = (PI / 4);
+			this->radians = snap(radians, PI / 4);
 		else if (compare(radians, PI / 3))
-			this->radians = (PI / 3);
+			this->radians = snap(radians, PI / 3);
 		else if (compare(radians, PI / 2))
-			this->radians = (PI / 2);
+			this->radians = snap(radians, PI / 2);
 		else
 			this->radians = radians;
 	}
 
-	void addRadians(const double radians) { setRadians(getRadians() + radians); }
+	void addRadians(const T & radians) { setRadians(getRadians() + radians); }
 	void display() const;
 	
 private:
-	bool compare(const double firstRad, const double secondRad) const;
+	bool compare(const T & firstRad, const double secondRad) const;
+	static T snap(const T & radians, const double snapped);
  
 protected:
-	double radians;
+	T radians;
 	
 };
 
+typedef AngleT <double> Angle;
+
 /**********************************************
  * ANGLE :: COMPARE
  * Compares two radian values to
  * see if they are the same
   **********************************************/
-bool Angle::compare(const double firstRad, const double secondRad) const
+template <class T>
+inline bool AngleT <T> ::compare(const T & firstRad, const double secondRad) const
 {
 	const double PRECISION = 0.001;
 	
-	if (fabs(firstRad - secondRad) < PRECISION)
+	if (fabs(getValue(firstRad) - secondRad) < PRECISION)
 		return true; // they are the same
 	
 	return false;  // they are not same
 }
 
+/**********************************************
+ * ANGLE :: SNAP
+ * Round an angle that is very nearly a nice
+ * one onto it. The rounding is for the eye,
+ * not the physics, so a Dual keeps the
+ * derivatives it came with.
+  **********************************************/
+template <class T>
+inline T AngleT <T> ::snap(const T & radians, const double snapped)
+{
+	T result(radians);
+	setValue(result, snapped);
+	return result;
+}
+
 /**********************************************
  * ANGLE :: DISPLAY
  * Displays Angle object in degrees
  * and radians.
   **********************************************/
-void Angle::display() const
+template <class T>
+inline void AngleT <T> ::display() const
 {
   std::cout.precision(2);
   std::cout << std::fixed;
-  std::cout << "Degrees: " << getDegrees() << "deg, Radians: " << getRadians()
-			<< "rad\n";
+  std::cout << "Degrees: " << getValue(getDegrees()) << "deg, Radians: "
+			<< getValue(getRadians()) << "rad\n";
   std::cout.clear();
 }
 
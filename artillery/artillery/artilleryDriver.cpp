@@ -8,9 +8,34 @@
  *****************************************************************/
 #include "game.h"
 #include "uiInteract.h"
+#include "profiler.h"
 
 /*************************************
- * All the interesting work happens here, when
+ * The simulation happens here, one fixed
+ * step at a time. The interface calls this
+ * as many times as the wall clock calls for,
+ * which may be several times in one frame or
+ * not at all, so the physics never depends
+ * on how quickly the frames are drawn.
+ **************************************/
+void stepCallBack(const Interface* pUI, void* p)
+{
+   // the first step is to cast the void pointer into a game object. This
+   // is the first step of every single callback function in OpenGL.
+   Game* pGame = (Game*)p;
+   
+   {
+      ProfileScope scope(Profiler::INPUT);
+      pGame->input(pUI);
+   }
+   {
+      ProfileScope scope(Profiler::ADVANCE);
+      pGame->advance();
+   }
+}
+
+/*************************************
+ * All the drawing happens here, when
  * I get called back from OpenGL to draw a frame.
  * When I am finished drawing, then the graphics
  * engine will wait until the proper amount of
@@ -18,12 +43,9 @@
  **************************************/
 void callBack(const Interface* pUI, void* p)
 {
-   // the first step is to cast the void pointer into a game object. This
-   // is the first step of every single callback function in OpenGL.
    Game* pGame = (Game*)p;
    
-   pGame->input(pUI);
-   pGame->advance();
+   ProfileScope scope(Profiler::DRAW);
    pGame->draw(pUI);
 }
 
@@ -42,19 +64,18 @@ int main(int argc, char** argv)
 #endif // !_WIN32
 {
    // Initialize OpenGL
-   Position ptUpperRight;
-   ptUpperRight.setPixelsX(700.0);
-   ptUpperRight.setPixelsY(500.0);
-   Position().setZoom(40.0 /* 42 meters equals 1 pixel */);
+   Viewport viewport(700.0, 500.0, 40.0 /* 40 meters equals 1 pixel */);
+   Position().setZoom(viewport.getMetersFromPixels());   // for the pixels in Position
+   Position ptUpperRight = viewport.getUpperRight();
    Interface ui(0, NULL,
 	  "Game",   /* name on the window */
-	   ptUpperRight);
+	   viewport);
 	
    // Initialize the game
    Game game(ptUpperRight);
 
    // set everything into action
-   ui.run(callBack, &game);
+   ui.run(stepCallBack, callBack, &game);
 
 	return 0;
 	
@@ -0,0 +1,358 @@
+/***********************************************************************
+ * Source File:
+ *    Bench : time the hot paths of the simulation
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    The benchmarks themselves, and a main() to run them. With no
+ *    arguments we print a table; "--json file" also writes the results
+ *    as JSON ("--json -" writes them to the screen instead of the table).
+ *    Built by the "bench" target in CMakeLists.txt.
+ ************************************************************************/
+
+#include "bench.h"
+#include "ammunition.h"
+#include "ammunitionPool.h"
+#include "counterBattery.h"
+#include "drag.h"
+#include "firingBatch.h"
+#include "firingSolution.h"
+#include "ground.h"
+#include "heatmap.h"
+#include "intercept.h"
+#include "mrsi.h"
+#include "position.h"
+#include "preview.h"
+#include "targetTrack.h"
+#include "uiRecord.h"
+#include <cstring>    // for strcmp()
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+using namespace std;
+
+// the game defines this; we are not the game
+double Position::metersFromPixels = 40.0;
+
+/*************************************************************************
+ * BENCH : WRITE JSON
+ * {"benchmarks":[{"name":..., "ns_per_op":..., ...}, ...]}
+ *************************************************************************/
+void Bench::writeJSON(ostream & out) const
+{
+   out << "{\"benchmarks\":[";
+   for (size_t i = 0; i < results.size(); i++)
+   {
+      const BenchResult & result = results[i];
+      out << (i == 0 ? "\n" : ",\n")
+          << setprecision(6)
+          << "{\"name\":\"" << result.name << "\""
+          << ",\"ns_per_op\":" << result.median
+          << ",\"mean\":" << result.mean
+          << ",\"stddev\":" << result.deviation
+          << ",\"min\":" << result.minimum
+          << ",\"max\":" << result.maximum
+          << ",\"iterations\":" << result.iterations
+          << ",\"samples\":" << result.samples << "}";
+   }
+   out << "\n]}\n";
+}
+
+/*************************************************************************
+ * BENCH : WRITE TABLE
+ * The same thing for people
+ *************************************************************************/
+void Bench::writeTable(ostream & out) const
+{
+   out << left << setw(32) << "benchmark" << right
+       << setw(14) << "ns/op" << setw(12) << "stddev" << setw(10) << "cv%" << "\n";
+   for (const BenchResult & result : results)
+      out << left << setw(32) << result.name << right << fixed << setprecision(1)
+          << setw(14) << result.median
+          << setw(12) << result.deviation
+          << setw(10) << (result.mean > 0.0 ? 100.0 * result.deviation / result.mean : 0.0)
+          << "\n";
+}
+
+/*************************************************************************
+ * BENCH PHYSICS
+ * Every benchmark of the simulation. A friend of Drag so we can time
+ * its table lookups one at a time.
+ *************************************************************************/
+class BenchPhysics
+{
+public:
+   BenchPhysics() : ground(screen()), posHowitzer(screen().getUpperRight().getMetersX() / 2.0, 0.0)
+   {
+      ground.reset(posHowitzer);
+
+      // inputs spread across the tables so every branch gets its turn,
+      // but off the table's own rows
+      for (int i = 0; i < NUM_INPUTS; i++)
+      {
+         altitudes[i] = 20000.0 * (i + 0.5) / NUM_INPUTS;
+         speeds[i] = 100.0 + 1000.0 * ((i * 37) % NUM_INPUTS + 0.5) / NUM_INPUTS;
+      }
+   }
+
+   void run(Bench & bench)
+   {
+      Ammunition ammo(TRIPLE7_AREA, TRIPLE7_MASS, posHowitzer);
+      ammo.launch(TRIPLE7_VELOCITY, Angle(PI / 4.0));
+      Drag drag(&ammo);
+      int i = 0;
+
+      bench.run("Drag::computeDensity", [&]()
+      {
+         keep(drag.computeDensity(altitudes[i++ & (NUM_INPUTS - 1)]));
+      });
+      bench.run("Drag::computeSpeedOfSound", [&]()
+      {
+         keep(drag.computeSpeedOfSound(altitudes[i++ & (NUM_INPUTS - 1)]));
+      });
+      bench.run("Drag::computeCoefficient", [&]()
+      {
+         keep(drag.computeCoefficient(speeds[i++ & (NUM_INPUTS - 1)], 340.0));
+      });
+      bench.run("Drag::getAcceleration", [&]()
+      {
+         keep(drag.getAcceleration());
+      });
+      bench.run("Ammunition::advance", [&]()
+      {
+         ammo.advance();
+         keep(ammo);
+      });
+      bench.run("Ground::reset", [&]()
+      {
+         ground.reset(posHowitzer);
+         keep(ground);
+      });
+      bench.run("Ground::getElevationMeters", [&]()
+      {
+         Position pos((i++ % ground.getWidth()) * ground.getMetersPerColumn(), 0.0);
+         keep(ground.getElevationMeters(pos));
+      });
+      // through a camera that moves every frame, so nothing is reused
+      DrawBuffer buffer;
+      bench.run("Ground::draw (moving camera)", [&]()
+      {
+         buffer.clear();
+         ogstreamRecord gout(buffer, Viewport(700.0, 500.0, 160.0, (double)(i++ & 31), 0.0));
+         ground.draw(gout);
+         keep(buffer);
+      });
+      bench.run("shot", [&]()
+      {
+         keep(shot(Angle(PI / 4.0 + 0.01 * (i++ & 31))));
+      });
+
+      // one step of sustained fire with the pool kept full: every round
+      // advanced, the ones that landed taken out, and as many fired.
+      // Has to fit in a frame with room to draw them
+      AmmunitionPool pool;
+      bench.run("AmmunitionPool::advance (4096)", [&]()
+      {
+         keep(pool.advance(ground));
+         pool.compact();
+         while (!pool.isFull())
+            pool.fire(posHowitzer, TRIPLE7_VELOCITY, Angle(PI / 4.0 + 0.01 * (i++ & 31)));
+      });
+
+      // a round on Duals costs more than one on doubles, but less than
+      // the two more rounds finite differences would need
+      bench.run("Trajectory::fly", [&]()
+      {
+         Trajectory trajectory(false /*isRecording*/);
+         trajectory.fly({ 45.0 + 0.01 * (i++ & 31), TRIPLE7_VELOCITY, 0.0 });
+         keep(trajectory);
+      });
+      bench.run("Trajectory::flySensitivity", [&]()
+      {
+         keep(Trajectory::flySensitivity({ 45.0 + 0.01 * (i++ & 31), TRIPLE7_VELOCITY, 0.0 }));
+      });
+      bench.run("FiringSolution::solveAngle", [&]()
+      {
+         FiringSolution solution;
+         Shot shot = { 30.0, TRIPLE7_VELOCITY, 0.0 };
+         keep(solution.solveAngle(shot, 15000.0 + (i++ & 31)));
+      });
+
+      // a target on every column of the ground, all in one go: each
+      // from its neighbour in range, and then every one from nothing.
+      // The high branch reaches them all. On the low, those above and
+      // behind a hill take most of the time failing
+      vector <Position> targets;
+      for (int column = 0; column < ground.getWidth(); column++)
+      {
+         Position posTarget(column * ground.getMetersPerColumn(), 0.0);
+         if (fabs(posTarget.getMetersX() - posHowitzer.getMetersX()) > 1000.0)
+         {
+            posTarget.setMetersY(ground.getElevationMeters(posTarget));
+            targets.push_back(posTarget);
+         }
+      }
+      for (bool isHigh : { false, true })
+      {
+         FiringBatchConfig configBatch;
+         configBatch.isHigh = isHigh;
+         FiringBatch batch(configBatch);
+         bench.run(isHigh ? "FiringBatch::solve (high)" : "FiringBatch::solve (low)", [&]()
+         {
+            keep(batch.solve(posHowitzer, targets));
+         });
+         configBatch.chunk = 1;
+         FiringBatch batchCold(configBatch);
+         bench.run(isHigh ? "FiringBatch::solve (high, cold)" : "FiringBatch::solve (low, cold)", [&]()
+         {
+            keep(batchCold.solve(posHowitzer, targets));
+         });
+      }
+
+      // a six round plan from nothing, and then for a target that has
+      // moved a little, which starts from the angles of the last
+      MrsiPlanner planner;
+      bench.run("MrsiPlanner::plan (cold)", [&]()
+      {
+         planner.reset();
+         keep(planner.plan(12000.0 + 10.0 * (i++ & 31), 0.0, 0.0));
+      });
+
+      // a truck driving at us, from nothing, and then again every frame
+      // as it drives, which starts from the solution of the frame before
+      TargetTrack track(Position(12000.0, 0.0), -15.0, 0.0);
+      InterceptSolver solver;
+      bench.run("InterceptSolver::solve (cold)", [&]()
+      {
+         solver.reset();
+         keep(solver.solve(track, Position(), (i++ & 31) / 30.0));
+      });
+      bench.run("InterceptSolver::solve (warm)", [&]()
+      {
+         keep(solver.solve(track, Position(), (i++ & 1023) / 30.0));
+      });
+
+      // where a shell the radar saw eight times on its way up was fired
+      // from, and then a sky full of them on every core. Dozens of these
+      // have to come back in a frame or two
+      vector <TrackSample> samples;
+      Ammunition shell(TRIPLE7_AREA, TRIPLE7_MASS, posHowitzer);
+      shell.launch(TRIPLE7_VELOCITY, Angle(PI / 4.0));
+      Drag dragShell(&shell);
+      for (int second = 1; second <= 12; second++)
+      {
+         shell.applyDrag(dragShell.getAcceleration());
+         shell.advance();
+         if (second > 4)
+            samples.push_back({ (double)second, shell.getPosition() });
+      }
+      CounterBattery counterBattery(ground);
+      bench.run("CounterBattery::estimate", [&]()
+      {
+         keep(counterBattery.estimate(samples));
+      });
+      vector <vector <TrackSample>> tracks(32, samples);
+      bench.run("CounterBattery::estimate (x32)", [&]()
+      {
+         keep(counterBattery.estimate(tracks));
+      });
+      bench.run("MrsiPlanner::plan (warm)", [&]()
+      {
+         keep(planner.plan(12000.0 + 10.0 * (i++ & 31), 0.0, 0.0));
+      });
+
+      // a new coarse arc, as when the gunner swings the gun. This has to
+      // fit in the preview's budget of 500us with room to spare
+      PreviewConfig configPreview;
+      configPreview.budget = chrono::microseconds(0);
+      configPreview.neighbors = 0;
+      TrajectoryPreview preview(configPreview);
+      preview.setGround(ground, posHowitzer);
+      bench.run("TrajectoryPreview::update", [&]()
+      {
+         preview.clear();
+         preview.aim((i++ & 63) * 0.02 - 0.6);
+         keep(preview.update());
+      });
+
+      // the whole ground: should be interactive, well under 200ms
+      HitHeatmap heatmap;
+      bench.run("HitHeatmap::compute", [&]()
+      {
+         heatmap.compute(ground, posHowitzer);
+         keep(heatmap);
+      });
+   }
+
+private:
+   static const int NUM_INPUTS = 1024;    // a power of two
+
+   // the same size of screen as the game
+   static Viewport screen()
+   {
+      return Viewport(700.0, 500.0, 40.0);
+   }
+
+   // fire one round and follow it the way the game does until it lands.
+   // Returns how many steps it flew
+   int shot(const Angle & angle)
+   {
+      Ammunition ammo(TRIPLE7_AREA, TRIPLE7_MASS, posHowitzer);
+      ammo.launch(TRIPLE7_VELOCITY, angle);
+      Drag drag(&ammo);
+
+      int steps = 0;
+      while (steps < 10000 &&
+             ammo.getPosition().getMetersY() >= ground.getElevationMeters(ammo.getPosition()))
+      {
+         ammo.applyDrag(drag.getAcceleration());
+         ammo.advance();
+         steps++;
+      }
+      return steps;
+   }
+
+   Ground ground;
+   Position posHowitzer;
+   double altitudes[NUM_INPUTS];
+   double speeds[NUM_INPUTS];
+};
+
+/*********************************
+ * Run the benchmarks
+ *    bench [--json <file or ->]
+ *********************************/
+int main(int argc, char ** argv)
+{
+   const char * fileJSON = nullptr;
+   for (int i = 1; i < argc; i++)
+      if (strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+         fileJSON = argv[++i];
+      else
+      {
+         cerr << "Usage: " << argv[0] << " [--json <file or ->]\n";
+         return 1;
+      }
+
+   Bench bench;
+   BenchPhysics().run(bench);
+
+   if (fileJSON != nullptr && strcmp(fileJSON, "-") == 0)
+      bench.writeJSON(cout);
+   else
+   {
+      bench.writeTable(cout);
+      if (fileJSON != nullptr)
+      {
+         ofstream fout(fileJSON);
+         if (fout.fail())
+         {
+            cerr << "Unable to write " << fileJSON << "\n";
+            return 1;
+         }
+         bench.writeJSON(fout);
+      }
+   }
+   return 0;
+}
@@ -0,0 +1,138 @@
+/***********************************************************************
+ * Header File:
+ *    Bench : time the hot paths of the simulation
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    A tiny microbenchmark harness. Each benchmark is run enough times
+ *    that one sample takes a few milliseconds, then sampled repeatedly.
+ *    We report the median nanoseconds per operation (stable from run to
+ *    run) along with the spread, and write everything out as JSON so a
+ *    script can compare one change against the last.
+ ************************************************************************/
+
+#ifndef bench_h
+#define bench_h
+
+#include <algorithm>  // for sort()
+#include <chrono>
+#include <cmath>      // for sqrt()
+#include <ostream>
+#include <string>
+#include <vector>
+
+/*************************************************************************
+ * KEEP
+ * Make the compiler believe a value is used so it cannot optimize
+ * away the work that produced it
+ *************************************************************************/
+template <class T>
+inline void keep(const T & value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+   asm volatile("" : : "g"(&value) : "memory");
+#else // _WIN32
+   static const void * volatile sink;
+   sink = &value;
+#endif // _WIN32
+}
+
+/*************************************************************************
+ * BENCH RESULT
+ * What we learned about one benchmark, in nanoseconds per operation
+ *************************************************************************/
+struct BenchResult
+{
+   std::string name;
+   long long iterations;    // operations in each sample
+   int samples;
+   double median;
+   double mean;
+   double deviation;
+   double minimum;
+   double maximum;
+};
+
+/*************************************************************************
+ * BENCH
+ * Runs benchmarks and remembers the results
+ *************************************************************************/
+class Bench
+{
+public:
+   Bench(int samples = 21, double secondsPerSample = 0.005) :
+      samples(samples), secondsPerSample(secondsPerSample) {}
+
+   // time op(), which performs one operation, and remember the result
+   template <class Op>
+   const BenchResult & run(const std::string & name, Op op);
+
+   const std::vector <BenchResult> & getResults() const { return results; }
+
+   // the results as JSON, and as a table people can read
+   void writeJSON(std::ostream & out) const;
+   void writeTable(std::ostream & out) const;
+
+private:
+   template <class Op>
+   static double time(Op & op, long long iterations);
+
+   int samples;
+   double secondsPerSample;
+   std::vector <BenchResult> results;
+};
+
+/*************************************************************************
+ * BENCH : TIME
+ * Seconds to run op() the given number of times
+ *************************************************************************/
+template <class Op>
+double Bench::time(Op & op, long long iterations)
+{
+   std::chrono::steady_clock::time_point timeBegin = std::chrono::steady_clock::now();
+   for (long long i = 0; i < iterations; i++)
+      op();
+   return std::chrono::duration<double>(std::chrono::steady_clock::now() - timeBegin).count();
+}
+
+/*************************************************************************
+ * BENCH : RUN
+ * Warm up while finding how many iterations fill a sample, then take
+ * the samples. The median is what we compare: it ignores the odd sample
+ * where the OS took the CPU away.
+ *************************************************************************/
+template <class Op>
+const BenchResult & Bench::run(const std::string & name, Op op)
+{
+   // calibrate: double until one sample takes long enough
+   long long iterations = 1;
+   while (time(op, iterations) < secondsPerSample && iterations < (1LL << 40))
+      iterations *= 2;
+
+   // sample
+   std::vector <double> times;
+   for (int i = 0; i < samples; i++)
+      times.push_back(time(op, iterations) * 1000000000.0 / iterations);
+   std::sort(times.begin(), times.end());
+
+   BenchResult result;
+   result.name = name;
+   result.iterations = iterations;
+   result.samples = samples;
+   result.median = times[times.size() / 2];
+   result.minimum = times.front();
+   result.maximum = times.back();
+   result.mean = 0.0;
+   for (double t : times)
+      result.mean += t;
+   result.mean /= times.size();
+   result.deviation = 0.0;
+   for (double t : times)
+      result.deviation += (t - result.mean) * (t - result.mean);
+   result.deviation = times.size() > 1 ? sqrt(result.deviation / (times.size() - 1)) : 0.0;
+
+   results.push_back(result);
+   return results.back();
+}
+
+#endif /* bench_h */
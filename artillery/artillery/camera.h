@@ -0,0 +1,76 @@
+/***********************************************************************
+ * Header File:
+ *    Camera : look around the field
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    Pan and zoom. The camera starts on a home viewport (normally the
+ *    whole window showing the whole ground) and moves a copy of it
+ *    around. It only changes what is drawn, never the simulation.
+ ************************************************************************/
+
+#ifndef camera_h
+#define camera_h
+
+#include "viewport.h"
+
+/*********************************************
+ * CAMERA
+ *********************************************/
+class Camera
+{
+public:
+   Camera() {}
+   Camera(const Viewport & home) : home(home), viewport(home) {}
+
+   // what to draw through
+   const Viewport & getViewport() const { return viewport; }
+   const Viewport & getHome()     const { return home;     }
+
+   // slide the view so many pixels. Positive x shows more to the right
+   void pan(double dxPixels, double dyPixels)
+   {
+      viewport.setOrigin(viewport.toMeters(dxPixels, dyPixels));
+   }
+
+   // magnify by factor (less than 1 to zoom out) keeping whatever is
+   // under the given pixel where it is
+   void zoom(double factor, double xPixels, double yPixels)
+   {
+      double metersFromPixels = viewport.getMetersFromPixels() / factor;
+      double metersMin = home.getMetersFromPixels() / MAX_ZOOM;
+      double metersMax = home.getMetersFromPixels() * MAX_ZOOM;
+      metersFromPixels = metersFromPixels < metersMin ? metersMin :
+                         metersFromPixels > metersMax ? metersMax : metersFromPixels;
+
+      Position posFixed = viewport.toMeters(xPixels, yPixels);
+      viewport.setZoom(metersFromPixels);
+      viewport.setOrigin(Position(posFixed.getMetersX() - xPixels * metersFromPixels,
+                                  posFixed.getMetersY() - yPixels * metersFromPixels));
+   }
+
+   // the same about the middle of the screen
+   void zoom(double factor)
+   {
+      zoom(factor, viewport.getWidth() / 2.0, viewport.getHeight() / 2.0);
+   }
+
+   // a drawing made through the home viewport looks as if it were drawn
+   // through this one when its pixels are scaled by this much, then moved
+   // by the offset
+   double getScale()   const { return home.getMetersFromPixels() / viewport.getMetersFromPixels(); }
+   double getOffsetX() const { return viewport.toPixelsX(home.toMetersX(0.0)); }
+   double getOffsetY() const { return viewport.toPixelsY(home.toMetersY(0.0)); }
+
+   // back where we started
+   void reset() { viewport = home; }
+
+   // how far in or out of the home zoom we may go
+   static constexpr double MAX_ZOOM = 64.0;
+
+private:
+   Viewport home;
+   Viewport viewport;
+};
+
+#endif /* camera_h */
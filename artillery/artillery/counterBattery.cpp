@@ -0,0 +1,564 @@
+/***********************************************************************
+ * Source File:
+ *    Counter Battery : where an incoming shell was fired from
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    Levenberg-Marquardt over flights on Dual numbers
+ ************************************************************************/
+
+#include "counterBattery.h"
+#include "ammunition.h"
+#include "drag.h"
+#include "dual.h"
+#include "ground.h"
+#include "parallel.h"
+#include "trajectory.h"   // for Trajectory::MAX_STEPS
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+using namespace std;
+
+const double LAMBDA_FIRST = 0.001;     // how far to trust the first step
+const double LAMBDA_MIN = 1e-12;
+const double LAMBDA_MAX = 1e10;        // past this the step is nothing: we are there
+const double COST_DECREASE = 0.001;    // a step that gains less than this much is the last
+const double VELOCITY_MIN = 10.0;      // meters/second. A step below this is too long
+const double MISS_EARLIER = 0.9;       // an earlier launch must miss by this much less to win
+const int STEPS_BACK = 300;            // seconds before the first sample to look for the ground
+const int TURNS_BACK = 3;              // of undoing a step
+
+/************************************************************************
+ * SOLVE LINEAR
+ * a x = b by Gaussian elimination, choosing the largest pivot. False if
+ * a is singular. a and b are used up
+ *************************************************************************/
+template <int N>
+static bool solveLinear(double a[N][N], double b[N], double x[N])
+{
+   for (int column = 0; column < N; column++)
+   {
+      int pivot = column;
+      for (int row = column + 1; row < N; row++)
+         if (fabs(a[row][column]) > fabs(a[pivot][column]))
+            pivot = row;
+      if (a[pivot][column] == 0.0)
+         return false;
+      if (pivot != column)
+      {
+         for (int k = 0; k < N; k++)
+            swap(a[pivot][k], a[column][k]);
+         swap(b[pivot], b[column]);
+      }
+
+      for (int row = column + 1; row < N; row++)
+      {
+         double factor = a[row][column] / a[column][column];
+         for (int k = column; k < N; k++)
+            a[row][k] -= factor * a[column][k];
+         b[row] -= factor * b[column];
+      }
+   }
+
+   for (int row = N - 1; row >= 0; row--)
+   {
+      double sum = b[row];
+      for (int k = row + 1; k < N; k++)
+         sum -= a[row][k] * x[k];
+      x[row] = sum / a[row][row];
+   }
+   return true;
+}
+
+/************************************************************************
+ * COUNTER BATTERY : CONSTRUCTOR
+ *************************************************************************/
+CounterBattery::CounterBattery(const Ground & ground) :
+   elevations(ground.getElevations()), metersPerColumn(ground.getMetersPerColumn()),
+   elevationMin(0.0)
+{
+   for (double elevation : elevations)
+      elevationMin = fmin(elevationMin, elevation);
+}
+
+/************************************************************************
+ * COUNTER BATTERY : GET ELEVATION
+ *************************************************************************/
+double CounterBattery::getElevation(double x) const
+{
+   return Ground::getElevationAt(elevations, metersPerColumn, x);
+}
+
+/************************************************************************
+ * COUNTER BATTERY : EVALUATE
+ * Put the shell where the parameters say, launched at exactly their
+ * angle, and step the way the game does. Where it is at a sample's time is a straight line between the
+ * steps either side, the way the impact is found in Trajectory, so it
+ * moves smoothly with the time it started too.
+ *    INPUT  parameters  X, Y or TIME, ANGLE and VELOCITY
+ *           isLaunch    from the ground at TIME, or from Y when the
+ *                       radar first saw it
+ *           altitude    of the ground it was launched from
+ *           samples     in order of time
+ *************************************************************************/
+CounterBattery::Evaluation CounterBattery::evaluate(const double parameters[], bool isLaunch,
+                                                    double altitude,
+                                                    const vector <TrackSample> & samples) const
+{
+   typedef Dual <NUM_PARAMETERS> Scalar;
+
+   Scalar x         = Scalar::variable(parameters[X],        X);
+   Scalar angle     = Scalar::variable(parameters[ANGLE],    ANGLE);
+   Scalar velocity  = Scalar::variable(parameters[VELOCITY], VELOCITY);
+   Scalar y         = isLaunch ? Scalar(altitude) : Scalar::variable(parameters[Y], Y);
+   Scalar timeStart = isLaunch ? Scalar::variable(parameters[TIME], TIME) :
+                                 Scalar(samples.front().time);
+
+   AmmunitionT <Scalar> ammo(TRIPLE7_AREA, TRIPLE7_MASS, PositionT <Scalar> (x, y));
+   ammo.launchRadians(velocity, angle * PI / 180.0);
+   DragT <Scalar> drag(&ammo);
+
+   Evaluation evaluation = {};
+   PositionT <Scalar> before = ammo.getPosition();
+   ammo.applyDrag(drag.getAcceleration());
+   ammo.advance();
+   PositionT <Scalar> after = ammo.getPosition();
+   int step = 0;                  // before is this many steps after the start
+
+   for (const TrackSample & sample : samples)
+   {
+      // up to the steps either side of the sample. One before the start
+      // is on the line through the first step
+      Scalar time = sample.time - timeStart;
+      while (time > step + 1 && step < Trajectory::MAX_STEPS)
+      {
+         ammo.applyDrag(drag.getAcceleration());
+         ammo.advance();
+         before = after;
+         after = ammo.getPosition();
+         step++;
+      }
+
+      Scalar fraction = time - (double)step;
+      Scalar misses[2] =
+      {
+         before.getMetersX() + fraction * (after.getMetersX() - before.getMetersX()) - sample.pos.getMetersX(),
+         before.getMetersY() + fraction * (after.getMetersY() - before.getMetersY()) - sample.pos.getMetersY()
+      };
+
+      // the normal equations for the misses
+      for (const Scalar & miss : misses)
+      {
+         evaluation.cost += miss.getValue() * miss.getValue();
+         for (int i = 0; i < NUM_PARAMETERS; i++)
+         {
+            evaluation.jtr[i] += miss.getDerivative(i) * miss.getValue();
+            for (int j = 0; j < NUM_PARAMETERS; j++)
+               evaluation.jtj[i][j] += miss.getDerivative(i) * miss.getDerivative(j);
+         }
+      }
+   }
+   return evaluation;
+}
+
+/************************************************************************
+ * COUNTER BATTERY : GUESS
+ * In a vacuum x goes as a + bt and y + gt^2/2 as c + dt: two straight
+ * lines through the samples by least squares, where t is the time since
+ * the first
+ *************************************************************************/
+bool CounterBattery::guess(double parameters[], const vector <TrackSample> & samples) const
+{
+   double n = (double)samples.size();
+   double sumT = 0.0, sumTT = 0.0, sumX = 0.0, sumTX = 0.0, sumY = 0.0, sumTY = 0.0;
+   for (const TrackSample & sample : samples)
+   {
+      double t = sample.time - samples.front().time;
+      double y = sample.pos.getMetersY() + 0.5 * GRAVITY * t * t;
+      sumT  += t;
+      sumTT += t * t;
+      sumX  += sample.pos.getMetersX();
+      sumTX += t * sample.pos.getMetersX();
+      sumY  += y;
+      sumTY += t * y;
+   }
+   double variance = n * sumTT - sumT * sumT;
+   if (variance <= 0.0)
+      return false;
+   double b = (n * sumTX - sumT * sumX) / variance;
+   double d = (n * sumTY - sumT * sumY) / variance;
+
+   parameters[X] = (sumX - b * sumT) / n;
+   parameters[Y] = (sumY - d * sumT) / n;
+   parameters[ANGLE] = atan2(d, b) * 180.0 / PI;
+   parameters[VELOCITY] = fmax(sqrt(b * b + d * d), VELOCITY_MIN);
+   return true;
+}
+
+/************************************************************************
+ * GET ACCELERATION
+ * Of a shell here going this fast, gravity and drag, as the game finds
+ * it at the start of a step
+ *************************************************************************/
+static void getAcceleration(const Position & pos, double dx, double dy, double & ddx, double & ddy)
+{
+   Ammunition ammo(TRIPLE7_AREA, TRIPLE7_MASS, pos);
+   ammo.launchRadians(sqrt(dx * dx + dy * dy), atan2(dy, dx));
+   Drag drag(&ammo);
+   ammo.applyDrag(drag.getAcceleration());
+   ddx = ammo.getAcceleration().getMetersX();
+   ddy = ammo.getAcceleration().getMetersY();
+}
+
+/************************************************************************
+ * STEP FORWARD
+ * A step of the game: move by the velocity, then change the velocity by
+ * the acceleration there
+ *    p' = p + v       v' = v + a(p, v)
+ *************************************************************************/
+static void stepForward(double & x, double & y, double & dx, double & dy)
+{
+   double ddx = 0.0;
+   double ddy = 0.0;
+   getAcceleration(Position(x, y), dx, dy, ddx, ddy);
+   x += dx;
+   y += dy;
+   dx += ddx;
+   dy += ddy;
+}
+
+/************************************************************************
+ * STEP BACK
+ * Undo a step of the game: v = v' - a(p' - v, v). The drag changes
+ * little over a step, so starting from v = v' a few turns of that are
+ * exact
+ *************************************************************************/
+static void stepBack(double & x, double & y, double & dx, double & dy)
+{
+   double dxBefore = dx;
+   double dyBefore = dy;
+   double ddx = 0.0;
+   double ddy = 0.0;
+   for (int i = 0; i < TURNS_BACK; i++)
+   {
+      getAcceleration(Position(x - dxBefore, y - dyBefore), dxBefore, dyBefore, ddx, ddy);
+      dxBefore = dx - ddx;
+      dyBefore = dy - ddy;
+   }
+   x -= dxBefore;
+   y -= dyBefore;
+   dx = dxBefore;
+   dy = dyBefore;
+}
+
+/************************************************************************
+ * COUNTER BATTERY : FLY BACK
+ * Undo steps until the shell is under the ground, and the launch is
+ * between the last two, the way the impact is found in Trajectory.
+ *
+ * The game only looks for the ground at the end of a step, which is
+ * hundreds of meters on, so a shell can go through the top of a hill
+ * between two and would look fired from it. Behind the gun the ground
+ * may fall away faster than the shell, and it would look fired from
+ * further back. So we keep going until it is below all the ground, and
+ * every place it came out of it could be the launch.
+ *    INPUT  parameters  X, Y, ANGLE and VELOCITY at the time
+ *    OUTPUT launches    X, TIME, ANGLE and VELOCITY of each, latest first
+ *************************************************************************/
+int CounterBattery::flyBack(const double parameters[], double time,
+                            double launches[][NUM_PARAMETERS]) const
+{
+   double x = parameters[X];
+   double y = parameters[Y];
+   double dx = parameters[VELOCITY] * cos(parameters[ANGLE] * PI / 180.0);
+   double dy = parameters[VELOCITY] * sin(parameters[ANGLE] * PI / 180.0);
+   double height = y - getElevation(x);
+
+   int numLaunches = 0;
+   for (int step = 1; step <= STEPS_BACK && y >= elevationMin && numLaunches < MAX_LAUNCHES; step++)
+   {
+      double xBefore = x;
+      double yBefore = y;
+      double dxBefore = dx;
+      double dyBefore = dy;
+      stepBack(xBefore, yBefore, dxBefore, dyBefore);
+      double heightBefore = yBefore - getElevation(xBefore);
+
+      // it came out of the ground between the two
+      if (heightBefore < 0.0 && height >= 0.0)
+      {
+         double fraction = height / (height - heightBefore);   // back from the later
+         double dxLaunch = dx + fraction * (dxBefore - dx);
+         double dyLaunch = dy + fraction * (dyBefore - dy);
+         double * launch = launches[numLaunches++];
+         launch[X] = x + fraction * (xBefore - x);
+         launch[TIME] = time - (step - 1) - fraction;
+         launch[ANGLE] = atan2(dyLaunch, dxLaunch) * 180.0 / PI;
+         launch[VELOCITY] = sqrt(dxLaunch * dxLaunch + dyLaunch * dyLaunch);
+      }
+
+      x = xBefore;
+      y = yBefore;
+      dx = dxBefore;
+      dy = dyBefore;
+      height = heightBefore;
+   }
+
+   return numLaunches;
+}
+
+/************************************************************************
+ * COUNTER BATTERY : FIT
+ * Levenberg-Marquardt: step to the bottom of the quadratic the Jacobian
+ * makes, each parameter held back in proportion to its own curvature
+ * by lambda. A step that helps is taken and lambda shrinks; one that
+ * does not is thrown away and lambda grows, and the next step comes
+ * from the same flight's normal equations.
+ *    INPUT  parameters  where to start
+ *           isLaunch    as evaluate() takes them
+ *           altitude
+ *    OUTPUT parameters  the least squares
+ *           estimate    adds the iterations and flights, and the miss
+ *************************************************************************/
+bool CounterBattery::fit(double parameters[], bool isLaunch, double altitude,
+                         const vector <TrackSample> & samples, CounterBatteryEstimate & estimate) const
+{
+   Evaluation current = evaluate(parameters, isLaunch, altitude, samples);
+   estimate.simulations++;
+   double lambda = LAMBDA_FIRST;
+   bool isFitted = false;
+   for (int iteration = 0; iteration < MAX_ITERATIONS && !isFitted; iteration++)
+   {
+      estimate.iterations++;
+
+      double a[NUM_PARAMETERS][NUM_PARAMETERS];
+      double b[NUM_PARAMETERS];
+      double step[NUM_PARAMETERS];
+      for (int i = 0; i < NUM_PARAMETERS; i++)
+      {
+         for (int j = 0; j < NUM_PARAMETERS; j++)
+            a[i][j] = current.jtj[i][j];
+         a[i][i] += lambda * current.jtj[i][i];
+         b[i] = -current.jtr[i];
+      }
+
+      double trial[NUM_PARAMETERS];
+      bool isSolved = solveLinear <NUM_PARAMETERS> (a, b, step);
+      for (int i = 0; i < NUM_PARAMETERS; i++)
+         trial[i] = parameters[i] + step[i];
+
+      if (isSolved && trial[VELOCITY] >= VELOCITY_MIN)
+      {
+         Evaluation evaluation = evaluate(trial, isLaunch, altitude, samples);
+         estimate.simulations++;
+         if (evaluation.cost < current.cost)
+         {
+            isFitted = current.cost - evaluation.cost <= COST_DECREASE * current.cost;
+            copy(trial, trial + NUM_PARAMETERS, parameters);
+            current = evaluation;
+            lambda = fmax(lambda * 0.1, LAMBDA_MIN);
+            continue;
+         }
+      }
+
+      // too far: shorter, from the same flight
+      lambda *= 10.0;
+      isFitted = lambda > LAMBDA_MAX;
+   }
+
+   estimate.miss = sqrt(current.cost / (double)samples.size());
+   return isFitted;
+}
+
+/************************************************************************
+ * COUNTER BATTERY : FIND COLUMNS
+ * Where the steps either side of this launch cross the top of a column
+ * of the ground, and so could have started from it. Nearest in time
+ * first.
+ *    INPUT  parameters  X, TIME, ANGLE and VELOCITY of the launch
+ *           altitude    it was launched from
+ *    OUTPUT columns     X, TIME, ANGLE and VELOCITY from each
+ *    RETURN how many there are
+ *************************************************************************/
+int CounterBattery::findColumns(const double parameters[], double altitude,
+                                double columns[][NUM_PARAMETERS]) const
+{
+   // the step before the launch and the two after it
+   const int NUM_NODES = 4;
+   double x[NUM_NODES];
+   double y[NUM_NODES];
+   double dx[NUM_NODES];
+   double dy[NUM_NODES];
+   x[1] = parameters[X];
+   y[1] = altitude;
+   dx[1] = parameters[VELOCITY] * cos(parameters[ANGLE] * PI / 180.0);
+   dy[1] = parameters[VELOCITY] * sin(parameters[ANGLE] * PI / 180.0);
+   for (int node = 0; node < NUM_NODES; node++)
+   {
+      if (node == 1)
+         continue;
+      int from = node == 0 ? 1 : node - 1;
+      x[node] = x[from];
+      y[node] = y[from];
+      dx[node] = dx[from];
+      dy[node] = dy[from];
+      if (node == 0)
+         stepBack(x[node], y[node], dx[node], dy[node]);
+      else
+         stepForward(x[node], y[node], dx[node], dy[node]);
+   }
+
+   int numColumns = 0;
+   for (int node = 0; node < NUM_NODES - 1 && numColumns < MAX_COLUMNS; node++)
+   {
+      int columnFirst = max(0, (int)floor(min(x[node], x[node + 1]) / metersPerColumn));
+      int columnLast = min((int)elevations.size() - 1,
+                           (int)floor(max(x[node], x[node + 1]) / metersPerColumn));
+      for (int column = columnFirst; column <= columnLast && numColumns < MAX_COLUMNS; column++)
+      {
+         double elevation = elevations[column];
+         if (y[node] == y[node + 1] ||
+             (elevation - y[node]) * (elevation - y[node + 1]) > 0.0)
+            continue;
+         double fraction = (elevation - y[node]) / (y[node + 1] - y[node]);
+         double xColumn = x[node] + fraction * (x[node + 1] - x[node]);
+         if ((int)floor(xColumn / metersPerColumn) != column)
+            continue;
+         double dxColumn = dx[node] + fraction * (dx[node + 1] - dx[node]);
+         double dyColumn = dy[node] + fraction * (dy[node + 1] - dy[node]);
+         double * launch = columns[numColumns++];
+         launch[X] = xColumn;
+         launch[TIME] = parameters[TIME] + (node - 1) + fraction;
+         launch[ANGLE] = atan2(dyColumn, dxColumn) * 180.0 / PI;
+         launch[VELOCITY] = sqrt(dxColumn * dxColumn + dyColumn * dyColumn);
+      }
+   }
+
+   // a handful, so insert each where it goes
+   for (int i = 1; i < numColumns; i++)
+      for (int j = i; j > 0 && fabs(columns[j][TIME] - parameters[TIME]) <
+                               fabs(columns[j - 1][TIME] - parameters[TIME]); j--)
+         swap_ranges(columns[j], columns[j] + NUM_PARAMETERS, columns[j - 1]);
+   return numColumns;
+}
+
+/************************************************************************
+ * COUNTER BATTERY : FIT LAUNCH
+ * The ground is a column at a time, and next to each other they can be
+ * a hundred meters apart, so the launch altitude is not something to
+ * follow a slope along. Fit from the altitude of the column we think it
+ * was. If the fit moves it to another column, the curve it found is
+ * still good: fit again from every column that curve comes out of, and
+ * of those where the fit stays on its column, the one that missed the
+ * least. If none do, the one that missed the least.
+ *    INPUT  parameters  X, TIME, ANGLE and VELOCITY to start from
+ *    OUTPUT parameters  the fit
+ *           estimate    adds the iterations and flights, and the miss
+ *    RETURN whether the fit settled with the columns agreed
+ *************************************************************************/
+bool CounterBattery::fitLaunch(double parameters[], const vector <TrackSample> & samples,
+                               CounterBatteryEstimate & estimate) const
+{
+   double altitude = getElevation(parameters[X]);
+   bool isFitted = fit(parameters, true /*isLaunch*/, altitude, samples, estimate);
+   if (getElevation(parameters[X]) == altitude)
+      return isFitted;
+
+   double fitted[NUM_PARAMETERS];
+   copy(parameters, parameters + NUM_PARAMETERS, fitted);
+   double missFitted = estimate.miss;
+   bool isAgreedFitted = false;
+   bool isConverged = false;
+
+   double columns[MAX_COLUMNS][NUM_PARAMETERS];
+   int numColumns = findColumns(parameters, altitude, columns);
+   for (int column = 0; column < numColumns; column++)
+   {
+      double * launch = columns[column];
+      altitude = getElevation(launch[X]);
+      isFitted = fit(launch, true /*isLaunch*/, altitude, samples, estimate);
+      bool isAgreed = getElevation(launch[X]) == altitude;
+      if ((isAgreed && !isAgreedFitted) ||
+          (isAgreed == isAgreedFitted && estimate.miss < missFitted))
+      {
+         copy(launch, launch + NUM_PARAMETERS, fitted);
+         missFitted = estimate.miss;
+         isAgreedFitted = isAgreed;
+         isConverged = isFitted && isAgreed;
+      }
+   }
+
+   copy(fitted, fitted + NUM_PARAMETERS, parameters);
+   estimate.miss = missFitted;
+   return isConverged;
+}
+
+/************************************************************************
+ * COUNTER BATTERY : ESTIMATE
+ * Fit the shell where the radar first saw it, fly that back to the
+ * ground, and fit again from every place it could have been fired
+ * from. The second fit steps from the launch, as the shell really did;
+ * the first steps from the first sample, and a step of a second is long
+ * enough that where the steps start moves the curve a little. Of the
+ * launches, the one that misses the samples least.
+ *************************************************************************/
+CounterBatteryEstimate CounterBattery::estimate(vector <TrackSample> samples) const
+{
+   CounterBatteryEstimate estimate = {};
+   if (samples.size() < 3)
+      return estimate;
+   sort(samples.begin(), samples.end(), [](const TrackSample & lhs, const TrackSample & rhs)
+   {
+      return lhs.time < rhs.time;
+   });
+
+   double parameters[NUM_PARAMETERS];
+   double launches[MAX_LAUNCHES][NUM_PARAMETERS];
+   int numLaunches = 0;
+   if (!guess(parameters, samples) ||
+       !fit(parameters, false /*isLaunch*/, 0.0, samples, estimate) ||
+       (numLaunches = flyBack(parameters, samples.front().time, launches)) == 0)
+      return estimate;
+
+   int best = -1;
+   double missBest = 0.0;
+   bool isConvergedBest = false;
+   for (int launch = 0; launch < numLaunches; launch++)
+   {
+      bool isConverged = fitLaunch(launches[launch], samples, estimate);
+      if (best < 0 || estimate.miss < missBest * MISS_EARLIER)
+      {
+         best = launch;
+         missBest = estimate.miss;
+         isConvergedBest = isConverged;
+      }
+   }
+
+   const double * launch = launches[best];
+   double dx = cos(launch[ANGLE] * PI / 180.0);
+   double dy = sin(launch[ANGLE] * PI / 180.0);
+   estimate.posLaunch = Position(launch[X], getElevation(launch[X]));
+   estimate.timeLaunch = launch[TIME];
+   estimate.angle = atan2(dy, fabs(dx)) * 180.0 / PI;
+   estimate.velocity = launch[VELOCITY];
+   estimate.direction = dx >= 0.0 ? 1.0 : -1.0;
+   estimate.miss = missBest;
+   estimate.converged = isConvergedBest;
+   return estimate;
+}
+
+/************************************************************************
+ * COUNTER BATTERY : ESTIMATE
+ * A track to a thread at a time: they take different times
+ *************************************************************************/
+vector <CounterBatteryEstimate> CounterBattery::estimate(const vector <vector <TrackSample>> & tracks,
+                                                         int threads) const
+{
+   vector <CounterBatteryEstimate> estimates(tracks.size());
+   parallelFor(tracks.size(), [&](size_t i)
+   {
+      estimates[i] = estimate(tracks[i]);
+   }, threads, 1 /*chunk*/);
+   return estimates;
+}
@@ -0,0 +1,141 @@
+/***********************************************************************
+ * Header File:
+ *    Counter Battery : where an incoming shell was fired from
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    A radar sees a handful of noisy positions of a shell in the air.
+ *    The shell flies the same physics the game does, so find where it
+ *    was and how fast it was going when the radar first saw it, the
+ *    four numbers that fly closest to the rest of what was seen:
+ *    nonlinear least squares by Levenberg-Marquardt. Then fly it
+ *    backwards, undoing the game's steps one at a time, until it goes
+ *    into the ground: that is where it was fired from.
+ *
+ *    - Every flight runs on Dual numbers, so it comes back with how
+ *      each miss moves with each of the four: the whole Jacobian for
+ *      the price of one flight rather than five.
+ *    - A step that makes it worse is tried again shorter without
+ *      flying again: the last flight's normal equations are kept.
+ *    - The first guess ignores the air: a parabola through the samples.
+ *      Over the few seconds of a track the air moves the shell little,
+ *      so it is close and a fit takes a handful of flights.
+ *
+ *    Fitting where the shell was fired from directly would be the same
+ *    four numbers, but far worse conditioned: a small change in the
+ *    launch point moves the whole track.
+ *
+ *    The first fit steps from the first sample, the shell stepped from
+ *    the gun, and over a second a step moves the curve a little, so a
+ *    second fit from the launch finishes it. The ground is a column at a
+ *    time and the game only looks for it at the end of a step, so a
+ *    shell may seem to come out of more than one place: each gets its
+ *    fit, and the latest wins unless another misses clearly less.
+ ************************************************************************/
+
+#ifndef counterBattery_h
+#define counterBattery_h
+
+#include "position.h"
+#include <vector>
+
+class Ground;
+
+/*********************************************
+ * TRACK SAMPLE
+ * Where the radar saw the shell, and when
+ *********************************************/
+struct TrackSample
+{
+   double time;      // seconds, on the radar's clock
+   Position pos;
+};
+
+/*********************************************
+ * COUNTER BATTERY ESTIMATE
+ * Where and how the shell was fired
+ *********************************************/
+struct CounterBatteryEstimate
+{
+   Position posLaunch;   // on the ground
+   double timeLaunch;    // seconds, on the radar's clock
+   double angle;         // degrees above the horizon
+   double velocity;      // muzzle velocity in meters/second
+   double direction;     // 1 if it was fired to the right, -1 to the left
+   double miss;          // meters, the RMS distance from the samples
+   int iterations;
+   int simulations;      // flights it took
+   bool converged;       // the fit settled. If not, the rest is the best it
+                         // found, if it got as far as the ground
+};
+
+/*********************************************
+ * COUNTER BATTERY
+ *********************************************/
+class CounterBattery
+{
+public:
+   // the ground the shells were fired from
+   CounterBattery(const Ground & ground);
+
+   // one track, at least three samples of it in any order
+   CounterBatteryEstimate estimate(std::vector <TrackSample> samples) const;
+
+   // many tracks, each on its own, on as many threads (0 for every core)
+   std::vector <CounterBatteryEstimate> estimate(const std::vector <std::vector <TrackSample>> & tracks,
+                                                 int threads = 0) const;
+
+   static const int MAX_ITERATIONS = 50;   // of a fit
+   static const int MAX_COLUMNS = 8;       // to try the launch from
+   static const int MAX_LAUNCHES = 4;      // places it may have been fired from
+
+private:
+   // the four things we are looking for: where the shell was and the
+   // angle of its velocity from the +x axis, either when the radar first
+   // saw it or when it left the ground. On the ground the ground decides
+   // Y, and the time it left takes its place
+   enum Parameter { X, Y, ANGLE, VELOCITY, NUM_PARAMETERS, TIME = Y };
+
+   // one flight: how far it missed and the normal equations for the
+   // next step, J'J and J'r
+   struct Evaluation
+   {
+      double cost;   // the sum of the squares of the misses
+      double jtj[NUM_PARAMETERS][NUM_PARAMETERS];
+      double jtr[NUM_PARAMETERS];
+   };
+
+   // fly these parameters past every sample, from ground at this
+   // altitude if it is the launch
+   Evaluation evaluate(const double parameters[], bool isLaunch, double altitude,
+                       const std::vector <TrackSample> & samples) const;
+
+   // the least squares from these parameters. False if it did not settle
+   bool fit(double parameters[], bool isLaunch, double altitude,
+            const std::vector <TrackSample> & samples, CounterBatteryEstimate & estimate) const;
+
+   // without the air, the parabola through the samples. False if they
+   // are all at the same time
+   bool guess(double parameters[], const std::vector <TrackSample> & samples) const;
+
+   // from where the shell was at this time, back to every place it could
+   // have left the ground. How many there are
+   int flyBack(const double parameters[], double time, double launches[][NUM_PARAMETERS]) const;
+
+   // where the steps either side of this launch cross the top of a
+   // column. How many there are
+   int findColumns(const double parameters[], double altitude, double columns[][NUM_PARAMETERS]) const;
+
+   // the launch, from this one, that fits best with the ground under it
+   bool fitLaunch(double parameters[], const std::vector <TrackSample> & samples,
+                  CounterBatteryEstimate & estimate) const;
+
+   // the ground under x, as the game sees it. 0 off the ground
+   double getElevation(double x) const;
+
+   std::vector <double> elevations;   // of each column, so any thread may read
+   double metersPerColumn;
+   double elevationMin;               // of the ground, and off it
+};
+
+#endif /* counterBattery_h */
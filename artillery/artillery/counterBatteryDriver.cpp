@@ -0,0 +1,178 @@
+/***********************************************************************
+ * Source File:
+ *    Counter Battery Driver : find where known shells were fired from
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    counterBattery [--shells n] [--noise m] [--samples n] [--seed n]
+ *                   [--angle degrees]
+ *    Make a ground for every shell and fire it from the howitzer at a
+ *    random angle and charge, or within 0.05 degrees of angle. The radar sees the end of its flight, from
+ *    60% to 95% of the way, each sample off by noise meters (one standard
+ *    deviation) either way. From those, find where it was fired from. A
+ *    shell is found if the launch is within 100m, the angle within half
+ *    a degree, and the velocity within 10m/s. Built and run by ctest as
+ *    the "counterBattery" test.
+ *
+ *    An Angle snaps onto 30, 45 and 60 degrees when it is within 0.06
+ *    of them, so near those the angle must be found within 0.02 degrees
+ *    instead: every shell in the snap would otherwise come back at one
+ *    angle. Run by ctest without noise as "counterBattery_30" and so on.
+ *
+ *    A track can fit more than one launch within the noise: a shell
+ *    that went over a hill between two steps looks fired from it just as
+ *    well. So we fail only if fewer than 95% of the shells are found.
+ ************************************************************************/
+
+#include "counterBattery.h"
+#include "ground.h"
+#include "randomStream.h"
+#include "trajectory.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>    // for atof() and srand()
+#include <cstring>    // for strcmp()
+#include <iomanip>
+#include <iostream>
+
+using namespace std;
+
+// the game defines this; we are not the game
+double Position::metersFromPixels = 40.0;
+
+const double X_TOLERANCE = 100.0;        // meters, of the launch
+const double ANGLE_TOLERANCE = 0.5;      // degrees
+const double ANGLE_TOLERANCE_NEAR = 0.02;  // degrees, when fired near an angle
+const double ANGLE_NEAR = 0.05;          // degrees either side of it
+const double VELOCITY_TOLERANCE = 10.0;  // meters/second
+const double FOUND_REQUIRED = 0.95;      // of the shells
+const double TIME_SEEN_FIRST = 0.6;      // of the flight, when the radar sees it
+const double TIME_SEEN_LAST = 0.95;
+const double TIME_FLIGHT_MIN = 10.0;     // seconds. Shorter is not much of a track
+
+/*********************************
+ * Fire, track, estimate, and report
+ *********************************/
+int main(int argc, char ** argv)
+{
+   int shells = 100;
+   double noise = 2.0;
+   int numSamples = 8;
+   unsigned int seed = 1;
+   double angle = 0.0;          // degrees, or any at all
+
+   for (int i = 1; i < argc; i += 2)
+   {
+      if (i + 1 == argc)
+      {
+         cerr << "No value for " << argv[i] << endl;
+         return 1;
+      }
+      double value = atof(argv[i + 1]);
+      if      (strcmp(argv[i], "--shells")  == 0) shells = (int)value;
+      else if (strcmp(argv[i], "--noise")   == 0) noise = value;
+      else if (strcmp(argv[i], "--samples") == 0) numSamples = (int)value;
+      else if (strcmp(argv[i], "--seed")    == 0) seed = (unsigned int)value;
+      else if (strcmp(argv[i], "--angle")   == 0) angle = value;
+      else
+      {
+         cerr << "Unknown option " << argv[i] << endl;
+         return 1;
+      }
+   }
+   if (shells <= 0 || numSamples < 3 || noise < 0.0)
+   {
+      cerr << "There must be at least one shell and three samples of it" << endl;
+      return 1;
+   }
+
+   double angleTolerance = angle == 0.0 ? ANGLE_TOLERANCE : ANGLE_TOLERANCE_NEAR;
+
+   srand(seed);
+   RandomStream stream(seed, 0);
+   Viewport viewport(700.0, 500.0, 40.0);   // the same as the game
+   Ground ground(viewport);
+
+   int found = 0;
+   int converged = 0;
+   int simulations = 0;
+   double secondsEstimating = 0.0;
+   vector <double> missesX;                // meters, of the launch of every shell
+   double missAngleWorst = 0.0;            // degrees, of those found
+   double missVelocityWorst = 0.0;         // meters/second, of those found
+   for (int shell = 0; shell < shells; )
+   {
+      // from the howitzer, toward its target, the way the game fires
+      Position posHowitzer(viewport.getUpperRight().getMetersX() * random(0.1, 0.9), 0.0);
+      ground.reset(posHowitzer);
+      double direction = ground.getTarget().getMetersX() > posHowitzer.getMetersX() ? 1.0 : -1.0;
+      Shot shot = { angle == 0.0 ? random(20.0, 70.0) : angle + random(-ANGLE_NEAR, ANGLE_NEAR),
+                    random(400.0, TRIPLE7_VELOCITY),
+                    posHowitzer.getMetersY() };
+      vector <double> elevations = ground.getElevations();
+      Trajectory trajectory;
+      trajectory.fly(shot, Ground::makeGroundAt(elevations, ground.getMetersPerColumn(),
+                                                posHowitzer.getMetersX(), direction));
+      double timeFlight = trajectory.getImpact().time;
+      if (!trajectory.hasLanded() || timeFlight < TIME_FLIGHT_MIN)
+         continue;
+      shell++;
+
+      // what the radar sees, on a clock of its own
+      const vector <TrajectoryPoint> & points = trajectory.getPoints();
+      double timeRadar = 100.0 * stream.uniform();
+      vector <TrackSample> samples;
+      for (int i = 0; i < numSamples; i++)
+      {
+         double time = timeFlight * (TIME_SEEN_FIRST + (TIME_SEEN_LAST - TIME_SEEN_FIRST) *
+                                     i / (numSamples - 1));
+         const TrajectoryPoint & before = points[(size_t)time];
+         const TrajectoryPoint & after = points[(size_t)time + 1];
+         double fraction = time - floor(time);
+         double x = before.x + fraction * (after.x - before.x);
+         double y = before.y + fraction * (after.y - before.y);
+         samples.push_back({ timeRadar + time,
+                             Position(posHowitzer.getMetersX() + direction * x + noise * stream.normal(),
+                                      y + noise * stream.normal()) });
+      }
+
+      CounterBattery counterBattery(ground);
+      chrono::steady_clock::time_point timeBegin = chrono::steady_clock::now();
+      CounterBatteryEstimate estimate = counterBattery.estimate(samples);
+      secondsEstimating += chrono::duration<double>(chrono::steady_clock::now() - timeBegin).count();
+      simulations += estimate.simulations;
+      if (estimate.converged)
+         converged++;
+
+      double missX = fabs(estimate.posLaunch.getMetersX() - posHowitzer.getMetersX());
+      double missAngle = fabs(estimate.angle - shot.angle);
+      double missVelocity = fabs(estimate.velocity - shot.velocity);
+      missesX.push_back(missX);
+      if (missX <= X_TOLERANCE && missAngle <= angleTolerance && missVelocity <= VELOCITY_TOLERANCE &&
+          estimate.direction == direction)
+      {
+         found++;
+         missAngleWorst = max(missAngleWorst, missAngle);
+         missVelocityWorst = max(missVelocityWorst, missVelocity);
+      }
+   }
+
+   sort(missesX.begin(), missesX.end());
+   cout << fixed << setprecision(2)
+        << shells << " shells, " << numSamples << " samples of each off by "
+        << noise << "m\n"
+        << "estimating: " << secondsEstimating * 1000.0 / shells << "ms and "
+        << (double)simulations / shells << " flights a shell\n"
+        << "found:      " << found << ", " << converged << " converged\n"
+        << "launch:     " << missesX[missesX.size() / 2] << "m off at the median, "
+        << missesX[missesX.size() * 9 / 10] << "m at the 90th percentile\n"
+        << "of those found, at worst " << missAngleWorst << " degrees and "
+        << missVelocityWorst << "m/s off\n";
+   if (found < FOUND_REQUIRED * shells)
+   {
+      cout << shells - found << " shells were not found\n";
+      return 1;
+   }
+   return 0;
+}
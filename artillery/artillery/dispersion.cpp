@@ -0,0 +1,63 @@
+/***********************************************************************
+ * Source File:
+ *    Dispersion : where a great many rounds land
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    Fly the perturbed rounds across all the cores
+ ************************************************************************/
+
+#include "dispersion.h"
+#include "parallel.h"
+#include "constants.h"   // for PI
+#include <algorithm>  // for min()
+#include <cassert>
+#include <cmath>
+
+using namespace std;
+
+const size_t CHUNK = 64;   // rounds flown through one Trajectory
+
+/************************************************************************
+ * DISPERSION : RUN
+ * Fly the nominal round to find the aim point, then every perturbed
+ * round. Round i draws from stream i, and writes only impacts[i], so
+ * it does not matter which thread flies it or when. A chunk of rounds
+ * flies through one Trajectory, so its points are allocated once a
+ * chunk rather than once a round.
+ *************************************************************************/
+void Dispersion::run()
+{
+   assert(config.rounds > 0);
+
+   Trajectory nominal(false /*isRecording*/, config.precision);
+   nominal.fly(config.shot);
+   double nominalRange = nominal.getImpact().x;
+
+   impacts.resize(config.rounds);
+   size_t rounds = (size_t)config.rounds;
+   size_t numChunks = (rounds + CHUNK - 1) / CHUNK;
+   parallelFor(numChunks, [this, nominalRange, rounds](size_t chunk)
+   {
+      Trajectory trajectory(false /*isRecording*/, config.precision);
+      for (size_t i = chunk * CHUNK; i < min((chunk + 1) * CHUNK, rounds); i++)
+      {
+         RandomStream random(config.seed, i);
+         Shot shot = config.shot;
+         shot.velocity += config.velocity.sample(random);
+         shot.mass     += config.mass.sample(random);
+         shot.angle    += config.elevation.sample(random);
+         double azimuth = config.azimuth.sample(random) * PI / 180.0;
+
+         trajectory.fly(shot);
+
+         Impact & impact = impacts[i];
+         impact.landed = trajectory.hasLanded();
+         double range = trajectory.getImpact().x;
+         impact.range = range * cos(azimuth) - nominalRange;
+         impact.deflection = range * sin(azimuth);
+      }
+   }, config.threads, 1 /*chunk*/);
+
+   stats = computeStats(impacts, nominalRange);
+}
@@ -0,0 +1,174 @@
+/***********************************************************************
+ * Header File:
+ *    Dispersion : where a great many rounds land
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    No two rounds are quite alike: the muzzle velocity, the mass and
+ *    the aim all vary a little. Dispersion fires many perturbed rounds
+ *    (Monte Carlo) across all the cores and reports how they scatter
+ *    around the aim point: the CEP, the range and deflection errors,
+ *    and a histogram of the impacts. Every round has its own random
+ *    stream, so the answer is the same on one thread or thirty-two.
+ *
+ *    Our physics is two dimensional, so a round never drifts sideways
+ *    in flight. The deflection comes from the error in the azimuth
+ *    alone: range * sin(azimuth error).
+ ************************************************************************/
+
+#ifndef dispersion_h
+#define dispersion_h
+
+#include "trajectory.h"      // for Shot
+#include "randomStream.h"
+#include <cmath>      // for sqrt()
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+/*********************************************
+ * DISTRIBUTION
+ * How one quantity varies from round to round
+ *********************************************/
+struct Distribution
+{
+   enum Type { FIXED, NORMAL, UNIFORM };
+
+   Distribution(Type type = FIXED, double spread = 0.0) : type(type), spread(spread) {}
+
+   // an error to add to the nominal value
+   double sample(RandomStream & random) const
+   {
+      switch (type)
+      {
+         case NORMAL:  return spread * random.normal();               // standard deviation
+         case UNIFORM: return spread * (2.0 * random.uniform() - 1.0); // half width
+         default:      return 0.0;
+      }
+   }
+
+   // the standard deviation of the errors
+   double getDeviation() const
+   {
+      switch (type)
+      {
+         case NORMAL:  return spread;
+         case UNIFORM: return spread / sqrt(3.0);
+         default:      return 0.0;
+      }
+   }
+
+   Type type;
+   double spread;
+};
+
+/*********************************************
+ * DISPERSION CONFIG
+ * The nominal shot, and how far each round
+ * strays from it
+ *********************************************/
+struct DispersionConfig
+{
+   DispersionConfig() : shot({ 45.0, TRIPLE7_VELOCITY, 0.0 }),
+      rounds(10000), seed(1), threads(0), precision(DOUBLE),
+      velocity(Distribution::NORMAL, 2.0),      // m/s
+      mass(Distribution::NORMAL, 0.1),          // kg
+      elevation(Distribution::NORMAL, 0.05),    // degrees
+      azimuth(Distribution::NORMAL, 0.05) {}    // degrees
+
+   Shot shot;              // what we are aiming
+   int rounds;             // how many to fire
+   uint64_t seed;          // the same seed fires the same rounds
+   int threads;            // 0 for every core
+   Precision precision;    // FLOAT is plenty for the scatter
+   Distribution velocity;
+   Distribution mass;
+   Distribution elevation;
+   Distribution azimuth;
+};
+
+/*********************************************
+ * IMPACT
+ * Where one round landed compared to where
+ * the nominal round landed, in meters
+ *********************************************/
+struct Impact
+{
+   double range;        // long is positive
+   double deflection;   // right is positive
+   bool landed;
+};
+
+/*********************************************
+ * IMPACT HISTOGRAM
+ * How many rounds landed in each cell of a
+ * grid centered on the aim point
+ *********************************************/
+class ImpactHistogram
+{
+public:
+   ImpactHistogram(int size = 21, double cell = 10.0) : size(size), cell(cell),
+      counts(size * size, 0), outside(0) {}
+
+   void add(const Impact & impact);
+   int  getCount(int iRange, int iDeflection) const { return counts[iRange * size + iDeflection]; }
+   int  getOutside() const { return outside; }
+   int  getSize()    const { return size;    }
+   double getCell()  const { return cell;    }
+
+   // a picture of it: range up the page, deflection across
+   void draw(std::ostream & out) const;
+
+private:
+   int size;                // cells on a side. Odd, so the aim is a cell
+   double cell;             // meters on a side of a cell
+   std::vector <int> counts;
+   int outside;             // landed off the grid
+};
+
+/*********************************************
+ * DISPERSION STATS
+ * How the rounds scattered
+ *********************************************/
+struct DispersionStats
+{
+   int rounds;
+   int landed;
+   double nominalRange;      // where the perfect round lands
+   double meanRange;         // mean point of impact, relative to the aim
+   double meanDeflection;
+   double deviationRange;    // standard deviations about the mean point
+   double deviationDeflection;
+   double cep;               // half the rounds land within this of the aim
+};
+
+/*********************************************
+ * DISPERSION
+ *********************************************/
+class Dispersion
+{
+public:
+   Dispersion(const DispersionConfig & config) : config(config), stats() {}
+
+   // fire them all
+   void run();
+
+   const std::vector <Impact> & getImpacts() const { return impacts; }
+   const DispersionStats & getStats() const { return stats; }
+
+   // the fraction of the rounds that landed within radius of the aim
+   double getProbabilityHit(double radius) const;
+
+   // a histogram of the impacts
+   ImpactHistogram getHistogram(int size = 21, double cell = 10.0) const;
+
+   // gather the statistics from the impacts. Public for testing
+   static DispersionStats computeStats(const std::vector <Impact> & impacts, double nominalRange);
+
+private:
+   DispersionConfig config;
+   std::vector <Impact> impacts;
+   DispersionStats stats;
+};
+
+#endif /* dispersion_h */
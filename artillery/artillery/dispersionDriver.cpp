@@ -0,0 +1,167 @@
+/***********************************************************************
+ * Source File:
+ *    Dispersion Driver : fire a great many rounds from the command line
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    dispersion [--rounds n] [--threads n] [--seed n] [--angle degrees]
+ *               [--velocity m/s] [--altitude m] [--radius m]
+ *               [--precision float|double] [--check 0|1]
+ *    Fire the rounds, then report how they scattered, the chance of
+ *    landing within radius of the aim, and a picture of the impacts.
+ *
+ *    With --check, fire them again with one spread at a time and fail
+ *    unless each scatters them as far as its derivative says it should:
+ *    a spread lost on the way to the flight, such as an elevation error
+ *    an Angle snaps away, goes unnoticed in the sum of them all. Run by
+ *    ctest as the "dispersion" test.
+ ************************************************************************/
+
+#include "dispersion.h"
+#include "constants.h"   // for PI
+#include <chrono>
+#include <cmath>
+#include <cstdlib>    // for atof()
+#include <cstring>    // for strcmp()
+#include <iomanip>
+#include <iostream>
+
+using namespace std;
+
+const double CHECK_TOLERANCE = 0.1;   // of the deviation the derivative expects
+
+/************************************************************************
+ * RANGE AT
+ * Where the round lands
+ *************************************************************************/
+static double rangeAt(const Shot & shot, Precision precision)
+{
+   Trajectory trajectory(false /*isRecording*/, precision);
+   trajectory.fly(shot);
+   return trajectory.getImpact().x;
+}
+
+/************************************************************************
+ * CHECK SPREAD
+ * Fire the rounds with only this spread, and compare how far they
+ * scatter with the deviation expected of it. True if they are close
+ *    INPUT  config        the rounds, and the spread among the others
+ *           spread        which spread, in config
+ *           expected      the deviation it should give, in meters
+ *           isDeflection  it scatters the rounds sideways, not in range
+ *************************************************************************/
+static bool checkSpread(const DispersionConfig & config, Distribution DispersionConfig::*spread,
+                        const char * name, double expected, bool isDeflection)
+{
+   DispersionConfig configAlone = config;
+   configAlone.velocity = configAlone.mass = configAlone.elevation = configAlone.azimuth =
+      Distribution();
+   configAlone.*spread = config.*spread;
+
+   Dispersion dispersion(configAlone);
+   dispersion.run();
+   const DispersionStats & stats = dispersion.getStats();
+   double deviation = isDeflection ? stats.deviationDeflection : stats.deviationRange;
+   cout << setw(10) << left << name << right << (isDeflection ? "deflection" : "range")
+        << " deviation " << deviation << "m, " << expected << "m expected\n";
+   return fabs(deviation - expected) <= CHECK_TOLERANCE * expected;
+}
+
+/*********************************
+ * Fire the rounds and report
+ *********************************/
+int main(int argc, char ** argv)
+{
+   DispersionConfig config;
+   double radius = 50.0;
+   bool isCheck = false;
+
+   for (int i = 1; i < argc; i += 2)
+   {
+      if (i + 1 == argc)
+      {
+         cerr << "No value for " << argv[i] << endl;
+         return 1;
+      }
+      double value = atof(argv[i + 1]);
+      if      (strcmp(argv[i], "--rounds")   == 0) config.rounds = (int)value;
+      else if (strcmp(argv[i], "--threads")  == 0) config.threads = (int)value;
+      else if (strcmp(argv[i], "--seed")     == 0) config.seed = (uint64_t)value;
+      else if (strcmp(argv[i], "--angle")    == 0) config.shot.angle = value;
+      else if (strcmp(argv[i], "--velocity") == 0) config.shot.velocity = value;
+      else if (strcmp(argv[i], "--altitude") == 0) config.shot.altitude = value;
+      else if (strcmp(argv[i], "--radius")   == 0) radius = value;
+      else if (strcmp(argv[i], "--check")    == 0) isCheck = value != 0.0;
+      else if (strcmp(argv[i], "--precision") == 0)
+         config.precision = strcmp(argv[i + 1], "float") == 0 ? FLOAT : DOUBLE;
+      else
+      {
+         cerr << "Unknown option " << argv[i] << endl;
+         return 1;
+      }
+   }
+   if (config.rounds <= 0)
+   {
+      cerr << "There must be at least one round" << endl;
+      return 1;
+   }
+
+   chrono::steady_clock::time_point timeBegin = chrono::steady_clock::now();
+   Dispersion dispersion(config);
+   dispersion.run();
+   double seconds = chrono::duration<double>(chrono::steady_clock::now() - timeBegin).count();
+
+   const DispersionStats & stats = dispersion.getStats();
+   cout << fixed << setprecision(2)
+        << stats.rounds << " rounds in " << seconds << "s ("
+        << stats.landed << " landed)\n"
+        << "aim point:        " << stats.nominalRange << "m\n"
+        << "mean range error: " << stats.meanRange << "m, deviation "
+        << stats.deviationRange << "m\n"
+        << "mean deflection:  " << stats.meanDeflection << "m, deviation "
+        << stats.deviationDeflection << "m\n"
+        << "CEP:              " << stats.cep << "m\n"
+        << "P(within " << radius << "m): " << setprecision(4)
+        << dispersion.getProbabilityHit(radius) << "\n\n";
+
+   // a histogram about four deviations across
+   double spread = max(stats.deviationRange, stats.deviationDeflection);
+   ImpactHistogram histogram = dispersion.getHistogram(41, max(1.0, spread / 5.0));
+   cout << "impacts, " << setprecision(1) << histogram.getCell()
+        << "m cells, long at the top (" << histogram.getOutside() << " off the grid):\n";
+   histogram.draw(cout);
+   if (!isCheck)
+      return 0;
+
+   // each spread alone, to first order. The mass is not an input of the
+   // Dual flight, so it is a difference
+   Sensitivity sensitivity = Trajectory::flySensitivity(config.shot);
+   double deviationMass = config.mass.getDeviation();
+   double rangePerMass = 0.0;
+   if (deviationMass > 0.0)
+   {
+      Shot heavy = config.shot;
+      Shot light = config.shot;
+      heavy.mass += deviationMass;
+      light.mass -= deviationMass;
+      rangePerMass = (rangeAt(heavy, config.precision) - rangeAt(light, config.precision)) /
+                     (2.0 * deviationMass);
+   }
+
+   cout << "\neach spread alone:\n" << setprecision(2);
+   bool isPassed = true;
+   isPassed &= checkSpread(config, &DispersionConfig::velocity, "velocity",
+                           fabs(sensitivity.rangePerVelocity) * config.velocity.getDeviation(), false);
+   isPassed &= checkSpread(config, &DispersionConfig::mass, "mass",
+                           fabs(rangePerMass) * deviationMass, false);
+   isPassed &= checkSpread(config, &DispersionConfig::elevation, "elevation",
+                           fabs(sensitivity.rangePerDegree) * config.elevation.getDeviation(), false);
+   isPassed &= checkSpread(config, &DispersionConfig::azimuth, "azimuth",
+                           stats.nominalRange * config.azimuth.getDeviation() * PI / 180.0, true);
+   if (!isPassed)
+   {
+      cout << "a spread does not scatter the rounds as it should\n";
+      return 1;
+   }
+   return 0;
+}
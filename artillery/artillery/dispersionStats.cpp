@@ -0,0 +1,136 @@
+/***********************************************************************
+ * Source File:
+ *    Dispersion Stats : how the rounds scattered
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    The statistics and histogram of a Dispersion. These only look at
+ *    the impacts, never the physics, so they are tested on their own.
+ ************************************************************************/
+
+#include "dispersion.h"
+#include <algorithm>   // for nth_element()
+#include <cassert>
+#include <cmath>
+
+using namespace std;
+
+/************************************************************************
+ * IMPACT HISTOGRAM : ADD
+ * Count one more round in the cell it landed in
+ *************************************************************************/
+void ImpactHistogram::add(const Impact & impact)
+{
+   int half = size / 2;
+   int iRange      = (int)floor(impact.range      / cell + 0.5) + half;
+   int iDeflection = (int)floor(impact.deflection / cell + 0.5) + half;
+   if (!impact.landed ||
+       iRange < 0 || iRange >= size || iDeflection < 0 || iDeflection >= size)
+      outside++;
+   else
+      counts[iRange * size + iDeflection]++;
+}
+
+/************************************************************************
+ * IMPACT HISTOGRAM : DRAW
+ * One character per cell, darker for more rounds. Long is at the top.
+ *************************************************************************/
+void ImpactHistogram::draw(ostream & out) const
+{
+   const char SHADES[] = " .:-=+*#%@";
+   const int NUM_SHADES = sizeof(SHADES) - 1;
+
+   int most = 1;
+   for (int count : counts)
+      most = max(most, count);
+
+   for (int iRange = size - 1; iRange >= 0; iRange--)
+   {
+      for (int iDeflection = 0; iDeflection < size; iDeflection++)
+      {
+         int count = getCount(iRange, iDeflection);
+         int shade = count == 0 ? 0 : 1 + (count - 1) * (NUM_SHADES - 1) / most;
+         out << SHADES[min(shade, NUM_SHADES - 1)];
+      }
+      out << '\n';
+   }
+}
+
+/************************************************************************
+ * DISPERSION : COMPUTE STATS
+ * The mean point of impact and the spread about it, and the CEP: the
+ * median distance from the aim point. Rounds that never landed are
+ * counted but otherwise left out.
+ *************************************************************************/
+DispersionStats Dispersion::computeStats(const vector <Impact> & impacts, double nominalRange)
+{
+   DispersionStats stats = {};
+   stats.rounds = (int)impacts.size();
+   stats.nominalRange = nominalRange;
+
+   vector <double> distances;
+   distances.reserve(impacts.size());
+   for (const Impact & impact : impacts)
+      if (impact.landed)
+      {
+         stats.meanRange += impact.range;
+         stats.meanDeflection += impact.deflection;
+         distances.push_back(sqrt(impact.range * impact.range +
+                                  impact.deflection * impact.deflection));
+      }
+   stats.landed = (int)distances.size();
+   if (stats.landed == 0)
+      return stats;
+   stats.meanRange /= stats.landed;
+   stats.meanDeflection /= stats.landed;
+
+   for (const Impact & impact : impacts)
+      if (impact.landed)
+      {
+         stats.deviationRange += (impact.range - stats.meanRange) *
+                                 (impact.range - stats.meanRange);
+         stats.deviationDeflection += (impact.deflection - stats.meanDeflection) *
+                                      (impact.deflection - stats.meanDeflection);
+      }
+   if (stats.landed > 1)
+   {
+      stats.deviationRange = sqrt(stats.deviationRange / (stats.landed - 1));
+      stats.deviationDeflection = sqrt(stats.deviationDeflection / (stats.landed - 1));
+   }
+   else
+      stats.deviationRange = stats.deviationDeflection = 0.0;
+
+   vector <double>::iterator itMedian = distances.begin() + distances.size() / 2;
+   nth_element(distances.begin(), itMedian, distances.end());
+   stats.cep = *itMedian;
+   return stats;
+}
+
+/************************************************************************
+ * DISPERSION : GET PROBABILITY HIT
+ * What fraction of all the rounds fired landed within radius of the aim
+ *************************************************************************/
+double Dispersion::getProbabilityHit(double radius) const
+{
+   if (impacts.empty())
+      return 0.0;
+   int hits = 0;
+   for (const Impact & impact : impacts)
+      if (impact.landed &&
+          impact.range * impact.range + impact.deflection * impact.deflection <= radius * radius)
+         hits++;
+   return (double)hits / impacts.size();
+}
+
+/************************************************************************
+ * DISPERSION : GET HISTOGRAM
+ * Every impact sorted into a grid of cells
+ *************************************************************************/
+ImpactHistogram Dispersion::getHistogram(int size, double cell) const
+{
+   assert(size > 0 && cell > 0.0);
+   ImpactHistogram histogram(size, cell);
+   for (const Impact & impact : impacts)
+      histogram.add(impact);
+   return histogram;
+}
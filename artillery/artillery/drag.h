@@ -8,7 +8,8 @@
  *    the fired ammo. This calculation is based on a number
  *    of environmental factors plus the velocity and altitude
  *    of ammo. All these things continually change in value
- *    as the ammo advances.
+ *    as the ammo advances. DragT works on any scalar, so with
+ *    Dual numbers the drag carries its derivatives too.
  ************************************************************************/
 
 #ifndef drag_h
@@ -16,13 +17,18 @@
 
 #include "ammunition.h"
 #include "position.h"
+#include "profiler.h"
+#include "trace.h"
 #include "data/data.h"
 #include <iostream>
 
-class Drag
+class BenchPhysics;
+
+template <class T = double>
+class DragT
 {
 public:
-  Drag(Ammunition* ammo)
+  DragT(AmmunitionT <T> * ammo)
    {
 	 //  Sets pAmmo to an instance of Ammunition so
 	 //  we can access its attributes to do calculations.
@@ -30,9 +36,9 @@ public:
 	 updateFactors();
    }
    
-   void setAmmunition(Ammunition *ammunition) { pAmmo = ammunition; }
-   Motion getAcceleration();
-   double getDrag()
+   void setAmmunition(AmmunitionT <T> *ammunition) { pAmmo = ammunition; }
+   MotionT <T> getAcceleration();
+   T getDrag()
    {
 	 updateFactors();
 	 return drag;
@@ -40,39 +46,44 @@ public:
    
    void displayDrag();
    
+   // benchmark access
+   friend BenchPhysics;
    
 private:
-   void   computeDrag(const double coefficient, const double density);
-   double computeDensity(     const double altitude    )  const;
-   double computeSpeedOfSound(const double altitude    )  const;
-   double computeCoefficient( const double velocity,
-							  const double speedOfSound)  const;
-   double computeMidValue(const double x, const double x1, const double y1,
+   void   computeDrag(const T & coefficient, const T & density);
+   T      computeDensity(     const T & altitude    )  const;
+   T      computeSpeedOfSound(const T & altitude    )  const;
+   T      computeCoefficient( const T & velocity,
+							  const T & speedOfSound)  const;
+   T      computeMidValue(const T & x, const double x1, const double y1,
 						  const double x2, const double y2) const;
    void updateFactors();
   
    
-   double drag;
-   Ammunition *pAmmo;
+   T drag;
+   AmmunitionT <T> *pAmmo;
 	
 };
 
+typedef DragT <double> Drag;
+
 /**********************************************
  * DRAG :: GET ACCELERATION
  * Returns an instance of point that
  * is acceleration.
   **********************************************/
-Motion Drag::getAcceleration()
+template <class T>
+inline MotionT <T> DragT <T> ::getAcceleration()
 {
    double mass = pAmmo->getMass();
    assert(mass > 0); // ammo cannot be weightless
 	
-   double resistance = getDrag() / mass;
+   T resistance = getDrag() / mass;
 
-   Angle dragAngle(pAmmo->getVelocity().getDirection());
+   AngleT <T> dragAngle(pAmmo->getVelocity().getDirection());
    dragAngle.addRadians(PI);
 
-   Motion acceleration;
+   MotionT <T> acceleration;
    acceleration.setMovement(resistance, dragAngle);
    return acceleration;
   
@@ -83,9 +94,10 @@ Motion Drag::getAcceleration()
  * Calculates density, which is
  * determined based on altitude.
  * *******************************************/
-double Drag::computeDensity(const double altitude) const
+template <class T>
+inline T DragT <T> ::computeDensity(const T & altitude) const
 {
-   double density = densityData.back().output;
+   T density = densityData.back().output;
 
    for (int i = 0; i < densityData.size() - 1; i++)
    {
@@ -110,7 +122,6 @@ double Drag::computeDensity(const double altitude) const
 								 densityData[i + 1].input, densityData[i + 1].output);
 		 
 		 assert(density < densityData[i].output && density > densityData[i+1].output);
-		 std::cout << "density: " << density << std::endl;
 		 break;
 	  }
 	  
@@ -123,11 +134,12 @@ double Drag::computeDensity(const double altitude) const
  * Computes speed of sound, which is
  * determined based on the ammo's altitude
  * *************************************************/
-double Drag::computeSpeedOfSound(const double altitude) const
+template <class T>
+inline T DragT <T> ::computeSpeedOfSound(const T & altitude) const
 {
    // as the altitude rises the speed of sound
    // decreases, and vice-versa
-   double speedOfSound = soundData.back().output;
+   T speedOfSound = soundData.back().output;
 
    for (int j = 0; j < soundData.size() - 1; j++)
    {
@@ -157,8 +169,6 @@ double Drag::computeSpeedOfSound(const double altitude) const
 				   || (speedOfSound < soundData[j].output && speedOfSound > soundData[j+1].output));
 		 else
 			assert(speedOfSound == 295);
-		 
-		 std::cout << "speedOfSound: " << speedOfSound << std::endl;
 		 break;
 	  }
 	  
@@ -172,14 +182,15 @@ double Drag::computeSpeedOfSound(const double altitude) const
  * which is determined based on
  * velocity and speed of sound.
  * *******************************************/
-double Drag::computeCoefficient(const double velocity,
-								const double speedOfSound) const
+template <class T>
+inline T DragT <T> ::computeCoefficient(const T & velocity,
+								const T & speedOfSound) const
 {
-   double speed = velocity / speedOfSound;
+   T speed = velocity / speedOfSound;
 
    // the ammo's drag coefficient is determined
    // based on the speed the ammo travels
-   double coefficient = coefficientData.back().output;
+   T coefficient = coefficientData.back().output;
 
    for (int k = 0; k < coefficientData.size() - 1; k++)
    {
@@ -202,8 +213,6 @@ double Drag::computeCoefficient(const double velocity,
 		 
 		 assert(coefficient > coefficientData[k].output && coefficient < coefficientData[k+1].output
 				|| coefficient < coefficientData[k].output && coefficient > coefficientData[k+1].output);
-		 
-		 std::cout << "coefficient: " << coefficient << std::endl;
 		 break;
 	  }
 	  
@@ -217,7 +226,8 @@ double Drag::computeCoefficient(const double velocity,
  * value based on known values using
  * the physics process of interpolation
  * *******************************************/
-double Drag::computeMidValue(const double x, const double x1, const double y1,
+template <class T>
+inline T DragT <T> ::computeMidValue(const T & x, const double x1, const double y1,
 					 const double x2, const double y2) const
 {
    assert(x1 >= 0 && y1 >= 0);
@@ -232,14 +242,18 @@ double Drag::computeMidValue(const double x, const double x1, const double y1,
  * for the various environmental factors based
  * on the bullets current location and velocity.
  * *****************************************************/
-void Drag::updateFactors()
+template <class T>
+inline void DragT <T> ::updateFactors()
 {
-   double altitude = pAmmo->getPosition().getMetersY();
-   double velocity = pAmmo->getVelocity().getRateOfChange();
+   ProfileScope scope(Profiler::DRAG);
+   TRACE_SPAN("Drag::updateFactors");
+
+   T altitude = pAmmo->getPosition().getMetersY();
+   T velocity = pAmmo->getVelocity().getRateOfChange();
 
-   double density = computeDensity(altitude);
-   double speedOfSound = computeSpeedOfSound(altitude);
-   double coefficient = computeCoefficient(velocity, speedOfSound);
+   T density = computeDensity(altitude);
+   T speedOfSound = computeSpeedOfSound(altitude);
+   T coefficient = computeCoefficient(velocity, speedOfSound);
 
    computeDrag(coefficient, density);
   }
@@ -249,9 +263,10 @@ void Drag::updateFactors()
  * Does calculations to determine
  * double value for drag.
  * ********************************************/
-void Drag::computeDrag(const double coefficient, const double density)
+template <class T>
+inline void DragT <T> ::computeDrag(const T & coefficient, const T & density)
 {
-   double velocity = pAmmo->getVelocity().getRateOfChange();
+   T velocity = pAmmo->getVelocity().getRateOfChange();
    double area = pAmmo->getArea();
 
    drag = 0.5 * area * coefficient * density * velocity * velocity;
@@ -262,11 +277,12 @@ void Drag::computeDrag(const double coefficient, const double density)
  * Debugging tool to see what is
  * happening with drag values.
  * *******************************************/
-void Drag::displayDrag()
+template <class T>
+inline void DragT <T> ::displayDrag()
 {
   std::cout.precision(2);
   std::cout << std::fixed;
-  std::cout << "Drag Force: " << drag << std::endl;
+  std::cout << "Drag Force: " << getValue(drag) << std::endl;
   getAcceleration().displayPosition("Drag Acceleration");
   std::cout << std::endl;
 
@@ -0,0 +1,158 @@
+/***********************************************************************
+ * Header File:
+ *    Dual : a number that carries its own derivatives
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    Forward-mode automatic differentiation. A Dual<N> is a value and
+ *    the derivatives of that value with respect to N inputs. Seed the
+ *    inputs with variable(), run the same code that runs on doubles,
+ *    and every result knows exactly how it moves with each input: one
+ *    pass instead of a finite difference per input.
+ *
+ *    Comparisons only look at the value, so table lookups and tests
+ *    such as "has it hit the ground" behave exactly as they do with
+ *    doubles.
+ ************************************************************************/
+
+#ifndef dual_h
+#define dual_h
+
+#include <cmath>
+
+/*********************************************
+ * DUAL
+ *********************************************/
+template <int N>
+class Dual
+{
+public:
+   // a constant: none of the inputs move it
+   Dual(double value = 0.0) : value(value)
+   {
+      for (int i = 0; i < N; i++)
+         derivatives[i] = 0.0;
+   }
+
+   // input number i
+   static Dual variable(double value, int i)
+   {
+      Dual dual(value);
+      dual.derivatives[i] = 1.0;
+      return dual;
+   }
+
+   double getValue()               const { return value;          }
+   double getDerivative(int i)     const { return derivatives[i]; }
+   void   setValue(double value)         { this->value = value;   }
+
+   // arithmetic
+   friend Dual operator - (const Dual & rhs)
+   {
+      return rhs.map(-rhs.value, -1.0);
+   }
+   friend Dual operator + (const Dual & lhs, const Dual & rhs)
+   {
+      Dual result(lhs.value + rhs.value);
+      for (int i = 0; i < N; i++)
+         result.derivatives[i] = lhs.derivatives[i] + rhs.derivatives[i];
+      return result;
+   }
+   friend Dual operator - (const Dual & lhs, const Dual & rhs)
+   {
+      Dual result(lhs.value - rhs.value);
+      for (int i = 0; i < N; i++)
+         result.derivatives[i] = lhs.derivatives[i] - rhs.derivatives[i];
+      return result;
+   }
+   friend Dual operator * (const Dual & lhs, const Dual & rhs)
+   {
+      Dual result(lhs.value * rhs.value);
+      for (int i = 0; i < N; i++)
+         result.derivatives[i] = lhs.derivatives[i] * rhs.value + lhs.value * rhs.derivatives[i];
+      return result;
+   }
+   friend Dual operator / (const Dual & lhs, const Dual & rhs)
+   {
+      Dual result(lhs.value / rhs.value);
+      for (int i = 0; i < N; i++)
+         result.derivatives[i] = (lhs.derivatives[i] - result.value * rhs.derivatives[i]) / rhs.value;
+      return result;
+   }
+
+   // with a constant, which saves the derivatives of a Dual(0)
+   friend Dual operator + (const Dual & lhs, double rhs) { Dual result(lhs); result.value += rhs; return result; }
+   friend Dual operator + (double lhs, const Dual & rhs) { return rhs + lhs;         }
+   friend Dual operator - (const Dual & lhs, double rhs) { return lhs + -rhs;        }
+   friend Dual operator - (double lhs, const Dual & rhs) { return -rhs + lhs;        }
+   friend Dual operator * (const Dual & lhs, double rhs) { return lhs.map(lhs.value * rhs, rhs); }
+   friend Dual operator * (double lhs, const Dual & rhs) { return rhs * lhs;         }
+   friend Dual operator / (const Dual & lhs, double rhs) { return lhs.map(lhs.value / rhs, 1.0 / rhs); }
+   friend Dual operator / (double lhs, const Dual & rhs) { return Dual(lhs) / rhs;   }
+
+   Dual & operator += (const Dual & rhs) { return *this = *this + rhs; }
+   Dual & operator -= (const Dual & rhs) { return *this = *this - rhs; }
+   Dual & operator *= (const Dual & rhs) { return *this = *this * rhs; }
+   Dual & operator /= (const Dual & rhs) { return *this = *this / rhs; }
+
+   // comparisons are on the value alone
+   friend bool operator == (const Dual & lhs, const Dual & rhs) { return lhs.value == rhs.value; }
+   friend bool operator != (const Dual & lhs, const Dual & rhs) { return lhs.value != rhs.value; }
+   friend bool operator <  (const Dual & lhs, const Dual & rhs) { return lhs.value <  rhs.value; }
+   friend bool operator >  (const Dual & lhs, const Dual & rhs) { return lhs.value >  rhs.value; }
+   friend bool operator <= (const Dual & lhs, const Dual & rhs) { return lhs.value <= rhs.value; }
+   friend bool operator >= (const Dual & lhs, const Dual & rhs) { return lhs.value >= rhs.value; }
+
+   // the functions the physics needs, found by argument dependent lookup
+   friend Dual sqrt(const Dual & x)
+   {
+      double root = std::sqrt(x.value);
+      return x.map(root, 0.5 / root);
+   }
+   friend Dual pow(const Dual & x, double exponent)
+   {
+      return x.map(std::pow(x.value, exponent), exponent * std::pow(x.value, exponent - 1.0));
+   }
+   friend Dual sin(const Dual & x)  { return x.map(std::sin(x.value),  std::cos(x.value)); }
+   friend Dual cos(const Dual & x)  { return x.map(std::cos(x.value), -std::sin(x.value)); }
+   friend Dual fabs(const Dual & x) { return x.value < 0.0 ? -x : x; }
+   friend Dual atan2(const Dual & y, const Dual & x)
+   {
+      double denominator = x.value * x.value + y.value * y.value;
+      Dual result(std::atan2(y.value, x.value));
+      for (int i = 0; i < N; i++)
+         result.derivatives[i] = (x.value * y.derivatives[i] - y.value * x.derivatives[i]) / denominator;
+      return result;
+   }
+
+private:
+   // f(x) when f'(x) is slope: the chain rule
+   Dual map(double valueNew, double slope) const
+   {
+      Dual result(valueNew);
+      for (int i = 0; i < N; i++)
+         result.derivatives[i] = slope * derivatives[i];
+      return result;
+   }
+
+   double value;
+   double derivatives[N];
+};
+
+/*********************************************
+ * GET VALUE / SET VALUE
+ * So code written for any scalar (double,
+ * float or Dual) can get at the plain number,
+ * or replace it without disturbing the
+ * derivatives
+ *********************************************/
+inline double getValue(double x) { return x; }
+inline void   setValue(double & x, double value) { x = value; }
+inline void   setValue(float  & x, double value) { x = (float)value; }
+
+template <int N>
+inline double getValue(const Dual<N> & x) { return x.getValue(); }
+template <int N>
+inline void   setValue(Dual<N> & x, double value) { x.setValue(value); }
+
+#endif /* dual_h */
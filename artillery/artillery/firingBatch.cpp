@@ -0,0 +1,132 @@
+/***********************************************************************
+ * Source File:
+ *    Firing Batch : firing solutions for many targets at once
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    Sort by range, then solve the chunks in parallel, each warm from
+ *    the target before it
+ ************************************************************************/
+
+#include "firingBatch.h"
+#include "firingSolution.h"
+#include "parallel.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+using namespace std;
+
+/************************************************************************
+ * FIRING BATCH : CONSTRUCTOR
+ *************************************************************************/
+FiringBatch::FiringBatch(const FiringBatchConfig & config) : config(config)
+{
+   assert(config.velocity > 0.0);
+   assert(config.tolerance > 0.0);
+   assert(config.chunk > 0);
+}
+
+/************************************************************************
+ * FIRING BATCH : SOLVE
+ * Nearest first, so the neighbours in a chunk are close in range. A
+ * chunk is a thread's for the whole of it, so the warm start never
+ * crosses threads.
+ *    INPUT  posHowitzer  where we fire from
+ *           targets      where we want to land, anywhere on either side
+ *    OUTPUT              a solution for each target, in the same order
+ *************************************************************************/
+vector <FiringBatchSolution> FiringBatch::solve(const Position & posHowitzer,
+                                                const vector <Position> & targets) const
+{
+   vector <size_t> order(targets.size());
+   for (size_t i = 0; i < order.size(); i++)
+      order[i] = i;
+   double xHowitzer = posHowitzer.getMetersX();
+   sort(order.begin(), order.end(), [&targets, xHowitzer](size_t lhs, size_t rhs)
+   {
+      return fabs(targets[lhs].getMetersX() - xHowitzer) < fabs(targets[rhs].getMetersX() - xHowitzer);
+   });
+
+   vector <FiringBatchSolution> solutions(targets.size());
+   size_t numChunks = (targets.size() + config.chunk - 1) / config.chunk;
+   parallelFor(numChunks, [&](size_t chunk)
+   {
+      size_t begin = chunk * config.chunk;
+      solveChunk(posHowitzer, targets, order, begin, min(begin + config.chunk, order.size()),
+                 solutions);
+   }, config.threads, 1 /*chunk*/);
+   return solutions;
+}
+
+/************************************************************************
+ * FIRING BATCH : SOLVE CHUNK
+ * The first from the branch's usual guess, and each after it from the
+ * last that was solved, moved by its derivative for the change in range.
+ * If that was too flat to get there, from the usual guess after all,
+ * unless the solve found that nothing on the branch lands that close.
+ * Then nothing lands on a target further up and still that close
+ * either, so those after it are not flown at all
+ *************************************************************************/
+void FiringBatch::solveChunk(const Position & posHowitzer, const vector <Position> & targets,
+                             const vector <size_t> & order, size_t begin, size_t end,
+                             vector <FiringBatchSolution> & solutions) const
+{
+   double angleLast = 0.0;   // of the last that was solved, 0 for none yet
+   double rangeLast = 0.0;
+   double rangePerDegreeLast = 0.0;
+   double rangeFlat = 0.0;   // nothing at altitudeFlat or above lands short of this
+   double altitudeFlat = 0.0;
+   for (size_t i = begin; i < end; i++)
+   {
+      const Position & posTarget = targets[order[i]];
+      double dx = posTarget.getMetersX() - posHowitzer.getMetersX();
+      double range = fabs(dx);
+
+      FiringBatchSolution & result = solutions[order[i]];
+      result.shot = { FiringSolution::getColdGuess(config.isHigh), config.velocity,
+                      posHowitzer.getMetersY() };
+      result.direction = dx >= 0.0 ? 1.0 : -1.0;
+      result.sensitivity = Sensitivity();
+      result.simulations = 0;
+      result.solved = false;
+      if (range < config.tolerance ||
+          (range + config.tolerance < rangeFlat && posTarget.getMetersY() >= altitudeFlat))
+         continue;
+
+      // the neighbour may be at another altitude, and from its angle the
+      // round may not clear the hill this one is on: then from the start.
+      // So too if the guess had to be kept on the branch and went astray.
+      // Not if it was out of reach, which no other start changes
+      bool isWarm = angleLast > 0.0 && rangePerDegreeLast != 0.0;
+      bool isClamped = false;
+      bool isRetry = true;
+      for (int attempt = isWarm ? 0 : 1; attempt < 2 && !result.solved && isRetry; attempt++)
+      {
+         result.shot.angle = attempt == 0 ?
+            FiringSolution::getWarmGuess(angleLast, rangeLast, rangePerDegreeLast, range,
+                                         config.isHigh, &isClamped) :
+            FiringSolution::getColdGuess(config.isHigh);
+         FiringSolution solution;
+         solution.setTargetAltitude(posTarget.getMetersY());
+         result.solved = solution.solveAngle(result.shot, range, config.tolerance) &&
+                         (result.shot.angle > 45.0) == config.isHigh;
+         result.simulations += solution.getSimulations();
+         result.sensitivity = solution.getSensitivity();
+         bool isTooClose = solution.getRangeMin() > range + config.tolerance;
+         isRetry = (solution.getFailure() == FiringSolution::TOO_FLAT && !isTooClose) ||
+                   (isClamped && solution.getFailure() == FiringSolution::NO_SETTLE);
+         if (!result.solved && isTooClose)
+         {
+            rangeFlat = solution.getRangeMin();
+            altitudeFlat = posTarget.getMetersY();
+         }
+      }
+      if (result.solved)
+      {
+         angleLast = result.shot.angle;
+         rangeLast = result.sensitivity.range;
+         rangePerDegreeLast = result.sensitivity.rangePerDegree;
+      }
+   }
+}
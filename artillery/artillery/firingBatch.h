@@ -0,0 +1,81 @@
+/***********************************************************************
+ * Header File:
+ *    Firing Batch : firing solutions for many targets at once
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    Every target gets its angle from FiringSolution, with the range
+ *    and its derivatives where it landed. Solved one at a time from
+ *    nothing, most of the flights go on getting near the answer. So the
+ *    targets are put in order of range and cut into chunks, a chunk to
+ *    a thread at a time, and within a chunk each target starts from the
+ *    angle of the one before, moved along its derivative: a close
+ *    neighbour is all but the answer, and most take two or three
+ *    flights. About one in ten on the low branch still takes nine or
+ *    more, where the start is too flat and the solve begins again from
+ *    nothing. A target that no round on the branch comes down that close
+ *    to is carried forward too: those after it, further up and still
+ *    that close, fail without a flight. Results come back in one array,
+ *    in the order the targets were given.
+ ************************************************************************/
+
+#ifndef firingBatch_h
+#define firingBatch_h
+
+#include "position.h"
+#include "firingSolution.h"   // for TOLERANCE
+#include "trajectory.h"       // for Shot and Sensitivity
+#include <cstddef>            // for size_t
+#include <vector>
+
+/*********************************************
+ * FIRING BATCH CONFIG
+ *********************************************/
+struct FiringBatchConfig
+{
+   FiringBatchConfig() : velocity(TRIPLE7_VELOCITY), isHigh(false),
+                         tolerance(FiringSolution::TOLERANCE), threads(0), chunk(64) {}
+
+   double velocity;    // muzzle velocity in meters/second
+   bool isHigh;        // the high branch, over 45 degrees
+   double tolerance;   // meters, of each impact
+   int threads;        // 0 for every core
+   size_t chunk;       // targets a thread solves in a row, each from the last
+};
+
+/*********************************************
+ * FIRING BATCH SOLUTION
+ * How to hit one target
+ *********************************************/
+struct FiringBatchSolution
+{
+   Shot shot;                 // the angle, the velocity and the howitzer's altitude
+   double direction;          // 1 if the target is to the right, -1 to the left
+   Sensitivity sensitivity;   // where it landed, how that moves, and how long it took
+   int simulations;           // flights it took
+   bool solved;               // false if the target is out of reach
+};
+
+/*********************************************
+ * FIRING BATCH
+ *********************************************/
+class FiringBatch
+{
+public:
+   FiringBatch(const FiringBatchConfig & config = FiringBatchConfig());
+
+   // a solution for every target, in the same order. Targets at the
+   // howitzer's own x are not solved
+   std::vector <FiringBatchSolution> solve(const Position & posHowitzer,
+                                           const std::vector <Position> & targets) const;
+
+private:
+   // the targets order[begin] to order[end], each from the one before
+   void solveChunk(const Position & posHowitzer, const std::vector <Position> & targets,
+                   const std::vector <size_t> & order, size_t begin, size_t end,
+                   std::vector <FiringBatchSolution> & solutions) const;
+
+   FiringBatchConfig config;
+};
+
+#endif /* firingBatch_h */
@@ -0,0 +1,143 @@
+/***********************************************************************
+ * Source File:
+ *    Firing Batch Driver : solve every column of many grounds at once
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    firingBatch [--grounds n] [--high 0|1] [--threads n] [--seed n]
+ *    Make a ground and put a target on every column of it, then solve
+ *    them all as a batch, each from its neighbour, and again each on its
+ *    own from the usual guess. Every round of the batch must come down
+ *    through its target's altitude at its target, on the branch asked
+ *    for, and the batch must solve every target the cold solves do. If
+ *    not, the batch is wrong and we fail. Built and run by ctest as the
+ *    "firingBatch" test.
+ ************************************************************************/
+
+#include "firingBatch.h"
+#include "ground.h"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>    // for atof() and srand()
+#include <cstring>    // for strcmp()
+#include <iomanip>
+#include <iostream>
+
+using namespace std;
+
+// the game defines this; we are not the game
+double Position::metersFromPixels = 40.0;
+
+/*********************************
+ * Solve, fly, and report
+ *********************************/
+int main(int argc, char ** argv)
+{
+   FiringBatchConfig config;
+   int grounds = 10;
+   unsigned int seed = 1;
+
+   for (int i = 1; i < argc; i += 2)
+   {
+      if (i + 1 == argc)
+      {
+         cerr << "No value for " << argv[i] << endl;
+         return 1;
+      }
+      double value = atof(argv[i + 1]);
+      if      (strcmp(argv[i], "--grounds") == 0) grounds = (int)value;
+      else if (strcmp(argv[i], "--high")    == 0) config.isHigh = value != 0.0;
+      else if (strcmp(argv[i], "--threads") == 0) config.threads = (int)value;
+      else if (strcmp(argv[i], "--seed")    == 0) seed = (unsigned int)value;
+      else
+      {
+         cerr << "Unknown option " << argv[i] << endl;
+         return 1;
+      }
+   }
+   if (grounds <= 0)
+   {
+      cerr << "There must be at least one ground" << endl;
+      return 1;
+   }
+
+   // each from the usual guess: a chunk of one has no neighbour
+   FiringBatchConfig configCold = config;
+   configCold.chunk = 1;
+   FiringBatch batch(config);
+   FiringBatch batchCold(configCold);
+
+   srand(seed);
+   Viewport viewport(700.0, 500.0, 40.0);   // the same as the game
+   Ground ground(viewport);
+
+   int targets = 0;
+   int solved = 0;
+   int solvedCold = 0;
+   int missed = 0;              // solved cold, but not in the batch
+   int wrong = 0;
+   long simulations = 0;
+   long simulationsCold = 0;
+   double seconds = 0.0;
+   double secondsCold = 0.0;
+   for (int i = 0; i < grounds; i++)
+   {
+      Position posHowitzer(viewport.getUpperRight().getMetersX() * random(0.1, 0.9), 0.0);
+      ground.reset(posHowitzer);
+      vector <Position> positions;
+      for (int column = 0; column < ground.getWidth(); column++)
+      {
+         Position pos(viewport.toMetersX((double)column), 0.0);
+         pos.setMetersY(ground.getElevationMeters(pos));
+         positions.push_back(pos);
+      }
+      targets += (int)positions.size();
+
+      chrono::steady_clock::time_point timeBegin = chrono::steady_clock::now();
+      vector <FiringBatchSolution> solutions = batch.solve(posHowitzer, positions);
+      seconds += chrono::duration<double>(chrono::steady_clock::now() - timeBegin).count();
+      timeBegin = chrono::steady_clock::now();
+      vector <FiringBatchSolution> solutionsCold = batchCold.solve(posHowitzer, positions);
+      secondsCold += chrono::duration<double>(chrono::steady_clock::now() - timeBegin).count();
+
+      for (size_t target = 0; target < positions.size(); target++)
+      {
+         const FiringBatchSolution & solution = solutions[target];
+         simulations += solution.simulations;
+         simulationsCold += solutionsCold[target].simulations;
+         if (solutionsCold[target].solved)
+            solvedCold++;
+         if (!solution.solved)
+         {
+            if (solutionsCold[target].solved)
+               missed++;
+            continue;
+         }
+         solved++;
+
+         // as the batch sees it
+         double range = fabs(positions[target].getMetersX() - posHowitzer.getMetersX());
+         Sensitivity sensitivity = Trajectory::flySensitivityTo(solution.shot,
+                                                                positions[target].getMetersY());
+         double direction = positions[target].getMetersX() >= posHowitzer.getMetersX() ? 1.0 : -1.0;
+         if (!sensitivity.landed || fabs(sensitivity.range - range) > config.tolerance ||
+             (solution.shot.angle > 45.0) != config.isHigh || solution.direction != direction)
+            wrong++;
+      }
+   }
+
+   cout << fixed << setprecision(2)
+        << grounds << " grounds, " << targets << " targets on the "
+        << (config.isHigh ? "high" : "low") << " branch\n"
+        << "batch:  " << solved << " solved, " << seconds * 1000.0 / grounds << "ms and "
+        << (double)simulations / targets << " flights a target\n"
+        << "cold:   " << solvedCold << " solved, " << secondsCold * 1000.0 / grounds << "ms and "
+        << (double)simulationsCold / targets << " flights a target\n";
+   if (wrong != 0 || missed != 0)
+   {
+      cout << wrong << " rounds do not land on their targets, and " << missed
+           << " targets solved cold are not solved in the batch\n";
+      return 1;
+   }
+   return 0;
+}
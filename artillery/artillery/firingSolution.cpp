@@ -0,0 +1,199 @@
+/***********************************************************************
+ * Source File:
+ *    Firing Solution : how to fire to land at a given range
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    Newton's method with the derivatives from Dual numbers. The range
+ *    bends over hard as the angle rises, but it goes very nearly as a
+ *    power of the angle, and of the velocity. So Newton works on their
+ *    logarithms, where the curve is almost straight: a power law would
+ *    be solved in one step. On the high branch it is the angle from the
+ *    vertical the range goes as a power of.
+ ************************************************************************/
+
+#include "firingSolution.h"
+#include <cassert>
+#include <cmath>
+
+using namespace std;
+
+const double MAX_FACTOR = 8.0;      // most an iteration may multiply the angle or velocity by
+const double MIN_ANGLE = 0.1;       // degrees above the horizon
+const double MAX_ANGLE = 89.9;
+const double ANGLE_TOP_FARTHEST = 40.0;   // degrees. Below this the top of a flight only
+                                          // moves out as the angle rises, and up to 45 it
+                                          // never comes back in past where it was here
+
+/************************************************************************
+ * NEWTON FACTOR
+ * What to multiply x by to move the range to the target, if the range
+ * goes as a power of x.
+ *    INPUT  range       where it landed
+ *           target      where we want it to land
+ *           elasticity  d(log range) / d(log x)
+ *************************************************************************/
+static double newtonFactor(double range, double target, double elasticity)
+{
+   double factor = exp(-(log(range) - log(target)) / elasticity);
+   return fmin(fmax(factor, 1.0 / MAX_FACTOR), MAX_FACTOR);
+}
+
+/************************************************************************
+ * FIRING SOLUTION : GET WARM GUESS
+ * For a target not far from the last, all but the answer
+ *    INPUT  angle           that landed at rangeLast, in degrees
+ *           rangePerDegree  there
+ *           range           where we want it to land now
+ *           isHigh          the branch, which the guess stays on
+ *    OUTPUT isClamped       whether it had to be kept on the branch
+ *************************************************************************/
+double FiringSolution::getWarmGuess(double angle, double rangeLast, double rangePerDegree,
+                                    double range, bool isHigh, bool * isClamped)
+{
+   double guess = rangePerDegree != 0.0 ? angle + (range - rangeLast) / rangePerDegree : angle;
+   double angleMin = isHigh ? 45.0 : 1.0;
+   double angleMax = isHigh ? 89.0 : 45.0;
+   if (isClamped != nullptr)
+      *isClamped = guess < angleMin || guess > angleMax;
+   return fmin(fmax(guess, angleMin), angleMax);
+}
+
+/************************************************************************
+ * FIRING SOLUTION : FLY
+ * One flight on Duals, counted and kept
+ *************************************************************************/
+Sensitivity FiringSolution::fly(const Shot & shot)
+{
+   simulations++;
+   sensitivity = Trajectory::flySensitivityTo(shot, isTargetAltitude ? altitudeTarget : shot.altitude);
+   return sensitivity;
+}
+
+/************************************************************************
+ * FIRING SOLUTION : SOLVE ANGLE
+ *    INPUT  shot       how to fire. The angle is the first guess
+ *           range      where we want it to land, in meters
+ *           tolerance  how close is close enough, in meters
+ *    OUTPUT shot       the angle that gets there
+ *************************************************************************/
+bool FiringSolution::solveAngle(Shot & shot, double range, double tolerance)
+{
+   assert(tolerance > 0.0);
+   assert(range > 0.0);
+   simulations = 0;
+   failure = NONE;
+   rangeMin = 0.0;
+   double angleLanded = 0.0;   // the last angle that came down on the target's altitude
+   double angleFlat = 0.0;     // the highest that was too flat to climb to it
+   bool isHighBranch = shot.angle > 45.0;
+   for (int iteration = 0; iteration < MAX_ITERATIONS; iteration++)
+   {
+      Sensitivity sensitivity = fly(shot);
+
+      // too flat to climb to the target's altitude. A steeper round comes
+      // down through it after its top, and on the low branch its top is
+      // further out than this one's: nothing lands short of here
+      if (!sensitivity.landed && !isHighBranch && 0.0 < shot.angle &&
+          shot.angle <= ANGLE_TOP_FARTHEST)
+         rangeMin = fmax(rangeMin, sensitivity.rangeTop);
+
+      // too flat to climb to a target above us: it would hit the hill on
+      // the way up. Bisect back towards the last that landed. If even
+      // the flattest that lands goes too far, there is no low solution,
+      // and nor is there if the target is short of where any can land
+      if (!sensitivity.landed && 0.0 < shot.angle && shot.angle < angleLanded)
+      {
+         angleFlat = shot.angle;
+         if (angleLanded - angleFlat < 0.01 || rangeMin > range + tolerance)
+         {
+            failure = TOO_FLAT;
+            return false;
+         }
+         shot.angle = (angleFlat + angleLanded) / 2.0;
+         continue;
+      }
+      if (!sensitivity.landed || sensitivity.range <= 0.0)
+      {
+         failure = sensitivity.landed ? OUT_OF_REACH : TOO_FLAT;
+         return false;
+      }
+      if (fabs(sensitivity.range - range) <= tolerance)
+         return true;
+      angleLanded = shot.angle;
+
+      // over the top of the curve and still short: out of reach
+      if (sensitivity.range < range &&
+          (isHighBranch ? sensitivity.rangePerDegree >= 0.0 : sensitivity.rangePerDegree <= 0.0))
+      {
+         failure = OUT_OF_REACH;
+         return false;
+      }
+
+      // at the top of the curve the range stops moving with the angle:
+      // the target is out of reach
+      bool isHigh = shot.angle > 45.0;
+      double angleFrom = isHigh ? 90.0 - shot.angle : shot.angle;   // the horizon or the vertical
+      double elasticity = (isHigh ? -1.0 : 1.0) * sensitivity.rangePerDegree * angleFrom / sensitivity.range;
+      if (fabs(elasticity) < 1e-6)
+      {
+         failure = OUT_OF_REACH;
+         return false;
+      }
+
+      angleFrom *= newtonFactor(sensitivity.range, range, elasticity);
+      double angleFlown = shot.angle;
+      shot.angle = isHigh ? 90.0 - angleFrom : angleFrom;
+      shot.angle = fmin(fmax(shot.angle, MIN_ANGLE), MAX_ANGLE);
+      if (shot.angle <= angleFlat)
+         shot.angle = (angleFlat + angleLanded) / 2.0;
+
+      // the flattest or the steepest we fire, and it wants to go further:
+      // the target is too close for this branch
+      if (shot.angle == angleFlown)
+      {
+         failure = OUT_OF_REACH;
+         return false;
+      }
+   }
+   failure = NO_SETTLE;
+   return false;
+}
+
+/************************************************************************
+ * FIRING SOLUTION : SOLVE VELOCITY
+ *    INPUT  shot       how to fire. The velocity is the first guess
+ *           range      where we want it to land, in meters
+ *           tolerance  how close is close enough, in meters
+ *    OUTPUT shot       the velocity that gets there
+ *************************************************************************/
+bool FiringSolution::solveVelocity(Shot & shot, double range, double tolerance)
+{
+   assert(tolerance > 0.0);
+   assert(range > 0.0);
+   simulations = 0;
+   failure = NONE;
+   rangeMin = 0.0;
+   for (int iteration = 0; iteration < MAX_ITERATIONS; iteration++)
+   {
+      Sensitivity sensitivity = fly(shot);
+      if (!sensitivity.landed || sensitivity.range <= 0.0)
+      {
+         failure = sensitivity.landed ? OUT_OF_REACH : TOO_FLAT;
+         return false;
+      }
+      if (fabs(sensitivity.range - range) <= tolerance)
+         return true;
+
+      double elasticity = sensitivity.rangePerVelocity * shot.velocity / sensitivity.range;
+      if (fabs(elasticity) < 1e-6)
+      {
+         failure = OUT_OF_REACH;
+         return false;
+      }
+
+      shot.velocity *= newtonFactor(sensitivity.range, range, elasticity);
+   }
+   failure = NO_SETTLE;
+   return false;
+}
@@ -0,0 +1,102 @@
+/***********************************************************************
+ * Header File:
+ *    Firing Solution : how to fire to land at a given range
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    Newton's method on the range. Each iteration flies one round on
+ *    Dual numbers (Trajectory::flySensitivity), which gives the range
+ *    and its exact derivative together, so a solution usually takes
+ *    two or three flights. Finite differences would need an extra
+ *    flight for every derivative, every iteration.
+ ************************************************************************/
+
+#ifndef firingSolution_h
+#define firingSolution_h
+
+#include "trajectory.h"   // for Shot
+
+/*********************************************
+ * FIRING SOLUTION
+ *********************************************/
+class FiringSolution
+{
+public:
+   FiringSolution() : simulations(0), sensitivity(), failure(NONE), rangeMin(0.0),
+                      isTargetAltitude(false), altitudeTarget(0.0) {}
+
+   // why a solve gave up
+   enum Failure
+   {
+      NONE,
+      TOO_FLAT,       // too flat to climb to the target's altitude: a
+                      // steeper first guess may yet get there, unless
+                      // it is short of getRangeMin()
+      OUT_OF_REACH,   // over the top of the curve and still short
+      NO_SETTLE       // MAX_ITERATIONS went by
+   };
+
+   // land where the round comes down through this altitude, such as on
+   // a target up a hill, rather than at the altitude it was fired from
+   void setTargetAltitude(double altitude)
+   {
+      altitudeTarget = altitude;
+      isTargetAltitude = true;
+   }
+
+   // change shot.angle, starting from the angle it has, until the round
+   // lands within tolerance of range. Start low for the low solution
+   // and high for the high one. False if it cannot get there
+   bool solveAngle(Shot & shot, double range, double tolerance = 0.1);
+
+   // the same, changing the muzzle velocity and keeping the angle
+   bool solveVelocity(Shot & shot, double range, double tolerance = 0.1);
+
+   // how many flights the last solve took
+   int getSimulations() const { return simulations; }
+
+   // why the last solve failed, if it did
+   Failure getFailure() const { return failure; }
+
+   // after a solve on the low branch that was too flat somewhere: no
+   // round on that branch comes down through the target's altitude
+   // short of this. 0 if the last solve learned nothing of the sort
+   double getRangeMin() const { return rangeMin; }
+
+   // the last of them: on a solution, where it landed and how long it took
+   const Sensitivity & getSensitivity() const { return sensitivity; }
+
+   // where to start a solve on the low branch or the high one with
+   // nothing better to go on
+   static double getColdGuess(bool isHigh) { return isHigh ? ANGLE_HIGH : ANGLE_LOW; }
+
+   // where to start from the angle that landed at rangeLast, moved along
+   // its derivative to range and kept on its branch. isClamped says
+   // whether it had to be kept
+   static double getWarmGuess(double angle, double rangeLast, double rangePerDegree,
+                              double range, bool isHigh, bool * isClamped = nullptr);
+
+   static const int MAX_ITERATIONS = 20;
+   static constexpr double ANGLE_LOW = 20.0;    // degrees, the cold guesses
+   static constexpr double ANGLE_HIGH = 70.0;
+
+   // meters. The range still jumps where a step of the flight crosses
+   // an edge in the drag: up to a meter where the round's heading snaps
+   // onto 30 or 45 degrees and so on, and up to two on steep shots that
+   // slow below the slowest speed in the drag table at the top. A target
+   // can fall in such a gap, and at 4m a few steep solves do not settle
+   static constexpr double TOLERANCE = 5.0;
+
+private:
+   // one flight, to the target's altitude
+   Sensitivity fly(const Shot & shot);
+
+   int simulations;
+   Sensitivity sensitivity;
+   Failure failure;
+   double rangeMin;
+   bool isTargetAltitude;   // or the howitzer's
+   double altitudeTarget;
+};
+
+#endif /* firingSolution_h */
@@ -0,0 +1,122 @@
+/***********************************************************************
+ * Source File:
+ *    Firing Solution Driver : aim at targets around the nice angles
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    firingSolution [--width degrees] [--step m]
+ *    For several muzzle velocities, put a target every step meters from
+ *    where a round fired width degrees below 30, 45 and 60 lands to where
+ *    one fired width degrees above them lands, and solve for each one
+ *    on both branches from the usual guesses. An Angle snaps onto these
+ *    angles when it is near them, so this is where a flight that went
+ *    through one would go wrong. Every target must be solved on one
+ *    branch or the other, every solution must land within the tolerance
+ *    of its target, and no solve may run out of iterations. Built and
+ *    run by ctest as the "firingSolution" test.
+ ************************************************************************/
+
+#include "firingSolution.h"
+#include "position.h"
+#include <cmath>
+#include <cstdlib>    // for atof()
+#include <cstring>    // for strcmp()
+#include <iomanip>
+#include <iostream>
+
+using namespace std;
+
+// the game defines this; we are not the game
+double Position::metersFromPixels = 40.0;
+
+const double ANGLES[] = { 30.0, 45.0, 60.0 };                      // degrees
+const double VELOCITIES[] = { 400.0, 600.0, TRIPLE7_VELOCITY };   // meters/second
+
+/************************************************************************
+ * RANGE AT
+ * Where a round fired at this angle lands
+ *************************************************************************/
+static double rangeAt(double angle, double velocity)
+{
+   Trajectory trajectory(false /*isRecording*/);
+   trajectory.fly({ angle, velocity, 0.0 });
+   return trajectory.getImpact().x;
+}
+
+/*********************************
+ * Aim, fly, and report
+ *********************************/
+int main(int argc, char ** argv)
+{
+   double width = 0.5;
+   double step = 0.5;
+
+   for (int i = 1; i < argc; i += 2)
+   {
+      if (i + 1 == argc)
+      {
+         cerr << "No value for " << argv[i] << endl;
+         return 1;
+      }
+      double value = atof(argv[i + 1]);
+      if      (strcmp(argv[i], "--width") == 0) width = value;
+      else if (strcmp(argv[i], "--step")  == 0) step = value;
+      else
+      {
+         cerr << "Unknown option " << argv[i] << endl;
+         return 1;
+      }
+   }
+   if (width <= 0.0 || step <= 0.0)
+   {
+      cerr << "The width and the step must be more than zero" << endl;
+      return 1;
+   }
+
+   int targets = 0;
+   int solved = 0;
+   int unsolved = 0;            // on neither branch
+   int unsettled = 0;           // solves that ran out of iterations
+   int wrong = 0;
+   int simulations = 0;
+   int solves = 0;
+   for (double velocity : VELOCITIES)
+      for (double angle : ANGLES)
+      {
+         double rangeFrom = rangeAt(angle - width, velocity);
+         double rangeTo = rangeAt(angle + width, velocity);
+         for (double range = fmin(rangeFrom, rangeTo); range <= fmax(rangeFrom, rangeTo); range += step)
+         {
+            targets++;
+            bool isSolved = false;
+            for (bool isHigh : { false, true })
+            {
+               FiringSolution solution;
+               Shot shot = { FiringSolution::getColdGuess(isHigh), velocity, 0.0 };
+               bool isSolvedBranch = solution.solveAngle(shot, range, FiringSolution::TOLERANCE);
+               simulations += solution.getSimulations();
+               solves++;
+               if (solution.getFailure() == FiringSolution::NO_SETTLE)
+                  unsettled++;
+               if (!isSolvedBranch)
+                  continue;
+               isSolved = true;
+               if (fabs(rangeAt(shot.angle, velocity) - range) > FiringSolution::TOLERANCE)
+                  wrong++;
+            }
+            (isSolved ? solved : unsolved)++;
+         }
+      }
+
+   cout << fixed << setprecision(2)
+        << targets << " targets within " << width << " degrees of 30, 45 and 60, "
+        << solved << " solved\n"
+        << "flights:  " << (double)simulations / solves << " a solve\n";
+   if (unsolved != 0 || unsettled != 0 || wrong != 0)
+   {
+      cout << unsolved << " targets are not solved on either branch, " << unsettled
+           << " solves do not settle, and " << wrong << " rounds miss\n";
+      return 1;
+   }
+   return 0;
+}
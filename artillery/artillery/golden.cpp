@@ -0,0 +1,172 @@
+/***********************************************************************
+ * Source File:
+ *    Golden : trajectories we know to be right
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    Read, write and compare golden trajectories. The file is text,
+ *    one shot after another:
+ *       shot <name> <angle> <velocity> <altitude> <landed> <count>
+ *       <time> <x> <y> <dx> <dy>            (count of these)
+ *       impact <time> <x> <y> <dx> <dy>
+ ************************************************************************/
+
+#include "golden.h"
+#include <algorithm>  // for min()
+#include <cmath>      // for fabs()
+#include <iomanip>    // for setprecision()
+#include <limits>     // for max_digits10
+
+using namespace std;
+
+/************************************************************************
+ * READ POINT / WRITE POINT
+ * One point of a trajectory
+ *************************************************************************/
+static bool readPoint(istream & in, TrajectoryPoint & point)
+{
+   in >> point.time >> point.x >> point.y >> point.dx >> point.dy;
+   return !in.fail();
+}
+
+static void writePoint(ostream & out, const TrajectoryPoint & point)
+{
+   out << point.time << ' ' << point.x << ' ' << point.y << ' '
+       << point.dx << ' ' << point.dy << '\n';
+}
+
+/************************************************************************
+ * GOLDEN FILE : FIND
+ * The entry with the given name, or NULL if there is none
+ *************************************************************************/
+const GoldenEntry * GoldenFile::find(const string & name) const
+{
+   for (const GoldenEntry & entry : entries)
+      if (entry.name == name)
+         return &entry;
+   return nullptr;
+}
+
+/************************************************************************
+ * GOLDEN FILE : READ
+ * Read every entry. Returns false if the file is not what we expect.
+ *************************************************************************/
+bool GoldenFile::read(istream & in)
+{
+   entries.clear();
+
+   string keyword;
+   while (in >> keyword)
+   {
+      if (keyword != "shot")
+         return false;
+
+      GoldenEntry entry;
+      size_t count;
+      in >> entry.name >> entry.shot.angle >> entry.shot.velocity
+         >> entry.shot.altitude >> entry.landed >> count;
+      if (in.fail())
+         return false;
+
+      entry.points.resize(count);
+      for (size_t i = 0; i < count; i++)
+         if (!readPoint(in, entry.points[i]))
+            return false;
+
+      in >> keyword;
+      if (keyword != "impact" || !readPoint(in, entry.impact))
+         return false;
+
+      entries.push_back(entry);
+   }
+   return true;
+}
+
+/************************************************************************
+ * GOLDEN FILE : WRITE
+ * Every entry, with every digit a double has
+ *************************************************************************/
+bool GoldenFile::write(ostream & out) const
+{
+   out << setprecision(numeric_limits <double>::max_digits10);
+   for (const GoldenEntry & entry : entries)
+   {
+      out << "shot " << entry.name << ' ' << entry.shot.angle << ' '
+          << entry.shot.velocity << ' ' << entry.shot.altitude << ' '
+          << entry.landed << ' ' << entry.points.size() << '\n';
+      for (const TrajectoryPoint & point : entry.points)
+         writePoint(out, point);
+      out << "impact ";
+      writePoint(out, entry.impact);
+   }
+   return !out.fail();
+}
+
+/************************************************************************
+ * CHECK
+ * Is one quantity within its tolerance? If not, say so
+ *************************************************************************/
+static bool check(const char * quantity, double expected, double actual,
+                  double tolerance, const GoldenEntry & entry, double time,
+                  ostream & report)
+{
+   if (fabs(expected - actual) <= tolerance)
+      return true;
+   report << entry.name << ": " << quantity << " at t=" << time
+          << " expected " << expected << " but was " << actual
+          << " (tolerance " << tolerance << ")\n";
+   return false;
+}
+
+/************************************************************************
+ * COMPARE GOLDEN
+ * Compare every step of the flight and where it landed. We stop
+ * describing a shot after a few differences: once it is off, every
+ * step after will be off too.
+ *************************************************************************/
+bool compareGolden(const GoldenEntry & expected, const GoldenEntry & actual,
+                   const GoldenTolerance & tolerance, ostream & report)
+{
+   const int MAX_REPORTED = 3;
+   int differences = 0;
+
+   if (expected.landed != actual.landed)
+   {
+      report << expected.name << ": expected it to " << (expected.landed ? "" : "not ")
+             << "land\n";
+      return false;
+   }
+
+   size_t count = min(expected.points.size(), actual.points.size());
+   for (size_t i = 0; i < count && differences < MAX_REPORTED; i++)
+   {
+      const TrajectoryPoint & e = expected.points[i];
+      const TrajectoryPoint & a = actual.points[i];
+      bool isSame = check("x",  e.x,  a.x,  tolerance.position, expected, e.time, report) &&
+                    check("y",  e.y,  a.y,  tolerance.position, expected, e.time, report) &&
+                    check("dx", e.dx, a.dx, tolerance.velocity, expected, e.time, report) &&
+                    check("dy", e.dy, a.dy, tolerance.velocity, expected, e.time, report);
+      if (!isSame)
+         differences++;
+   }
+
+   // where and when it came down. The impact time covers a round that
+   // takes a step more or less to land
+   if (expected.landed)
+   {
+      if (!check("impact x", expected.impact.x, actual.impact.x,
+                 tolerance.impactRange, expected, expected.impact.time, report))
+         differences++;
+      if (!check("impact time", expected.impact.time, actual.impact.time,
+                 tolerance.impactTime, expected, expected.impact.time, report))
+         differences++;
+   }
+   else if (expected.points.size() != actual.points.size())
+   {
+      report << expected.name << ": expected " << expected.points.size()
+             << " steps but flew " << actual.points.size() << "\n";
+      differences++;
+   }
+
+   return differences == 0;
+}
@@ -0,0 +1,79 @@
+/***********************************************************************
+ * Header File:
+ *    Golden : trajectories we know to be right
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    A catalogue of shots flown once with physics we trust and written
+ *    to a golden file. Every change to Drag or Ammunition flies them
+ *    again and compares, point by point, within a tolerance for each
+ *    quantity. Small differences from reordering floating point math
+ *    are fine; a round landing somewhere else is not.
+ ************************************************************************/
+
+#ifndef golden_h
+#define golden_h
+
+#include "trajectory.h"
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/*********************************************
+ * GOLDEN TOLERANCE
+ * How far off each quantity may be
+ *********************************************/
+struct GoldenTolerance
+{
+   GoldenTolerance() : position(0.1), velocity(0.01), impactRange(0.5), impactTime(0.01) {}
+
+   double position;      // meters, at every step
+   double velocity;      // meters/second, at every step
+   double impactRange;   // meters, where it lands
+   double impactTime;    // seconds, when it lands
+};
+
+/*********************************************
+ * GOLDEN ENTRY
+ * One shot and how it flew
+ *********************************************/
+struct GoldenEntry
+{
+   GoldenEntry() : landed(false) {}
+   GoldenEntry(const std::string & name, const Shot & shot, const Trajectory & trajectory) :
+      name(name), shot(shot), points(trajectory.getPoints()),
+      impact(trajectory.getImpact()), landed(trajectory.hasLanded()) {}
+
+   std::string name;
+   Shot shot;
+   std::vector <TrajectoryPoint> points;
+   TrajectoryPoint impact;
+   bool landed;
+};
+
+/*********************************************
+ * GOLDEN FILE
+ * All the entries, read from or written to
+ * a text file
+ *********************************************/
+class GoldenFile
+{
+public:
+   void add(const GoldenEntry & entry) { entries.push_back(entry); }
+   const GoldenEntry * find(const std::string & name) const;
+   const std::vector <GoldenEntry> & getEntries() const { return entries; }
+
+   bool read(std::istream & in);
+   bool write(std::ostream & out) const;
+
+private:
+   std::vector <GoldenEntry> entries;
+};
+
+// Does the actual flight match the expected one? Every difference is
+// described in the report.
+bool compareGolden(const GoldenEntry & expected, const GoldenEntry & actual,
+                   const GoldenTolerance & tolerance, std::ostream & report);
+
+#endif /* golden_h */
@@ -0,0 +1,132 @@
+/***********************************************************************
+ * Source File:
+ *    Golden Driver : fly the catalogue and compare with the golden file
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    golden [--record] [file]
+ *    Without --record, fly every shot in the catalogue and compare it
+ *    against the golden file, reporting any that differ. With --record,
+ *    fly them and write the golden file instead. Only record after
+ *    convincing yourself the physics is right! Built and run by ctest
+ *    as the "golden" test.
+ ************************************************************************/
+
+#include "golden.h"
+#include "trajectory.h"
+#include <cstring>    // for strcmp()
+#include <fstream>
+#include <iostream>
+
+using namespace std;
+
+#ifndef GOLDEN_FILE
+#define GOLDEN_FILE "golden/trajectories.golden"
+#endif // GOLDEN_FILE
+
+/*********************************************
+ * CATALOGUE
+ * The shots we hold the physics to. They
+ * cover the angles the howitzer can reach,
+ * supersonic and subsonic rounds, and high
+ * altitudes where the air is thin.
+ *********************************************/
+struct CatalogueShot
+{
+   const char * name;
+   Shot shot;
+};
+
+const CatalogueShot CATALOGUE[] =
+{
+   { "flat",           {  5.0, 827.0,    0.0 } },
+   { "low",            { 15.0, 827.0,    0.0 } },
+   { "thirty",         { 30.0, 827.0,    0.0 } },
+   { "forty",          { 40.0, 827.0,    0.0 } },
+   { "fortyFive",      { 45.0, 827.0,    0.0 } },
+   { "fiftyFive",      { 55.0, 827.0,    0.0 } },
+   { "sixty",          { 60.0, 827.0,    0.0 } },
+   { "high",           { 75.0, 827.0,    0.0 } },
+   { "steep",          { 85.0, 827.0,    0.0 } },
+   { "subsonic",       { 45.0, 250.0,    0.0 } },
+   { "transonic",      { 45.0, 400.0,    0.0 } },
+   { "mountain",       { 45.0, 827.0, 3000.0 } },
+   { "mountainHigh",   { 70.0, 827.0, 3000.0 } },
+   { "thinAir",        { 45.0, 600.0, 9000.0 } },
+};
+
+/************************************************
+ * FLY CATALOGUE
+ * Every shot, as a golden file
+ ************************************************/
+GoldenFile flyCatalogue()
+{
+   GoldenFile golden;
+   for (const CatalogueShot & shot : CATALOGUE)
+   {
+      Trajectory trajectory;
+      trajectory.fly(shot.shot);
+      golden.add(GoldenEntry(shot.name, shot.shot, trajectory));
+   }
+   return golden;
+}
+
+/*********************************
+ * Fly the catalogue and compare, or record
+ *********************************/
+int main(int argc, char ** argv)
+{
+   bool isRecord = false;
+   const char * fileName = GOLDEN_FILE;
+   for (int i = 1; i < argc; i++)
+      if (strcmp(argv[i], "--record") == 0)
+         isRecord = true;
+      else
+         fileName = argv[i];
+
+   // firing a round talks to cout; keep ours readable
+   ostream out(cout.rdbuf());
+   cout.rdbuf(nullptr);
+
+   GoldenFile actual = flyCatalogue();
+
+   // write a new golden file
+   if (isRecord)
+   {
+      ofstream fout(fileName);
+      if (fout.fail() || !actual.write(fout))
+      {
+         cerr << "Unable to write " << fileName << endl;
+         return 1;
+      }
+      out << "Recorded " << actual.getEntries().size() << " shots in " << fileName << endl;
+      return 0;
+   }
+
+   // compare with the one we have
+   GoldenFile expected;
+   ifstream fin(fileName);
+   if (fin.fail() || !expected.read(fin))
+   {
+      cerr << "Unable to read " << fileName << ". Record it with --record\n";
+      return 1;
+   }
+
+   GoldenTolerance tolerance;
+   int failed = 0;
+   for (const GoldenEntry & entry : actual.getEntries())
+   {
+      const GoldenEntry * pExpected = expected.find(entry.name);
+      if (pExpected == nullptr)
+      {
+         out << entry.name << ": not in " << fileName << ". Record it with --record\n";
+         failed++;
+      }
+      else if (!compareGolden(*pExpected, entry, tolerance, out))
+         failed++;
+   }
+
+   out << (actual.getEntries().size() - failed) << " of "
+       << actual.getEntries().size() << " shots match" << endl;
+   return failed == 0 ? 0 : 1;
+}
@@ -9,7 +9,11 @@
 
 #include "ground.h"   // for the Ground class definition
 #include "uiDraw.h"   // for random() and drawLine()
+#include "profiler.h" // for ProfileScope
+#include "trace.h"    // for TRACE_SPAN
 #include <cassert>
+#include <cmath>      // for floor() and ceil()
+#include <sstream>    // for the labels
 
 const int WIDTH_HOWITZER = 14;
 
@@ -23,14 +27,20 @@ const double TEXTURE = 3.0;   // size of the small features such as rocks
  * GROUND :: CONSTRUCTOR
  * Set everything up, but do not initialize it yet.
  ************************************************************************/
-Ground::Ground(const Position & posUpperRight) :
-   posUpperRight(posUpperRight),
-   iHowitzer(0),
+Ground::Ground(const Viewport & viewport) :
+   ground(nullptr),
    iTarget(0),
-   ground(nullptr)
+   iHowitzer(0),
+   viewport(viewport)
 {
    // allocate the array
-   ground = new double[(int)posUpperRight.getPixelsX()];
+   ground = new double[(int)viewport.getWidth()];
+}
+
+Ground::Ground(const Position & posUpperRight) :
+   Ground(Viewport(posUpperRight.getPixelsX(), posUpperRight.getPixelsY(),
+                   posUpperRight.getZoom()))
+{
 }
 
 /************************************************************************
@@ -39,14 +49,25 @@ Ground::Ground(const Position & posUpperRight) :
  ************************************************************************/
 double Ground::getElevationMeters(const Position& pos) const
 {
-   Position posImpact(pos);
+   // this is how the game checks for a hit
+   ProfileScope scope(Profiler::COLLIDE);
 
-   if (pos.getPixelsX() >= 0.0 && pos.getPixelsX() < (int)posUpperRight.getPixelsX())
-	  posImpact.setPixelsY(ground[(int)pos.getPixelsX()]);
+   double column = viewport.toPixelsX(pos.getMetersX());
+   if (column >= 0.0 && column < (int)viewport.getWidth())
+	  return ground[(int)column];
    else
-	  posImpact.setPixelsY(0.0);
+	  return 0.0;
+}
 
-   return posImpact.getMetersY();
+/************************************************************************
+ * GROUND :: GET ELEVATIONS
+ * Every column, straight from the array
+ ************************************************************************/
+std::vector <double> Ground::getElevations() const
+{
+   if (ground == nullptr)
+      return std::vector <double> ();
+   return std::vector <double> (ground, ground + getWidth());
 }
 
 /************************************************************************
@@ -55,11 +76,8 @@ double Ground::getElevationMeters(const Position& pos) const
  ************************************************************************/
 Position Ground::getTarget() const
 {
-   assert(iTarget >= 0 && iTarget < posUpperRight.getPixelsX());
-   Position posTarget;
-   posTarget.setPixelsX(iTarget);
-   posTarget.setPixelsY(ground[iTarget]);
-   return posTarget;
+   assert(iTarget >= 0 && iTarget < viewport.getWidth());
+   return Position(viewport.toMetersX(iTarget), ground[iTarget]);
 }
 
 
@@ -69,12 +87,14 @@ Position Ground::getTarget() const
  ************************************************************************/
  void Ground :: reset(Position & posHowitzer)
  {
+   TRACE_SPAN("Ground::reset");
+
    // remember the integer width for later. It will come in handy
-   int width = (int)posUpperRight.getPixelsX();
+   int width = (int)viewport.getWidth();
    assert(width > 0);
 
    // determine the location of the target
-   iHowitzer = (int)(posHowitzer.getPixelsX());
+   iHowitzer = (int)(viewport.toPixelsX(posHowitzer.getMetersX()));
    if (iHowitzer > width / 2)
 	  iTarget = random((int)(width * 0.05), (int)(width * 0.45));
    else
@@ -82,12 +102,14 @@ Position Ground::getTarget() const
    assert(iTarget >= 0 && iTarget < width);
    assert(iHowitzer >= 0 && iHowitzer < width);
 
-   // determine the maximum and minimum altitude
-   Position posMinimum(0.0, MIN_ALTITUDE);
-   Position posMaximum(posUpperRight.getMetersX(), MAX_ALTITUDE);
+   // determine the maximum and minimum altitude. The hills are shaped
+   // in pixels so they look the same at any zoom
+   double yMinimum = viewport.toPixelsY(MIN_ALTITUDE);
+   double yMaximum = viewport.toPixelsY(MAX_ALTITUDE);
 
    // give each location on the ground an elevation
-   ground[0] = posMinimum.getPixelsY(); // the initial elevation is low
+   double y = yMinimum;          // the initial elevation is low
+   ground[0] = viewport.toMetersY(y);
    double dy = MAX_SLOPE / 2.0;  // the initial slope is heavily biased to up
    for (int i = 1; i < width; i++)
    {
@@ -100,8 +122,7 @@ Position Ground::getTarget() const
 	  else
 	  {
 		 // what percentage of the elevation were we at?
-		 double percent = (ground[i - 1] - posMinimum.getPixelsY()) /
-						  (posMaximum.getPixelsY() - posMinimum.getPixelsY());
+		 double percent = (y - yMinimum) / (yMaximum - yMinimum);
 
 		 // set the slope of the ground
 		 dy += (1.0 - percent) * random(0.0, LUMPINESS) +
@@ -112,13 +133,19 @@ Position Ground::getTarget() const
 			dy = -MAX_SLOPE;
 
 		 // determine the elevation according to the slope
-		 ground[i] = ground[i - 1] + dy + random(-TEXTURE, TEXTURE);
-		 assert(ground[i] >= 0.0 && ground[i] <= posUpperRight.getPixelsY());
+		 y += dy + random(-TEXTURE, TEXTURE);
+		 assert(y >= 0.0 && y <= viewport.getHeight());
+		 ground[i] = viewport.toMetersY(y);
 	  }
    }
 
    // set the howitzer's elevation
-   posHowitzer.setPixelsY(ground[iHowitzer]);
+   posHowitzer.setMetersY(ground[iHowitzer]);
+
+   // the terrain will not change until the next reset
+   buildLevels();
+   buildGeometry();
+   geometryView.clear();
 }
 
 /*****************************************************************
@@ -127,62 +154,161 @@ Position Ground::getTarget() const
  ****************************************************************/
 void Ground::draw(ogstream & gout) const
 {
-   // put the meter markers along the side
-   for (Position pos(0.0, 1000.0); pos.getPixelsY() < posUpperRight.getPixelsY(); pos.addMetersY(1000.0))
+   TRACE_SPAN("Ground::draw");
+   const Viewport & view = gout.getViewport();
+
+   // the whole ground as it was made: every column
+   if (view == viewport)
    {
-	  Position posLeft(pos);
-	  Position posRight(pos);
-	  posRight.setPixelsX(posUpperRight.getPixelsX());
-	  gout.drawLine(posLeft, posRight, 0.85, 0.85, 0.85);
+      // the geometry is normally built on reset, but not everyone resets
+      if (geometry.empty())
+         buildGeometry();
+      gout.drawCache(geometry);
    }
 
-   // iterate through the entire ground and draw it all
-   int width = (int)posUpperRight.getPixelsX();
-   for (int i = 0; i < width; i++)
+   // panned or zoomed: only what is on the screen, at the detail it needs.
+   // It is rebuilt only when the camera moves
+   else
    {
-	  Position posBottom;
-	  Position posTop;
-	  posBottom.setPixelsX((double)i);
-	  posTop.setPixelsX((double)i + 1.0);
-	  posTop.setPixelsY(ground[i]);
-	  gout.drawRectangle(posBottom, posTop, 0.6 /*red*/, 0.4 /*green*/, 0.2 /*blue*/);
+      if (levels.empty())
+         buildLevels();
+      if (geometryView.empty() || view != viewGeometry)
+      {
+         buildGeometry(geometryView, view);
+         viewGeometry = view;
+      }
+      gout.drawCache(geometryView);
    }
 
    // draw the target
    Position posTarget = getTarget();
    gout.drawTarget(posTarget);
+}
+
+/*****************************************************************
+ * GROUND :: BUILD LEVELS
+ * A min/max pyramid. Each level has half the entries of the one
+ * below it, each the lowest and the highest of its two children,
+ * so any one entry knows the extent of all the columns under it
+ ****************************************************************/
+void Ground::buildLevels() const
+{
+   int width = getWidth();
+   levels.assign(1, Level());
+   levels[0].lows.assign(ground, ground + width);
+   levels[0].highs.assign(ground, ground + width);
+
+   while (levels.back().lows.size() > 1)
+   {
+      const Level & finer = levels.back();
+      size_t size = (finer.lows.size() + 1) / 2;
+      Level coarser;
+      coarser.lows.resize(size);
+      coarser.highs.resize(size);
+      for (size_t i = 0; i < size; i++)
+      {
+         size_t iRight = min(2 * i + 1, finer.lows.size() - 1);
+         coarser.lows[i]  = min(finer.lows[2 * i],  finer.lows[iRight]);
+         coarser.highs[i] = max(finer.highs[2 * i], finer.highs[iRight]);
+      }
+      levels.push_back(coarser);
+   }
+}
+
+/*****************************************************************
+ * GROUND :: GET LEVEL
+ * The coarsest level whose entries are no wider than a pixel of
+ * the view. Zoomed in, that is the columns themselves
+ ****************************************************************/
+int Ground::getLevel(const Viewport & view) const
+{
+   assert(!levels.empty());
+   double columnsPerPixel = view.getMetersFromPixels() / viewport.getMetersFromPixels();
+   int level = 0;
+   while (level + 1 < (int)levels.size() && (double)(2 << level) <= columnsPerPixel)
+      level++;
+   return level;
+}
+
+/*****************************************************************
+ * GROUND :: BUILD GEOMETRY
+ * Record the ground, the markers, and the labels. This only
+ * needs to happen when the terrain changes
+ ****************************************************************/
+void Ground::buildGeometry() const
+{
+   if (levels.empty())
+      buildLevels();
+   buildGeometry(geometry, viewport);
+}
+
+/*****************************************************************
+ * GROUND :: BUILD GEOMETRY
+ * The same through any view, culled to what is on the screen.
+ * Everything is in meters except the ticks and the labels, which
+ * are so many pixels from what they mark. Where the columns under
+ * a pixel differ, the part only some of them cover is lighter
+ ****************************************************************/
+void Ground::buildGeometry(DrawCache & cache, const Viewport & view) const
+{
+   cache.clear();
+   double left   = view.getBottomLeft().getMetersX();
+   double bottom = view.getBottomLeft().getMetersY();
+   double right  = view.getUpperRight().getMetersX();
+   double top    = view.getUpperRight().getMetersY();
+
+   // the first multiple of step past the edge, but never the origin
+   auto first = [](double step, double edge)
+   {
+      return max(step, ceil(edge / step) * step);
+   };
+
+   // put the meter markers along the side
+   for (double y = first(1000.0, bottom); y < top; y += 1000.0)
+	  cache.addLine(Position(left, y), Position(right, y), 0.85, 0.85, 0.85);
+
+   // the ground, at the level of detail the view calls for
+   int level = getLevel(view);
+   const Level & lod = levels[level];
+   int width = getWidth();
+   int columnLeft  = max(0,     (int)floor(viewport.toPixelsX(left)));
+   int columnRight = min(width, (int)ceil(viewport.toPixelsX(right)));
+   for (int i = columnLeft >> level; (i << level) < columnRight; i++)
+   {
+	  double xLeft  = viewport.toMetersX((double)(i << level));
+	  double xRight = viewport.toMetersX((double)min((i + 1) << level, width));
+	  cache.addRectangle(Position(xLeft, 0.0), Position(xRight, lod.lows[i]),
+	                     0.6 /*red*/, 0.4 /*green*/, 0.2 /*blue*/);
+	  if (lod.highs[i] > lod.lows[i])
+		 cache.addRectangle(Position(xLeft, lod.lows[i]), Position(xRight, lod.highs[i]),
+		                    0.8 /*red*/, 0.7 /*green*/, 0.6 /*blue*/);
+   }
 
    // put the kilometer markers along the bottom
-   for (Position pos(1000.0, 0.0); pos.getPixelsX() < posUpperRight.getPixelsX(); pos.addMetersX(1000.0))
+   for (double x = first(1000.0, left); x < right; x += 1000.0)
    {
-	  Position posBottom(pos);
-	  Position posTop(pos);
-	  posTop.addPixelsY(10);
-	  gout.drawLine(posTop, posBottom, 0.6, 0.6, 0.6);
+	  Position posBottom(x, 0.0);
+	  Position posTop = view.offset(posBottom, 0.0, 10.0);
+	  cache.addLine(posTop, posBottom, 0.6, 0.6, 0.6);
    }
 
    // put the kilometer labels along the bottom
-   for (Position pos(5000.0, 0.0); pos.getPixelsX() < posUpperRight.getPixelsX(); pos.addMetersX(5000.0))
+   for (double x = first(5000.0, left); x < right; x += 5000.0)
    {
-	  Position posText(pos);
-	  posText.addPixelsY(15);
-	  posText.addPixelsX(-10);
+	  Position posText = view.offset(Position(x, 0.0), -10.0, 15.0);
 
-	  gout = posText;
-	  gout << (int)(pos.getMetersX() / 1000.0) << "km";
+	  std::ostringstream sout;
+	  sout << (int)(x / 1000.0) << "km";
+	  cache.addText(posText, sout.str());
    }
 
    // draw the altitude labels along the side
-   for (Position pos(0.0, 2000.0); pos.getPixelsY() < posUpperRight.getPixelsY(); pos.addMetersY(2000.0))
+   for (double y = first(2000.0, bottom); y < top; y += 2000.0)
    {
-	  Position posText(pos);
-	  posText.addPixelsX(5);
-	  posText.addPixelsY(-2);
+	  Position posText = view.offset(Position(left, y), 5.0, -2.0);
 
-	  gout = posText;
-	  gout << (int)(pos.getMetersY()) << "m";
+	  std::ostringstream sout;
+	  sout << (int)y << "m";
+	  cache.addText(posText, sout.str());
    }
 }
- 
-
-
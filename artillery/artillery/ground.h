@@ -12,7 +12,10 @@
 
 #include "position.h"
 #include "uiDraw.h"
+#include "viewport.h"
 #include "constants.h"
+#include <functional>
+#include <vector>
 
 // forward declaration for the Ground unit tests
 class TestGround;
@@ -24,14 +27,18 @@ class TestGround;
 class Ground
 {
 public:
-   // the constructor generates the ground
-   Ground(const Position &posUpperRight);
-   Ground() : ground(nullptr), iHowitzer(0), iTarget(0) {}
+   // the constructor generates the ground, one column for every pixel
+   // across the viewport. The ground starts at 0 meters
+   Ground(const Viewport & viewport);
+   Ground(const Position & posUpperRight);   // in pixels at the zoom Position has
+   Ground() : ground(nullptr), iTarget(0), iHowitzer(0) {}
    
    // reset the game
    void reset(Position & posHowitzer);
 
-   // draw the ground on the screen
+   // draw the ground through the viewport of gout. Zoomed out, columns
+   // too narrow to see are drawn together, so the cost depends on the
+   // size of the screen rather than on the size of the ground
    void draw(ogstream & gout) const;
 
    // determine how high the Point is off the ground
@@ -39,15 +46,66 @@ public:
 
    // where the the target located?
    Position getTarget() const;
+
+   // how many columns of ground there are, one per pixel
+   int getWidth() const { return (int)viewport.getWidth(); }
+
+   // how wide each of them is
+   double getMetersPerColumn() const { return viewport.getMetersFromPixels(); }
+
+   // the elevation of every column, in meters. A copy, so threads may
+   // read it without going through getElevationMeters() and the profiler
+   std::vector <double> getElevations() const;
+
+   // the elevation under x in such a copy, as getElevationMeters() has
+   // it: off the ground it is at sea level
+   static double getElevationAt(const std::vector <double> & elevations,
+                                double metersPerColumn, double x)
+   {
+      double column = x / metersPerColumn;
+      return (column >= 0.0 && column < (double)elevations.size()) ? elevations[(int)column] : 0.0;
+   }
+
+   // the ground down range of xFrom, to the right (direction 1) or the
+   // left (-1), as Trajectory::fly() flies over it. The copy must
+   // outlive it
+   static std::function <double (double)> makeGroundAt(const std::vector <double> & elevations,
+                                                       double metersPerColumn,
+                                                       double xFrom, double direction)
+   {
+      return [&elevations, metersPerColumn, xFrom, direction](double x)
+      {
+         return getElevationAt(elevations, metersPerColumn, xFrom + direction * x);
+      };
+   }
 	
    // unit test access
    friend TestGround;
 
 private:
-   double * ground;               // elevation of the ground, in pixels
-   int iTarget;                   // the location of the target, in pixels
-   int iHowitzer;                 // the location of the howitzer
-   Position posUpperRight;        // size of the screen
+   // every 2^level columns as one, for drawing zoomed out
+   struct Level
+   {
+      std::vector <double> lows;    // the lowest column under each, in meters
+      std::vector <double> highs;   // and the highest
+   };
+
+   // record the ground, grid lines, and labels so draw() is one call
+   void buildGeometry() const;
+   void buildGeometry(DrawCache & cache, const Viewport & view) const;
+
+   // the min/max pyramid of the columns, and which level a view needs
+   void buildLevels() const;
+   int getLevel(const Viewport & view) const;
+
+   double * ground;               // elevation of each column, in meters
+   int iTarget;                   // the column of the target
+   int iHowitzer;                 // the column of the howitzer
+   Viewport viewport;             // the columns and the size of the screen
+   mutable DrawCache geometry;    // everything but the target, built on reset
+   mutable std::vector <Level> levels;  // level 0 is the columns themselves
+   mutable DrawCache geometryView;      // the same through the camera
+   mutable Viewport viewGeometry;       // the view geometryView was built for
 };
 
 #endif /* ground_h */
@@ -0,0 +1,70 @@
+/***********************************************************************
+ * Source File:
+ *    Heatmap : the chance of hitting a target anywhere on the ground
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    Flying the fans. The rest is in heatmapCells.cpp, which needs
+ *    no physics.
+ ************************************************************************/
+
+#include "heatmap.h"
+#include "ground.h"
+#include "parallel.h"
+#include "trace.h"
+#include "trajectory.h"
+#include <cassert>
+
+using namespace std;
+
+/************************************************************************
+ * HIT HEATMAP : COMPUTE
+ * Fly a fan of trajectories to the right of the howitzer and another to
+ * the left, each over the ground it will really cross, then work out
+ * every column from them.
+ *    INPUT  ground       the ground, with the howitzer on it
+ *           posHowitzer  where the howitzer is
+ *************************************************************************/
+void HitHeatmap::compute(const Ground & ground, const Position & posHowitzer)
+{
+   TRACE_SPAN("HitHeatmap::compute");
+   assert(config.angleStep > 0.0);
+   assert(config.angleMax >= config.angleMin);
+
+   elevations = ground.getElevations();
+   metersPerColumn = ground.getMetersPerColumn();
+   double xHowitzer = posHowitzer.getMetersX();
+
+   // the same fan of angles both ways
+   int numAngles = (int)((config.angleMax - config.angleMin) / config.angleStep + 0.5) + 1;
+   vector <FanShot> fans[2];
+   for (vector <FanShot> & fan : fans)
+   {
+      fan.resize(numAngles);
+      for (int k = 0; k < numAngles; k++)
+         fan[k].angle = min(config.angleMin + k * config.angleStep, config.angleMax);
+   }
+
+   // every trajectory, and its faster twin, on its own
+   parallelFor((size_t)(2 * numAngles), [&](size_t i)
+   {
+      int side = (int)(i / numAngles);            // 0 is right, 1 is left
+      double direction = side == 0 ? 1.0 : -1.0;
+      FanShot & shot = fans[side][i % numAngles];
+
+      Trajectory::GroundAt groundAt = Ground::makeGroundAt(elevations, metersPerColumn,
+                                                           xHowitzer, direction);
+      Trajectory trajectory(false /*isRecording*/);
+      trajectory.fly({ shot.angle, config.velocity, posHowitzer.getMetersY() }, groundAt);
+      shot.landed = trajectory.hasLanded();
+      shot.impact = xHowitzer + direction * trajectory.getImpact().x;
+
+      trajectory.fly({ shot.angle, config.velocity + VELOCITY_STEP, posHowitzer.getMetersY() }, groundAt);
+      shot.landed = shot.landed && trajectory.hasLanded();
+      shot.impactFast = xHowitzer + direction * trajectory.getImpact().x;
+   }, config.threads, 4 /*chunk*/);
+
+   computeDeviations(fans[0], config);
+   computeDeviations(fans[1], config);
+   computeCells(fans[0], fans[1], xHowitzer);
+}
@@ -0,0 +1,115 @@
+/***********************************************************************
+ * Header File:
+ *    Heatmap : the chance of hitting a target anywhere on the ground
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    For every column of the ground, how likely is a hit on a target
+ *    there from where the howitzer sits, if the gunner may aim anywhere
+ *    within the budget of elevations? Flying a Dispersion for each of
+ *    700 targets would take minutes, so instead we fly one fan of
+ *    trajectories each way across the real ground, once, and every
+ *    target shares it:
+ *
+ *    - The neighbors in the fan tell how far the impact moves for a
+ *      degree of elevation; one more round, a little faster, tells how
+ *      far it moves for a meter/second of velocity.
+ *    - With small normal errors the impact is then normal too, so the
+ *      chance a round from one aim lands within radius of a target is
+ *      a difference of two normal CDFs.
+ *    - The chance for a target is the best over every aim in the fan.
+ *
+ *    Near the crest of a hill a small error can carry the round over
+ *    it, so there the answer is an estimate; Dispersion is the truth.
+ ************************************************************************/
+
+#ifndef heatmap_h
+#define heatmap_h
+
+#include "position.h"
+#include "constants.h"    // for TRIPLE7_VELOCITY
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+class Ground;
+class ogstream;
+
+/*********************************************
+ * HEATMAP CONFIG
+ * What the gunner may do, and how much the
+ * rounds vary
+ *********************************************/
+struct HeatmapConfig
+{
+   HeatmapConfig() : angleMin(10.0), angleMax(80.0), angleStep(0.25),
+      radius(50.0), velocity(TRIPLE7_VELOCITY),
+      deviationVelocity(2.0), deviationElevation(0.05), threads(0) {}
+
+   double angleMin;             // the aim budget, in degrees above the horizon
+   double angleMax;
+   double angleStep;            // between trajectories in the fan
+   double radius;               // meters. Closer than this to a target hits it
+   double velocity;             // muzzle velocity in meters/second
+   double deviationVelocity;    // standard deviations, as in DispersionConfig
+   double deviationElevation;   // degrees
+   int threads;                 // 0 for every core
+};
+
+/*********************************************
+ * FAN SHOT
+ * One trajectory of the fan
+ *********************************************/
+struct FanShot
+{
+   double angle;        // degrees above the horizon
+   double impact;       // meters across the screen where it landed
+   double impactFast;   // the same, VELOCITY_STEP faster
+   double deviation;    // standard deviation of the impact, in meters
+   bool landed;
+};
+
+/*********************************************
+ * HIT HEATMAP
+ * One byte per column: 0 never, 255 always
+ *********************************************/
+class HitHeatmap
+{
+public:
+   HitHeatmap(const HeatmapConfig & config = HeatmapConfig()) : config(config),
+      metersPerColumn(0.0) {}
+
+   // fly the fans and fill in every column
+   void compute(const Ground & ground, const Position & posHowitzer);
+
+   int getWidth() const { return (int)cells.size(); }
+   double getProbability(int column) const { return cells[column] / 255.0; }
+   const std::vector <uint8_t> & getCells() const { return cells; }
+
+   // a bar over each column, taller and redder the more likely a hit
+   void draw(ogstream & gout) const;
+
+   // column,meters,elevation,probability: one line per column
+   void write(std::ostream & out) const;
+
+   // how far the impact wanders from each aim. Public for testing
+   static void computeDeviations(std::vector <FanShot> & fan, const HeatmapConfig & config);
+
+   // the best chance any aim in the fan has of landing within radius
+   // of the target. Public for testing
+   static double getProbabilityHit(const std::vector <FanShot> & fan,
+                                   double xTarget, double radius);
+
+   static constexpr double VELOCITY_STEP = 1.0;   // meters/second
+
+private:
+   void computeCells(const std::vector <FanShot> & fanRight,
+                     const std::vector <FanShot> & fanLeft, double xHowitzer);
+
+   HeatmapConfig config;
+   std::vector <uint8_t> cells;       // the chance of a hit, in 255ths
+   std::vector <double> elevations;   // of each column, in meters
+   double metersPerColumn;            // how wide the columns of the ground are
+};
+
+#endif /* heatmap_h */
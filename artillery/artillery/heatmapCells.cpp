@@ -0,0 +1,147 @@
+/***********************************************************************
+ * Source File:
+ *    Heatmap Cells : the chance of a hit, column by column
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    Everything about the heatmap that does not fly: the deviations,
+ *    the chance of a hit on each column, and drawing and writing it.
+ ************************************************************************/
+
+#include "heatmap.h"
+#include "parallel.h"
+#include "uiDraw.h"
+#include <cassert>
+#include <cmath>
+
+using namespace std;
+
+/************************************************************************
+ * NORMAL CDF
+ * The chance a standard normal is less than z
+ *************************************************************************/
+static double normalCDF(double z)
+{
+   return 0.5 * erfc(-z / sqrt(2.0));
+}
+
+/************************************************************************
+ * HIT HEATMAP : COMPUTE DEVIATIONS
+ * How far the impact moves for a degree comes from the neighbors in the
+ * fan. Where the round just clears a hill on one side and not the other
+ * the impact jumps, so take the gentler of the two sides.
+ *************************************************************************/
+void HitHeatmap::computeDeviations(vector <FanShot> & fan, const HeatmapConfig & config)
+{
+   for (size_t k = 0; k < fan.size(); k++)
+   {
+      FanShot & shot = fan[k];
+      if (!shot.landed)
+         continue;
+
+      // meters per degree
+      double slope = -1.0;
+      for (size_t neighbor : { k - 1, k + 1 })
+         if (neighbor < fan.size() && fan[neighbor].landed && fan[neighbor].angle != shot.angle)
+         {
+            double slopeNeighbor = fabs((fan[neighbor].impact - shot.impact) /
+                                        (fan[neighbor].angle - shot.angle));
+            if (slope < 0.0 || slopeNeighbor < slope)
+               slope = slopeNeighbor;
+         }
+      slope = max(slope, 0.0);
+
+      // meters per meter/second
+      double slopeVelocity = (shot.impactFast - shot.impact) / VELOCITY_STEP;
+
+      double deviationElevation = slope * config.deviationElevation;
+      double deviationVelocity = slopeVelocity * config.deviationVelocity;
+      shot.deviation = sqrt(deviationElevation * deviationElevation +
+                            deviationVelocity * deviationVelocity);
+   }
+}
+
+/************************************************************************
+ * HIT HEATMAP : GET PROBABILITY HIT
+ *    INPUT  fan      the trajectories, with their deviations
+ *           xTarget  where the target is, in meters across the screen
+ *           radius   how close is a hit
+ *************************************************************************/
+double HitHeatmap::getProbabilityHit(const vector <FanShot> & fan,
+                                     double xTarget, double radius)
+{
+   double best = 0.0;
+   for (const FanShot & shot : fan)
+   {
+      if (!shot.landed)
+         continue;
+      double miss = xTarget - shot.impact;
+
+      // a round that cannot vary either hits or it does not
+      if (shot.deviation < 1e-9)
+      {
+         if (fabs(miss) <= radius)
+            return 1.0;
+         continue;
+      }
+
+      // too far off to matter
+      if (fabs(miss) - radius > 8.0 * shot.deviation)
+         continue;
+
+      double probability = normalCDF((miss + radius) / shot.deviation) -
+                           normalCDF((miss - radius) / shot.deviation);
+      best = max(best, probability);
+   }
+   return best;
+}
+
+/************************************************************************
+ * HIT HEATMAP : COMPUTE CELLS
+ * Each column from the fan on its side of the howitzer
+ *************************************************************************/
+void HitHeatmap::computeCells(const vector <FanShot> & fanRight,
+                              const vector <FanShot> & fanLeft, double xHowitzer)
+{
+   cells.assign(elevations.size(), 0);
+   parallelFor(cells.size(), [&](size_t column)
+   {
+      double xTarget = column * metersPerColumn;
+      const vector <FanShot> & fan = xTarget >= xHowitzer ? fanRight : fanLeft;
+      double probability = getProbabilityHit(fan, xTarget, config.radius);
+      cells[column] = (uint8_t)(probability * 255.0 + 0.5);
+   }, config.threads, 32 /*chunk*/);
+}
+
+/************************************************************************
+ * HIT HEATMAP : DRAW
+ * As an overlay on the ground
+ *************************************************************************/
+void HitHeatmap::draw(ogstream & gout) const
+{
+   const double HEIGHT = 40.0;   // pixels, for a sure hit
+   for (size_t column = 0; column < cells.size(); column++)
+   {
+      if (cells[column] == 0)
+         continue;
+      double probability = cells[column] / 255.0;
+
+      Position posBottom(column * metersPerColumn, elevations[column]);
+      Position posTop = gout.getViewport().offset(posBottom, 0.0, HEIGHT * probability);
+      gout.drawLine(posBottom, posTop, probability, 0.2, 1.0 - probability);
+   }
+}
+
+/************************************************************************
+ * HIT HEATMAP : WRITE
+ * For a spreadsheet
+ *************************************************************************/
+void HitHeatmap::write(ostream & out) const
+{
+   out << "column,meters,elevation,probability\n";
+   for (size_t column = 0; column < cells.size(); column++)
+      out << column << ','
+          << column * metersPerColumn << ','
+          << elevations[column] << ','
+          << cells[column] / 255.0 << '\n';
+}
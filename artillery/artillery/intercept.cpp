@@ -0,0 +1,147 @@
+/***********************************************************************
+ * Source File:
+ *    Intercept : hit a target that is moving
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    Iterate on the time of flight, solving the angle each time
+ ************************************************************************/
+
+#include "intercept.h"
+#include "firingSolution.h"
+#include "targetTrack.h"
+#include <cassert>
+#include <cmath>
+
+using namespace std;
+
+/************************************************************************
+ * INTERCEPT SOLVER : CONSTRUCTOR
+ *************************************************************************/
+InterceptSolver::InterceptSolver(double tolerance, bool isHigh) :
+   tolerance(tolerance), isHigh(isHigh)
+{
+   assert(tolerance > 0.0);
+   reset();
+}
+
+/************************************************************************
+ * INTERCEPT SOLVER : RESET
+ *************************************************************************/
+void InterceptSolver::reset()
+{
+   intercept = Intercept();
+   intercept.shot.angle = FiringSolution::getColdGuess(isHigh);
+   intercept.timeFlight = 0.0;   // as if the target were standing still
+   intercept.solved = false;
+   isWarm = false;
+   rangeLast = 0.0;
+   rangePerDegree = 0.0;
+}
+
+/************************************************************************
+ * INTERCEPT SOLVER : SOLVE
+ * Until the target is where it was when we aimed at it, within the
+ * tolerance: the arrival time has settled.
+ *    INPUT  track        where the target goes
+ *           posHowitzer  where we fire from
+ *           timeFire     when, on the track's clock
+ *           velocity     muzzle velocity in meters/second
+ *************************************************************************/
+bool InterceptSolver::solve(const TargetTrack & track, const Position & posHowitzer,
+                            double timeFire, double velocity)
+{
+   intercept.timeFire = timeFire;
+   intercept.simulations = 0;
+   intercept.solved = false;
+
+   Shot shot = { intercept.shot.angle, velocity, posHowitzer.getMetersY() };
+   double timeFlight = intercept.timeFlight;
+   for (int iteration = 0; iteration < MAX_ITERATIONS; iteration++)
+   {
+      // where the target will be when the round gets there
+      Position posTarget = track.getPosition(timeFire + timeFlight);
+      double dx = posTarget.getMetersX() - posHowitzer.getMetersX();
+      double range = fabs(dx);
+      if (range < tolerance)
+         break;
+
+      // the angle for there, from the last one moved along its derivative
+      if (isWarm)
+         shot.angle = FiringSolution::getWarmGuess(shot.angle, rangeLast, rangePerDegree,
+                                                   range, isHigh);
+      FiringSolution solution;
+      solution.setTargetAltitude(posTarget.getMetersY());
+      bool isSolved = solution.solveAngle(shot, range, tolerance);
+      intercept.simulations += solution.getSimulations();
+
+      // from the last angle the round may not clear the hill the target
+      // has driven up: from the usual guess, as the first solve was
+      if (!isSolved && isWarm && solution.getFailure() == FiringSolution::TOO_FLAT)
+      {
+         shot.angle = FiringSolution::getColdGuess(isHigh);
+         isSolved = solution.solveAngle(shot, range, tolerance);
+         intercept.simulations += solution.getSimulations();
+      }
+      const Sensitivity & sensitivity = solution.getSensitivity();
+
+      // out of reach where we aimed, but the target may have driven into
+      // reach by the time that flight came down: aim there instead
+      if (!isSolved && solution.getFailure() == FiringSolution::OUT_OF_REACH &&
+          computeDistance(track.getPosition(timeFire + sensitivity.time), posTarget) > tolerance)
+      {
+         timeFlight = sensitivity.time;
+         continue;
+      }
+      if (!isSolved || (shot.angle > 45.0) != isHigh)
+         break;
+
+      rangeLast = sensitivity.range;
+      rangePerDegree = sensitivity.rangePerDegree;
+      isWarm = true;
+
+      // has the target stayed put while the time of flight settled?
+      timeFlight = sensitivity.time;
+      Position posArrival = track.getPosition(timeFire + timeFlight);
+      if (computeDistance(posArrival, posTarget) <= tolerance)
+      {
+         intercept.shot = shot;
+         intercept.direction = dx >= 0.0 ? 1.0 : -1.0;
+         intercept.timeFlight = timeFlight;
+         intercept.impact = posTarget;
+         intercept.solved = true;
+         return true;
+      }
+   }
+
+   // out of reach: the next solve starts cold
+   int simulations = intercept.simulations;
+   reset();
+   intercept.timeFire = timeFire;
+   intercept.simulations = simulations;
+   return false;
+}
+
+/************************************************************************
+ * INTERCEPT SOLVER : SOLVE EARLIEST
+ * The first fire time from timeFrom, every timeStep seconds up to
+ * timeTo, that gets a round to the target: for a target that is driving
+ * into range. A try that fails starts the next one cold: until one
+ * gets there, there is no solution to start from
+ *************************************************************************/
+bool InterceptSolver::solveEarliest(const TargetTrack & track, const Position & posHowitzer,
+                                    double timeFrom, double timeTo, double timeStep,
+                                    double velocity)
+{
+   assert(timeStep > 0.0);
+   int simulations = 0;
+   for (double timeFire = timeFrom; timeFire <= timeTo; timeFire += timeStep)
+   {
+      bool isSolved = solve(track, posHowitzer, timeFire, velocity);
+      simulations += intercept.simulations;
+      intercept.simulations = simulations;
+      if (isSolved)
+         return true;
+   }
+   return false;
+}
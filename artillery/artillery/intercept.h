@@ -0,0 +1,84 @@
+/***********************************************************************
+ * Header File:
+ *    Intercept : hit a target that is moving
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    Where to aim so the round gets to where the target will be when
+ *    the round gets there. Guess the time of flight, find where the
+ *    target is by then, solve the angle for that point with
+ *    FiringSolution, and the flight that lands there has a new time of
+ *    flight: go round again until the target stops moving between
+ *    guesses. The round is far faster than the target, so that takes
+ *    two or three turns cold. Where the target is out of reach, the
+ *    flight that fell short or went long still has a time of flight: the
+ *    target may be in reach by then, so go round with that.
+ *
+ *    Every solve starts from the last one: its time of flight, and its
+ *    angle moved along the derivative it had. Re-solved every second as
+ *    the target moves, that is about two flights. If that is too flat
+ *    to clear a hill the target has driven up, it starts cold.
+ ************************************************************************/
+
+#ifndef intercept_h
+#define intercept_h
+
+#include "position.h"
+#include "firingSolution.h"   // for TOLERANCE
+#include "trajectory.h"       // for Shot
+
+class TargetTrack;
+
+/*********************************************
+ * INTERCEPT
+ * How to fire at a moving target
+ *********************************************/
+struct Intercept
+{
+   Shot shot;            // the angle is above the horizon, toward the target
+   double direction;     // 1 if the target is to the right, -1 to the left
+   double timeFire;      // seconds, on the track's clock
+   double timeFlight;    // seconds from the muzzle to the target
+   Position impact;      // where the round and the target meet
+   int simulations;      // flights the solve took
+   bool solved;
+};
+
+/*********************************************
+ * INTERCEPT SOLVER
+ *********************************************/
+class InterceptSolver
+{
+public:
+   // within tolerance meters, on the low branch or the high one
+   InterceptSolver(double tolerance = FiringSolution::TOLERANCE, bool isHigh = false);
+
+   // fire at timeFire (seconds on the track's clock) from the howitzer
+   // so the round meets the target. False if it cannot
+   bool solve(const TargetTrack & track, const Position & posHowitzer, double timeFire,
+              double velocity = TRIPLE7_VELOCITY);
+
+   // the earliest fire time, trying every timeStep seconds from timeFrom
+   // to timeTo, for a target not yet in range. False if there is none
+   bool solveEarliest(const TargetTrack & track, const Position & posHowitzer,
+                      double timeFrom, double timeTo, double timeStep = 1.0,
+                      double velocity = TRIPLE7_VELOCITY);
+
+   // the last solution
+   const Intercept & getIntercept() const { return intercept; }
+
+   // start the next solve from nothing
+   void reset();
+
+   static const int MAX_ITERATIONS = 10;
+
+private:
+   Intercept intercept;
+   double tolerance;
+   bool isHigh;
+   bool isWarm;             // the last solve worked: start from it
+   double rangeLast;        // where the last flight landed
+   double rangePerDegree;   // and how that moved with the angle
+};
+
+#endif /* intercept_h */
@@ -0,0 +1,132 @@
+/***********************************************************************
+ * Source File:
+ *    Intercept Driver : hit targets driving over many grounds
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    intercept [--targets n] [--speed m/s] [--frames n] [--seed n]
+ *    Make a ground for every target and drive the ground's target along
+ *    it, toward the howitzer or away, and solve the intercept once a
+ *    second as it goes, each solve from the last. Every round must come
+ *    down through the target's altitude where the target will be when
+ *    it gets there; if one does not, the solver is wrong and we fail.
+ *    Built and run by ctest as the "intercept" test.
+ *
+ *    A target can drive out of reach, or be out of reach from the start:
+ *    that is reported, not failed.
+ ************************************************************************/
+
+#include "intercept.h"
+#include "ground.h"
+#include "targetTrack.h"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>    // for atof() and srand()
+#include <cstring>    // for strcmp()
+#include <iomanip>
+#include <iostream>
+
+using namespace std;
+
+// the game defines this; we are not the game
+double Position::metersFromPixels = 40.0;
+
+const double DISTANCE_DRIVEN = 5000.0;   // meters, at most, along the ground
+
+/*********************************
+ * Drive, solve, fly, and report
+ *********************************/
+int main(int argc, char ** argv)
+{
+   int targets = 100;
+   double speed = 15.0;
+   int frames = 20;
+   unsigned int seed = 1;
+
+   for (int i = 1; i < argc; i += 2)
+   {
+      if (i + 1 == argc)
+      {
+         cerr << "No value for " << argv[i] << endl;
+         return 1;
+      }
+      double value = atof(argv[i + 1]);
+      if      (strcmp(argv[i], "--targets") == 0) targets = (int)value;
+      else if (strcmp(argv[i], "--speed")   == 0) speed = value;
+      else if (strcmp(argv[i], "--frames")  == 0) frames = (int)value;
+      else if (strcmp(argv[i], "--seed")    == 0) seed = (unsigned int)value;
+      else
+      {
+         cerr << "Unknown option " << argv[i] << endl;
+         return 1;
+      }
+   }
+   if (targets <= 0 || frames <= 0 || speed < 0.0)
+   {
+      cerr << "There must be at least one target and one frame" << endl;
+      return 1;
+   }
+
+   srand(seed);
+   Viewport viewport(700.0, 500.0, 40.0);   // the same as the game
+   Ground ground(viewport);
+   InterceptSolver solver;
+
+   int solves = 0;
+   int solved = 0;
+   int wrong = 0;
+   int simulationsCold = 0;    // the first solve of each target
+   int solvesCold = 0;
+   int simulationsWarm = 0;    // every one after it
+   int solvesWarm = 0;
+   double secondsSolving = 0.0;
+   for (int target = 0; target < targets; target++)
+   {
+      Position posHowitzer(viewport.getUpperRight().getMetersX() * random(0.1, 0.9), 0.0);
+      ground.reset(posHowitzer);
+      double xFrom = ground.getTarget().getMetersX();
+      double xTo = xFrom + random(-DISTANCE_DRIVEN, DISTANCE_DRIVEN);
+      xTo = fmax(0.0, fmin(xTo, viewport.getUpperRight().getMetersX() - 1.0));
+      TargetTrack track = TargetTrack::alongGround(ground, xFrom, xTo, speed);
+
+      // a new target has nothing to do with the last one: start cold
+      solver.reset();
+      for (int frame = 0; frame < frames; frame++)
+      {
+         bool isWarm = frame > 0 && solver.getIntercept().solved;
+         chrono::steady_clock::time_point timeBegin = chrono::steady_clock::now();
+         bool isSolved = solver.solve(track, posHowitzer, (double)frame);
+         secondsSolving += chrono::duration<double>(chrono::steady_clock::now() - timeBegin).count();
+         const Intercept & intercept = solver.getIntercept();
+         solves++;
+         (isWarm ? simulationsWarm : simulationsCold) += intercept.simulations;
+         (isWarm ? solvesWarm : solvesCold)++;
+         if (!isSolved)
+            continue;
+         solved++;
+
+         // where the round comes down through the impact's altitude, and
+         // where the target is by then
+         Sensitivity sensitivity = Trajectory::flySensitivityTo(intercept.shot,
+                                                                intercept.impact.getMetersY());
+         Position posTarget = track.getPosition(intercept.timeFire + sensitivity.time);
+         double xImpact = posHowitzer.getMetersX() + intercept.direction * sensitivity.range;
+         if (!sensitivity.landed ||
+             fabs(xImpact - posTarget.getMetersX()) > 2.0 * FiringSolution::TOLERANCE)
+            wrong++;
+      }
+   }
+
+   cout << fixed << setprecision(2)
+        << targets << " targets at " << speed << "m/s, " << solved << " of "
+        << solves << " solves in reach\n"
+        << "solving:  " << secondsSolving * 1000.0 / solves << "ms a solve\n"
+        << "flights:  " << (double)simulationsCold / max(solvesCold, 1) << " cold, "
+        << (double)simulationsWarm / max(solvesWarm, 1) << " from the last solve\n";
+   if (wrong != 0)
+   {
+      cout << wrong << " rounds miss the target\n";
+      return 1;
+   }
+   return 0;
+}
@@ -0,0 +1,119 @@
+/***********************************************************************
+ * Header File:
+ *    Lock Free : hand data from one thread to another without locks
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    Two containers for exactly one producer thread and exactly one
+ *    consumer thread. Neither side ever waits on the other.
+ *    1. SpscQueue     - a fixed-size ring buffer of items, in order
+ *    2. TripleBuffer  - the newest of a series of snapshots
+ ************************************************************************/
+
+#ifndef lockFree_h
+#define lockFree_h
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>   // for size_t
+
+// keep things written by different threads on different cache lines
+const size_t CACHE_LINE = 64;
+
+/*************************************************************************
+ * SPSC QUEUE
+ * A single-producer single-consumer ring buffer. push() is only called
+ * from the producer and pop() only from the consumer. Capacity must be
+ * a power of two; one slot is kept empty to tell full from empty.
+ *************************************************************************/
+template <class T, size_t CAPACITY>
+class SpscQueue
+{
+public:
+   SpscQueue() : head(0), tail(0)
+   {
+      static_assert((CAPACITY & (CAPACITY - 1)) == 0, "capacity must be a power of two");
+   }
+
+   // producer: add to the back. Returns false, dropping the item, when full
+   bool push(const T & item)
+   {
+      size_t iTail = tail.load(std::memory_order_relaxed);
+      size_t iNext = (iTail + 1) & (CAPACITY - 1);
+      if (iNext == head.load(std::memory_order_acquire))
+         return false;
+      items[iTail] = item;
+      tail.store(iNext, std::memory_order_release);
+      return true;
+   }
+
+   // consumer: take from the front. Returns false when empty
+   bool pop(T & item)
+   {
+      size_t iHead = head.load(std::memory_order_relaxed);
+      if (iHead == tail.load(std::memory_order_acquire))
+         return false;
+      item = items[iHead];
+      head.store((iHead + 1) & (CAPACITY - 1), std::memory_order_release);
+      return true;
+   }
+
+   // either side: a hint, since the other side may be changing it
+   bool empty() const
+   {
+      return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+   }
+
+private:
+   alignas(CACHE_LINE) std::atomic <size_t> head;   // written by the consumer
+   alignas(CACHE_LINE) std::atomic <size_t> tail;   // written by the producer
+   alignas(CACHE_LINE) T items[CAPACITY];
+};
+
+/*************************************************************************
+ * TRIPLE BUFFER
+ * The producer fills the back buffer and publishes it; the consumer
+ * picks up the newest published buffer whenever it likes. The three
+ * buffers rotate so each side always has one to itself and the third
+ * holds the newest finished snapshot. Older snapshots are skipped.
+ *************************************************************************/
+template <class T>
+class TripleBuffer
+{
+public:
+   TripleBuffer() : middle(1), iBack(0), iFront(2) {}
+
+   // producer: the buffer to fill
+   T & getBack() { return buffers[iBack]; }
+
+   // producer: the back buffer is finished, hand it over
+   void publish()
+   {
+      unsigned int old = middle.exchange(iBack | FRESH, std::memory_order_acq_rel);
+      iBack = old & INDEX;
+   }
+
+   // consumer: move to the newest snapshot. Returns false if nothing new
+   bool update()
+   {
+      if (!(middle.load(std::memory_order_relaxed) & FRESH))
+         return false;
+      unsigned int old = middle.exchange(iFront, std::memory_order_acq_rel);
+      iFront = old & INDEX;
+      return true;
+   }
+
+   // consumer: the snapshot to read
+   const T & getFront() const { return buffers[iFront]; }
+
+private:
+   static const unsigned int INDEX = 0x3;   // which buffer is in the middle
+   static const unsigned int FRESH = 0x4;   // published but not yet picked up
+
+   T buffers[3];
+   alignas(CACHE_LINE) std::atomic <unsigned int> middle;
+   alignas(CACHE_LINE) unsigned int iBack;  // only the producer touches this
+   alignas(CACHE_LINE) unsigned int iFront; // only the consumer touches this
+};
+
+#endif /* lockFree_h */
@@ -16,58 +16,60 @@
 #include "angle.h"
 #include <math.h>
 
-class Motion : public Position
+template <class T = double>
+class MotionT : public PositionT <T>
 {
 public:
-	Motion()
+	MotionT()
 	{
-	   setMetersX(0);
-	   setMetersY(0);
+	   this->setMetersX(0);
+	   this->setMetersY(0);
 	}
 
 	// non-default constructor
-	Motion(const double x, const double y)
+	MotionT(const T & x, const T & y)
 	{
-		setMetersX(x);
-		setMetersY(y);
+		this->setMetersX(x);
+		this->setMetersY(y);
 	}
  
 	// adds the force of resistance into motion object's travel path
-	void add(const Motion resistance)
+	void add(const MotionT resistance)
 	{
-		setMetersX(resistance.getMetersX() + getMetersX());
-		setMetersY(resistance.getMetersY() + getMetersY());
+		this->setMetersX(resistance.getMetersX() + this->getMetersX());
+		this->setMetersY(resistance.getMetersY() + this->getMetersY());
 	}
    
 	 
 	// will help calculate velocity and acceleration
-	double getRateOfChange() const { return sqrt(pow(getMetersX(), 2) + pow(getMetersY(), 2)); }
+	T getRateOfChange() const { return sqrt(pow(this->getMetersX(), 2) + pow(this->getMetersY(), 2)); }
  
 	
 	// adjusts the movement of a Motion object
-	void setMovement(const double rate, const Angle angle)
+	void setMovement(const T & rate, const AngleT <T> angle)
 	{
-		setMetersX(cos(angle.getRadians()) * rate);
-		setMetersY(sin(angle.getRadians()) * rate);
+		this->setMetersX(cos(angle.getRadians()) * rate);
+		this->setMetersY(sin(angle.getRadians()) * rate);
 	}
 	
-   Angle getDirection() const;
+   AngleT <T> getDirection() const;
    
 };
 
+typedef MotionT <double> Motion;
+
 /***********************************************************
  * MOTION :: GET DIRECTION
  * Returns the angle that helps determine
  * the direction that a Motion object is traveling
 **********************************************************/
-Angle Motion::getDirection() const {
+template <class T>
+inline AngleT <T> MotionT <T> ::getDirection() const {
 
-  Angle angle;
-  angle.setRadians(atan2(getMetersY(), getMetersX()));
+  AngleT <T> angle;
+  angle.setRadians(atan2(this->getMetersY(), this->getMetersX()));
 
   return angle;
 }
  
 #endif /* motion_h */
-
-#endif /* motion_h */
@@ -0,0 +1,185 @@
+/***********************************************************************
+ * Source File:
+ *    MRSI : multiple rounds, simultaneous impact
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    Solve every charge on both branches, then choose the rounds
+ ************************************************************************/
+
+#include "mrsi.h"
+#include "firingSolution.h"
+#include "ground.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+using namespace std;
+
+const double ANGLE_APART = 0.5;   // the high angle is at least this far above the low
+
+/************************************************************************
+ * MRSI PLANNER : CONSTRUCTOR
+ *************************************************************************/
+MrsiPlanner::MrsiPlanner(const MrsiConfig & config) : config(config)
+{
+   assert(config.rounds > 0);
+   assert(config.interval >= 0.0);
+   assert(!config.velocities.empty());
+   reset();
+}
+
+/************************************************************************
+ * MRSI PLANNER : RESET
+ *************************************************************************/
+void MrsiPlanner::reset()
+{
+   Solved none = { 0.0, 0.0, 0.0 };
+   for (int branch = 0; branch < NUM_BRANCHES; branch++)
+      solvedLast[branch].assign(config.velocities.size(), none);
+}
+
+/************************************************************************
+ * MRSI PLANNER : GET FIRST GUESS
+ * The angle this charge had for the last target if it had one, moved
+ * by the derivative it had there for the change in range: for a target
+ * that has not moved far that is all but the answer. If not, the angle
+ * of the charge before: a slower round has to go higher on the low
+ * branch, and lower on the high one. Without drag the range goes as
+ * v^2 sin(2 angle), so for small angles (and small angles from the
+ * vertical) they scale with the square of the velocity
+ *************************************************************************/
+double MrsiPlanner::getFirstGuess(Branch branch, size_t charge, double angleBefore,
+                                  double range) const
+{
+   const Solved & solved = solvedLast[branch][charge];
+   if (solved.angle > 0.0)
+      return FiringSolution::getWarmGuess(solved.angle, solved.range, solved.rangePerDegree,
+                                          range, branch == HIGH);
+   if (charge == 0 || angleBefore <= 0.0)
+      return FiringSolution::getColdGuess(branch == HIGH);
+
+   double ratio = config.velocities[charge - 1] / config.velocities[charge];
+   ratio *= ratio;
+   if (branch == LOW)
+      return fmin(angleBefore * ratio, 45.0);
+   return fmax(90.0 - (90.0 - angleBefore) * ratio, 45.0);
+}
+
+/************************************************************************
+ * MRSI PLANNER : PLAN
+ * Every charge that reaches, on both branches, is a round we could
+ * fire. Fire the one with the longest flight first; each after it is
+ * the next longest that leaves time to reload, which gets the most
+ * rounds there is room for. A round the real ground would not let land
+ * on the target is no round at all.
+ *    INPUT  range             to the target in meters, either way
+ *           altitudeHowitzer  meters
+ *           altitudeTarget    meters
+ *           groundAt          the ground toward the target, or none for flat
+ *************************************************************************/
+MrsiPlan MrsiPlanner::plan(double range, double altitudeHowitzer, double altitudeTarget,
+                           const Trajectory::GroundAt & groundAt)
+{
+   assert(range > 0.0);
+   MrsiPlan plan;
+   plan.simulations = 0;
+   plan.timeImpact = 0.0;
+
+   // every round that lands on the target
+   vector <Candidate> candidates;
+   double anglesBefore[NUM_BRANCHES] = { 0.0, 0.0 };   // of the charge before
+   for (size_t charge = 0; charge < config.velocities.size(); charge++)
+   {
+      bool isReached = false;
+      for (int branch = 0; branch < NUM_BRANCHES; branch++)
+      {
+         Shot shot = { getFirstGuess((Branch)branch, charge, anglesBefore[branch], range),
+                       config.velocities[charge], altitudeHowitzer };
+         FiringSolution solution;
+         solution.setTargetAltitude(altitudeTarget);
+         bool isSolved = solution.solveAngle(shot, range, config.tolerance);
+         plan.simulations += solution.getSimulations();
+
+         // the high branch may wander down onto the low one. Close to a
+         // target above us there is no low branch: the round would hit
+         // it on the way up
+         if (isSolved && branch == HIGH)
+            isSolved = shot.angle > (solvedLast[LOW][charge].angle > 0.0 ?
+                                     solvedLast[LOW][charge].angle + ANGLE_APART : 45.0);
+
+         const Sensitivity & sensitivity = solution.getSensitivity();
+         Solved solved = { isSolved ? shot.angle : 0.0, sensitivity.range, sensitivity.rangePerDegree };
+         solvedLast[branch][charge] = solved;
+         if (!isSolved)
+            continue;
+         anglesBefore[branch] = shot.angle;
+         isReached = true;
+
+         // over the real ground a hill may stop the round short, and lower
+         // ground behind the target may let a flat one carry past it
+         if (groundAt)
+         {
+            Trajectory trajectory(false /*isRecording*/);
+            trajectory.fly(shot, groundAt);
+            plan.simulations++;
+            if (!trajectory.hasLanded() || fabs(trajectory.getImpact().x - range) > config.radius)
+               continue;
+         }
+         candidates.push_back({ shot, sensitivity.time });
+      }
+
+      // the slower charges will not reach either
+      if (!isReached)
+         break;
+   }
+
+   // the slowest first, then the next that leaves time to reload
+   sort(candidates.begin(), candidates.end(), [](const Candidate & lhs, const Candidate & rhs)
+   {
+      return lhs.timeFlight > rhs.timeFlight;
+   });
+   for (const Candidate & candidate : candidates)
+   {
+      if ((int)plan.rounds.size() == config.rounds)
+         break;
+      if (plan.rounds.empty())
+         plan.timeImpact = candidate.timeFlight;
+      double timeFire = plan.timeImpact - candidate.timeFlight;
+      if (plan.rounds.empty() || timeFire >= plan.rounds.back().timeFire + config.interval)
+         plan.rounds.push_back({ candidate.shot, timeFire, candidate.timeFlight });
+   }
+
+   plan.complete = (int)plan.rounds.size() == config.rounds;
+   return plan;
+}
+
+/************************************************************************
+ * MRSI PLANNER : PLAN
+ * The target the ground was made with, and only the rounds that get
+ * there over it
+ *************************************************************************/
+MrsiPlan MrsiPlanner::plan(const Ground & ground, const Position & posHowitzer)
+{
+   Position posTarget = ground.getTarget();
+   double dx = posTarget.getMetersX() - posHowitzer.getMetersX();
+   vector <double> elevations = ground.getElevations();
+   Trajectory::GroundAt groundAt = Ground::makeGroundAt(elevations, ground.getMetersPerColumn(),
+                                                        posHowitzer.getMetersX(),
+                                                        dx >= 0.0 ? 1.0 : -1.0);
+   return plan(fabs(dx), posHowitzer.getMetersY(), posTarget.getMetersY(), groundAt);
+}
+
+/************************************************************************
+ * MRSI PLANNER : PLAN
+ * One after the other, each warm from the last
+ *************************************************************************/
+vector <MrsiPlan> MrsiPlanner::plan(const vector <Position> & targets, const Position & posHowitzer)
+{
+   vector <MrsiPlan> plans;
+   plans.reserve(targets.size());
+   for (const Position & target : targets)
+      plans.push_back(plan(fabs(target.getMetersX() - posHowitzer.getMetersX()),
+                           posHowitzer.getMetersY(), target.getMetersY()));
+   return plans;
+}
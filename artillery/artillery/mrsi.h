@@ -0,0 +1,129 @@
+/***********************************************************************
+ * Header File:
+ *    MRSI : multiple rounds, simultaneous impact
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    One howitzer puts several rounds on a target at the same moment by
+ *    firing the slowest first. Every charge (muzzle velocity) has a low
+ *    and a high angle that land on the target, each with its own time of
+ *    flight. The plan takes those whose times are far enough apart for
+ *    the gun to reload between them, and fires each so many seconds
+ *    after the first that they all land when the first does.
+ *
+ *    Every angle is found by FiringSolution, starting warm: from the
+ *    charge's angle for the last target, moved along its derivative, or
+ *    else from the angle of the charge before, scaled for the slower
+ *    round. Most take two or three flights, and a target that has only
+ *    moved a little takes about two.
+ *
+ *    The angles are found as if the ground were flat at the target's
+ *    altitude. Given the real ground, every round is flown over it once
+ *    more before it is chosen: one a hill would stop short, or one that
+ *    would carry past the target, is not fired.
+ ************************************************************************/
+
+#ifndef mrsi_h
+#define mrsi_h
+
+#include "position.h"
+#include "firingSolution.h"   // for TOLERANCE
+#include "trajectory.h"       // for Shot
+#include <vector>
+
+class Ground;
+
+/*********************************************
+ * MRSI CONFIG
+ *********************************************/
+struct MrsiConfig
+{
+   MrsiConfig() : rounds(6), interval(4.0), tolerance(FiringSolution::TOLERANCE), radius(50.0)
+   {
+      // the charges, strongest first, in meters/second
+      for (int charge = 0; charge < 8; charge++)
+         velocities.push_back(TRIPLE7_VELOCITY * (1.0 - 0.075 * charge));
+   }
+
+   int rounds;                        // on the target at once
+   double interval;                   // seconds to reload between rounds
+   double tolerance;                  // meters, of each impact
+   double radius;                     // meters. Over the real ground, this close hits
+   std::vector <double> velocities;   // one for each charge, strongest first
+};
+
+/*********************************************
+ * MRSI ROUND
+ * One round of the plan
+ *********************************************/
+struct MrsiRound
+{
+   Shot shot;            // how to fire it
+   double timeFire;      // seconds after the first round
+   double timeFlight;    // seconds from the muzzle to the target
+};
+
+/*********************************************
+ * MRSI PLAN
+ * The rounds in the order they are fired
+ *********************************************/
+struct MrsiPlan
+{
+   std::vector <MrsiRound> rounds;
+   double timeImpact;    // seconds after the first round, for them all
+   int simulations;      // flights it took to plan
+   bool complete;        // as many rounds as were asked for
+};
+
+/*********************************************
+ * MRSI PLANNER
+ *********************************************/
+class MrsiPlanner
+{
+public:
+   MrsiPlanner(const MrsiConfig & config = MrsiConfig());
+
+   // a target so far down range and at this altitude, from a howitzer
+   // at another. The rounds fly over flat ground at the target's altitude,
+   // then over groundAt (meters from the howitzer toward the target) if given
+   MrsiPlan plan(double range, double altitudeHowitzer, double altitudeTarget,
+                 const Trajectory::GroundAt & groundAt = Trajectory::GroundAt());
+
+   // the ground's target, over that ground
+   MrsiPlan plan(const Ground & ground, const Position & posHowitzer);
+
+   // many targets, in order. Each starts from the angles of the last, so
+   // near targets one after another are cheap
+   std::vector <MrsiPlan> plan(const std::vector <Position> & targets,
+                               const Position & posHowitzer);
+
+   // forget the last target's angles
+   void reset();
+
+private:
+   // a charge has a low and a high angle
+   enum Branch { LOW, HIGH, NUM_BRANCHES };
+
+   // a round that would land on the target
+   struct Candidate
+   {
+      Shot shot;
+      double timeFlight;
+   };
+
+   // a charge's solution for the last target
+   struct Solved
+   {
+      double angle;            // 0 if it had none
+      double range;
+      double rangePerDegree;
+   };
+
+   // where to start looking for the angle of this charge
+   double getFirstGuess(Branch branch, size_t charge, double angleBefore, double range) const;
+
+   MrsiConfig config;
+   std::vector <Solved> solvedLast[NUM_BRANCHES];   // per charge
+};
+
+#endif /* mrsi_h */
@@ -0,0 +1,142 @@
+/***********************************************************************
+ * Source File:
+ *    MRSI Driver : plan simultaneous impacts on many grounds
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    mrsi [--targets n] [--rounds n] [--interval s] [--seed n]
+ *    Make a ground for every target and plan an MRSI mission on the
+ *    ground's target. Every round of the plan must come down through
+ *    the target's altitude at the target, when the plan says, and must
+ *    land on the target over the real ground: not stopped short by a
+ *    hill in the way (masked), nor carried past it onto lower ground
+ *    behind. If one does not, the planner is wrong and we fail. Built
+ *    and run by ctest as the "mrsi" test.
+ ************************************************************************/
+
+#include "mrsi.h"
+#include "ground.h"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>    // for atof() and srand()
+#include <cstring>    // for strcmp()
+#include <iomanip>
+#include <iostream>
+
+using namespace std;
+
+// the game defines this; we are not the game
+double Position::metersFromPixels = 40.0;
+
+const double TIME_TOLERANCE = 0.001;   // seconds, for the plan to be right
+
+/*********************************
+ * Plan, fly, and report
+ *********************************/
+int main(int argc, char ** argv)
+{
+   MrsiConfig config;
+   int targets = 100;
+   unsigned int seed = 1;
+
+   for (int i = 1; i + 1 < argc; i += 2)
+   {
+      double value = atof(argv[i + 1]);
+      if      (strcmp(argv[i], "--targets")  == 0) targets = (int)value;
+      else if (strcmp(argv[i], "--rounds")   == 0) config.rounds = (int)value;
+      else if (strcmp(argv[i], "--interval") == 0) config.interval = value;
+      else if (strcmp(argv[i], "--seed")     == 0) seed = (unsigned int)value;
+      else
+      {
+         cerr << "Unknown option " << argv[i] << endl;
+         return 1;
+      }
+   }
+   if (targets <= 0 || config.rounds <= 0)
+   {
+      cerr << "There must be at least one target and one round" << endl;
+      return 1;
+   }
+
+   srand(seed);
+   Viewport viewport(700.0, 500.0, 40.0);   // the same as the game
+   Ground ground(viewport);
+   MrsiPlanner planner(config);
+
+   int complete = 0;
+   int rounds = 0;
+   int onTarget = 0;
+   int masked = 0;
+   int overshot = 0;
+   int wrong = 0;
+   int simulations = 0;
+   double secondsPlanning = 0.0;
+   double spreadWorst = 0.0;      // of the impacts on target, in seconds
+   for (int target = 0; target < targets; target++)
+   {
+      Position posHowitzer(viewport.getUpperRight().getMetersX() * random(0.1, 0.9), 0.0);
+      ground.reset(posHowitzer);
+      Position posTarget = ground.getTarget();
+      double direction = posTarget.getMetersX() > posHowitzer.getMetersX() ? 1.0 : -1.0;
+      double range = fabs(posTarget.getMetersX() - posHowitzer.getMetersX());
+
+      // a new ground has nothing to do with the last one: plan it cold
+      planner.reset();
+      chrono::steady_clock::time_point timeBegin = chrono::steady_clock::now();
+      MrsiPlan plan = planner.plan(ground, posHowitzer);
+      secondsPlanning += chrono::duration<double>(chrono::steady_clock::now() - timeBegin).count();
+      simulations += plan.simulations;
+      if (plan.complete)
+         complete++;
+
+      // and now over the real ground
+      double timeFirst = 1e10;
+      double timeLast = -1e10;
+      for (const MrsiRound & round : plan.rounds)
+      {
+         // as the plan sees it
+         Sensitivity sensitivity = Trajectory::flySensitivityTo(round.shot, posTarget.getMetersY());
+         if (!sensitivity.landed || fabs(sensitivity.range - range) > config.tolerance ||
+             fabs(round.timeFire + sensitivity.time - plan.timeImpact) > TIME_TOLERANCE)
+            wrong++;
+
+         // as it is
+         Trajectory trajectory(false /*isRecording*/);
+         trajectory.fly(round.shot, [&](double x)
+         {
+            return ground.getElevationMeters(Position(posHowitzer.getMetersX() + direction * x, 0.0));
+         });
+         rounds++;
+
+         double miss = trajectory.getImpact().x - range;
+         if (!trajectory.hasLanded() || miss > config.radius)
+            overshot++;
+         else if (miss < -config.radius)
+            masked++;
+         else
+         {
+            onTarget++;
+            double timeImpact = round.timeFire + trajectory.getImpact().time;
+            timeFirst = min(timeFirst, timeImpact);
+            timeLast = max(timeLast, timeImpact);
+         }
+      }
+      if (timeLast >= timeFirst)
+         spreadWorst = max(spreadWorst, timeLast - timeFirst);
+   }
+
+   cout << fixed << setprecision(2)
+        << targets << " targets, " << complete << " with a complete plan of "
+        << config.rounds << " rounds\n"
+        << "planning:  " << secondsPlanning * 1000.0 / targets << "ms and "
+        << (double)simulations / targets << " flights a target\n"
+        << "rounds:    " << rounds << " planned, " << onTarget << " on target, "
+        << masked << " masked by the ground, " << overshot << " past it\n"
+        << "spread:    " << spreadWorst << "s at worst between the first and last on target\n";
+   if (wrong != 0 || masked != 0 || overshot != 0)
+   {
+      cout << wrong + masked + overshot << " rounds do not do what the plan says\n";
+      return 1;
+   }
+   return 0;
+}
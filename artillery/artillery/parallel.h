@@ -0,0 +1,68 @@
+/***********************************************************************
+ * Header File:
+ *    Parallel : spread a loop across the cores
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    parallelFor(count, body) calls body(i) once for every i in
+ *    [0, count), on as many threads as there are cores. The work is
+ *    handed out in small chunks so a thread that gets the easy rounds
+ *    does not sit idle while another finishes the hard ones. body must
+ *    only write to things that belong to its own i.
+ ************************************************************************/
+
+#ifndef parallel_h
+#define parallel_h
+
+#include <algorithm>  // for min()
+#include <atomic>
+#include <cstddef>    // for size_t
+#include <thread>
+#include <vector>
+
+/*************************************************************************
+ * GET NUM THREADS
+ * How many threads to use when asked for 0 (as many as there are cores)
+ *************************************************************************/
+inline int getNumThreads(int threads)
+{
+   if (threads > 0)
+      return threads;
+   int cores = (int)std::thread::hardware_concurrency();
+   return cores > 0 ? cores : 1;
+}
+
+/*************************************************************************
+ * PARALLEL FOR
+ *    INPUT  count     how many times to call body
+ *           body      body(i) does the work for i
+ *           threads   how many threads. 0 means one per core
+ *           chunk     how many i a thread takes at a time
+ *************************************************************************/
+template <class Body>
+void parallelFor(size_t count, Body body, int threads = 0, size_t chunk = 256)
+{
+   threads = getNumThreads(threads);
+   std::atomic <size_t> next(0);
+
+   auto work = [&]()
+   {
+      size_t begin;
+      while ((begin = next.fetch_add(chunk, std::memory_order_relaxed)) < count)
+      {
+         size_t end = std::min(begin + chunk, count);
+         for (size_t i = begin; i < end; i++)
+            body(i);
+      }
+   };
+
+   // this thread works too
+   std::vector <std::thread> workers;
+   for (int i = 1; i < threads && (size_t)i * chunk < count; i++)
+      workers.push_back(std::thread(work));
+   work();
+   for (std::thread & worker : workers)
+      worker.join();
+}
+
+#endif /* parallel_h */
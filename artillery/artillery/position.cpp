@@ -11,7 +11,7 @@
 #include <cassert>
 
 
-Position::Position(double x, double y) : x(0.0), y(0.0)
+Position::Position(double x, double y) : PositionT <double>()
 {
    setMetersX(x);
    setMetersY(y);
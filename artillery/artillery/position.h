@@ -7,11 +7,16 @@
  * Summary:
  *    Everything we need to know about a location on the screen
  *    or the location on the field.
+ *
+ *    The meters are a PositionT of any scalar, so the physics can run
+ *    on floats or Dual numbers as well as on doubles. Position adds the
+ *    pixels, which only mean something for doubles.
  ************************************************************************/
 
 #ifndef position_h
 #define position_h
 
+#include "dual.h"     // for getValue()
 #include <iomanip>
 #include <iostream>
 #include <cmath>
@@ -20,40 +25,78 @@ class TestPosition;
 class Acceleration;
 class Velocity;
 
+/*********************************************
+ * POSITION T
+ * A single position on the field in Meters,
+ * in whatever scalar the physics is using
+ *********************************************/
+template <class T = double>
+class PositionT
+{
+public:
+   // constructors
+   PositionT()                       : x(0.0), y(0.0) {}
+   PositionT(const T & x, const T & y) : x(x),   y(y)   {}
+
+   // getters
+   T getMetersX()       const { return x;                    }
+   T getMetersY()       const { return y;                    }
+
+   // setters
+   void setMetersX(const T & xMeters)       { x = xMeters;           }
+   void setMetersY(const T & yMeters)       { y = yMeters;           }
+   void setMetersXY(const T & xMeters, const T & yMeters) {
+	  x = xMeters;
+	  y = yMeters;
+   }
+
+   // addition
+   void addMetersX(const T & dxMeters)      { setMetersX(getMetersX() + dxMeters);     }
+   void addMetersY(const T & dyMeters)      { setMetersY(getMetersY() + dyMeters);     }
+
+   // display
+   void displayPosition(const char* name) const {
+	   std::cout.precision(2);
+	   std::cout << std::fixed;
+	   std::cout << name << ": (" << getValue(getMetersX()) << ", "
+	             << getValue(getMetersY()) << ")\n";
+	   std::cout.clear();
+   }
+
+protected:
+   T x;                 // horizontal position
+   T y;                 // vertical position
+};
+
 /*********************************************
  * Position
- * A single position on the field in Meters
+ * A single position on the field in Meters,
+ * and where that is on the screen at the one
+ * zoom shared by every Position. Drawing goes
+ * through a Viewport instead, so do not lean
+ * on the pixels here in anything new
  *********************************************/
-class Position
+class Position : public PositionT <double>
 {
 public:
    friend TestPosition;
    
    // constructors
-   Position()            : x(0.0), y(0.0)  {}
+   Position()            : PositionT <double>() {}
    Position(double x, double y);
-   Position(const Position & pt) : x(pt.x), y(pt.y) {}
+   Position(const Position & pt) : PositionT <double>(pt) {}
+   Position(const PositionT <double> & pt) : PositionT <double>(pt) {}
    Position& operator = (const Position& pt);
 
    // getters
-   double getMetersX()       const { return x;                    }
-   double getMetersY()       const { return y;                    }
    double getPixelsX()       const { return x / metersFromPixels; }
    double getPixelsY()       const { return y / metersFromPixels; }
 
    // setters
-   void setMetersX(const double xMeters)       { x = xMeters;           }
-   void setMetersY(const double yMeters)       { y = yMeters;           }
-   void setMetersXY(const double xMeters, const double yMeters) {
-	  x = xMeters;
-	  y = yMeters;
-   }
    void setPixelsX(const double xPixels)       { x = xPixels * metersFromPixels;          }
    void setPixelsY(const double yPixels)       { y = yPixels * metersFromPixels;          }
    
    // addition
-   void addMetersX(const double dxMeters)      { setMetersX(getMetersX() + dxMeters);     }
-   void addMetersY(const double dyMeters)      { setMetersY(getMetersY() + dyMeters);     }
    void addPixelsX(const double dxPixels)      { setPixelsX(getPixelsX() + dxPixels);     }
    void addPixelsY(const double dyPixels)      { setPixelsY(getPixelsY() + dyPixels);     }
  
@@ -64,23 +107,18 @@ public:
    
    double getZoom() const { return metersFromPixels; }
 
-
-   // display
-   void displayPosition(const char* name) const {
-	   std::cout.precision(2);
-	   std::cout << std::fixed;
-	   std::cout << name << ": (" << getMetersX() << ", " << getMetersY() << ")\n";
-	   std::cout.clear();
-   }
-
-protected:
-   double x;                 // horizontal position
-   double y;                 // vertical position
-	
 private:
    static double metersFromPixels;
 };
 
+/*********************************************
+ * POSITION OF
+ * The position for a scalar: doubles get the
+ * one that knows about the screen
+ *********************************************/
+template <class T> struct PositionOf         { typedef PositionT <T> type; };
+template <>        struct PositionOf <double> { typedef Position     type; };
+
 /*********************************************
  * COMPUTE DISTANCE
  * Find the distance between two positions
@@ -0,0 +1,54 @@
+/***********************************************************************
+ * Source File:
+ *    Preview : where the round will go if it is fired now
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    Flying the arcs. The rest is in previewArcs.cpp, which needs
+ *    no physics.
+ ************************************************************************/
+
+#include "preview.h"
+#include "ground.h"
+#include "trajectory.h"
+#include <cmath>
+#include <memory>
+
+using namespace std;
+
+/************************************************************************
+ * TRAJECTORY PREVIEW : SET GROUND
+ * Fly each arc with Trajectory over a copy of the ground, so nothing
+ * here goes through the profiler or changes under us
+ *    INPUT  ground       the ground, with the howitzer on it
+ *           posHowitzer  where the howitzer is
+ *           velocity     muzzle velocity in meters/second
+ *************************************************************************/
+void TrajectoryPreview::setGround(const Ground & ground, const Position & posHowitzer,
+                                  double velocity)
+{
+   double metersPerColumn = ground.getMetersPerColumn();
+   shared_ptr <vector <double>> elevations = make_shared <vector <double>> (ground.getElevations());
+   double xHowitzer = posHowitzer.getMetersX();
+   double altitude = posHowitzer.getMetersY();
+
+   fly = [=](double angle, PreviewArc & arc)
+   {
+      double direction = angle >= 0.0 ? 1.0 : -1.0;
+
+      Trajectory::GroundAt groundAt = Ground::makeGroundAt(*elevations, metersPerColumn,
+                                                           xHowitzer, direction);
+      Trajectory trajectory;
+      trajectory.fly({ 90.0 - fabs(angle), velocity, altitude }, groundAt);
+
+      arc.points.clear();
+      arc.points.reserve(trajectory.getPoints().size());
+      for (const TrajectoryPoint & point : trajectory.getPoints())
+         arc.points.push_back(Position(xHowitzer + direction * point.x, point.y));
+      arc.landed = trajectory.hasLanded();
+      arc.impact = Position(xHowitzer + direction * trajectory.getImpact().x,
+                            trajectory.getImpact().y);
+   };
+
+   clear();
+}
@@ -0,0 +1,114 @@
+/***********************************************************************
+ * Header File:
+ *    Preview : where the round will go if it is fired now
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    While the gunner aims, draw the arc the round would fly and where
+ *    it would land. Arcs are flown by the headless physics and kept per
+ *    quantized angle, so sweeping back over an angle costs nothing.
+ *    Each frame gets a fixed budget of work:
+ *
+ *    - first the arc to the nearest degree, so something shows at once,
+ *    - then, once the aim has been still for a few frames, to the
+ *      nearest tenth and hundredth of a degree,
+ *    - then, with what is left, the whole degrees either side, which is
+ *      where the gunner is likely to go next.
+ ************************************************************************/
+
+#ifndef preview_h
+#define preview_h
+
+#include "position.h"
+#include "constants.h"    // for TRIPLE7_VELOCITY
+#include <chrono>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+class Ground;
+class ogstream;
+
+/*********************************************
+ * PREVIEW CONFIG
+ *********************************************/
+struct PreviewConfig
+{
+   PreviewConfig() : budget(std::chrono::microseconds(500)), idleFrames(3),
+      neighbors(4), maxArcs(1024)
+   {
+      quanta[0] = 1.0;
+      quanta[1] = 0.1;
+      quanta[2] = 0.01;
+   }
+
+   static const int LEVELS = 3;
+   double quanta[LEVELS];                 // degrees, coarsest first
+   std::chrono::microseconds budget;      // of flying each frame
+   int idleFrames;                        // still this long before refining
+   int neighbors;                         // coarse arcs to fly either side
+   size_t maxArcs;                        // at any level, before forgetting
+};
+
+/*********************************************
+ * PREVIEW ARC
+ * One flight, on the field
+ *********************************************/
+struct PreviewArc
+{
+   std::vector <Position> points;   // every step, in meters
+   Position impact;
+   bool landed;
+};
+
+/*********************************************
+ * TRAJECTORY PREVIEW
+ *********************************************/
+class TrajectoryPreview
+{
+public:
+   // fly a round at this angle, in degrees where 0 is straight up and
+   // positive is to the right, the way the howitzer is drawn
+   typedef std::function <void (double angle, PreviewArc & arc)> Fly;
+
+   TrajectoryPreview(const PreviewConfig & config = PreviewConfig()) :
+      config(config), arcShown(NULL), level(-1), framesIdle(0), angle(0.0) {}
+   TrajectoryPreview(const Fly & fly, const PreviewConfig & config = PreviewConfig()) :
+      config(config), fly(fly), arcShown(NULL), level(-1), framesIdle(0), angle(0.0) {}
+
+   // fly over this ground from this howitzer. Forgets every arc
+   void setGround(const Ground & ground, const Position & posHowitzer,
+                  double velocity = TRIPLE7_VELOCITY);
+
+   // where the barrel points now, in radians where 0 is straight up
+   void aim(double radians);
+
+   // spend this frame's budget. Returns how many arcs were flown
+   int update();
+
+   // the finest arc we have for the aim, or NULL if none yet
+   const PreviewArc * getArc() const;
+   int getLevel() const { return level; }   // of getArc(), -1 for none
+
+   // a dotted arc and a cross where it lands
+   void draw(ogstream & gout) const;
+
+   // forget every arc, such as when the ground changes
+   void clear();
+
+private:
+   // the quantized angle, which is what the arcs are kept by
+   long getKey(int level, double angle) const;
+   bool flyIfMissing(int level, long key);
+   void findArc();
+
+   PreviewConfig config;
+   Fly fly;
+   std::unordered_map <long, PreviewArc> arcs[PreviewConfig::LEVELS];
+   const PreviewArc * arcShown;   // the finest we have for the aim
+   int level;                     // which level it came from
+   int framesIdle;                // since the aim last moved
+   double angle;                  // of the aim, in degrees
+};
+
+#endif /* preview_h */
@@ -0,0 +1,164 @@
+/***********************************************************************
+ * Source File:
+ *    Preview Arcs : which arcs to fly, keeping them, and drawing them
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    Everything about the preview that does not fly. The flying is in
+ *    preview.cpp.
+ ************************************************************************/
+
+#include "preview.h"
+#include "uiDraw.h"
+#include <cassert>
+#include <cmath>
+
+using namespace std;
+
+/************************************************************************
+ * TRAJECTORY PREVIEW : AIM
+ * A new aim shows the finest arc we already have for it, and is not
+ * refined until it has been still for a while
+ *************************************************************************/
+void TrajectoryPreview::aim(double radians)
+{
+   double angleNew = radians * 180.0 / PI;
+   const int finest = PreviewConfig::LEVELS - 1;
+   if (getKey(finest, angleNew) != getKey(finest, angle))
+      framesIdle = 0;
+   angle = angleNew;
+   findArc();
+}
+
+/************************************************************************
+ * TRAJECTORY PREVIEW : UPDATE
+ * Fly the arcs we are missing, most wanted first, until the budget for
+ * the frame is spent. The budget is checked between flights, so the
+ * last one may run a little past it, and there is always at least one
+ * flight so the preview keeps up on a slow machine.
+ *************************************************************************/
+int TrajectoryPreview::update()
+{
+   assert(fly);
+   chrono::steady_clock::time_point timeEnd = chrono::steady_clock::now() + config.budget;
+   int flown = 0;
+   auto isTimeLeft = [&]()
+   {
+      return flown == 0 || chrono::steady_clock::now() < timeEnd;
+   };
+   auto want = [&](int level, long key)
+   {
+      if (isTimeLeft() && flyIfMissing(level, key))
+         flown++;
+   };
+
+   // something to show at once
+   want(0, getKey(0, angle));
+
+   // the aim has settled: refine it
+   if (framesIdle >= config.idleFrames)
+      for (int level = 1; level < PreviewConfig::LEVELS; level++)
+         want(level, getKey(level, angle));
+
+   // where the gunner may go next, nearest first
+   long key = getKey(0, angle);
+   for (int i = 1; i <= config.neighbors; i++)
+   {
+      want(0, key + i);
+      want(0, key - i);
+   }
+
+   framesIdle++;
+   findArc();
+   return flown;
+}
+
+/************************************************************************
+ * TRAJECTORY PREVIEW : GET ARC
+ *************************************************************************/
+const PreviewArc * TrajectoryPreview::getArc() const
+{
+   return arcShown;
+}
+
+/************************************************************************
+ * TRAJECTORY PREVIEW : CLEAR
+ *************************************************************************/
+void TrajectoryPreview::clear()
+{
+   for (int level = 0; level < PreviewConfig::LEVELS; level++)
+      arcs[level].clear();
+   findArc();
+}
+
+/************************************************************************
+ * TRAJECTORY PREVIEW : GET KEY
+ * The angle to the nearest quantum of the level, counted in quanta
+ *************************************************************************/
+long TrajectoryPreview::getKey(int level, double angle) const
+{
+   return lround(angle / config.quanta[level]);
+}
+
+/************************************************************************
+ * TRAJECTORY PREVIEW : FLY IF MISSING
+ * Fly the arc for this key unless we have it. A level that has grown
+ * too big is forgotten and starts again. Returns whether it flew
+ *************************************************************************/
+bool TrajectoryPreview::flyIfMissing(int level, long key)
+{
+   unordered_map <long, PreviewArc> & arcsLevel = arcs[level];
+   if (arcsLevel.count(key))
+      return false;
+   if (arcsLevel.size() >= config.maxArcs)
+   {
+      arcsLevel.clear();
+      arcShown = NULL;
+   }
+
+   PreviewArc & arc = arcsLevel[key];
+   fly(key * config.quanta[level], arc);
+   return true;
+}
+
+/************************************************************************
+ * TRAJECTORY PREVIEW : FIND ARC
+ * The finest arc we have for the aim
+ *************************************************************************/
+void TrajectoryPreview::findArc()
+{
+   arcShown = NULL;
+   level = -1;
+   for (int i = PreviewConfig::LEVELS - 1; i >= 0 && arcShown == NULL; i--)
+   {
+      unordered_map <long, PreviewArc>::const_iterator it = arcs[i].find(getKey(i, angle));
+      if (it != arcs[i].end())
+      {
+         arcShown = &it->second;
+         level = i;
+      }
+   }
+}
+
+/************************************************************************
+ * TRAJECTORY PREVIEW : DRAW
+ * Every other step of the arc, which looks dotted, and a small cross
+ * where it lands
+ *************************************************************************/
+void TrajectoryPreview::draw(ogstream & gout) const
+{
+   if (arcShown == NULL)
+      return;
+
+   const vector <Position> & points = arcShown->points;
+   for (size_t i = 1; i < points.size(); i += 2)
+      gout.drawLine(points[i - 1], points[i], 0.5, 0.5, 0.5);
+
+   if (arcShown->landed)
+   {
+      const Viewport & viewport = gout.getViewport();
+      const Position & pos = arcShown->impact;
+      gout.drawLine(viewport.offset(pos, -4.0, -4.0), viewport.offset(pos, 4.0, 4.0), 0.8, 0.0, 0.0);
+      gout.drawLine(viewport.offset(pos, -4.0, 4.0), viewport.offset(pos, 4.0, -4.0), 0.8, 0.0, 0.0);
+   }
+}
@@ -0,0 +1,178 @@
+/***********************************************************************
+ * Source File:
+ *    Profiler : where does the time in a frame go?
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    The rolling histograms, the end of the frame, and the overlay
+ ************************************************************************/
+
+#include "profiler.h"
+#include "uiDraw.h"    // for ogstream
+#include "position.h"
+#include <cassert>
+#include <cmath>       // for log2() and pow()
+#include <iomanip>     // for setw() and setprecision()
+
+using namespace std;
+
+/************************************************************************
+ * HISTOGRAM : CONSTRUCTOR
+ * Nothing recorded yet
+ *************************************************************************/
+Histogram::Histogram() : next(0), count(0)
+{
+   for (int i = 0; i < BUCKETS; i++)
+      counts[i] = 0;
+   for (int i = 0; i < WINDOW; i++)
+      window[i] = 0;
+}
+
+/************************************************************************
+ * HISTOGRAM : GET BUCKET
+ * Bucket 0 is everything under a microsecond. After that each bucket
+ * starts PER_OCTAVE-th of an octave after the one before it.
+ *************************************************************************/
+int Histogram::getBucket(double seconds)
+{
+   double microseconds = seconds * 1000000.0;
+   if (microseconds < 1.0)
+      return 0;
+   int bucket = 1 + (int)(log2(microseconds) * PER_OCTAVE);
+   return min(bucket, BUCKETS - 1);
+}
+
+/************************************************************************
+ * HISTOGRAM : GET VALUE
+ * The middle of the bucket (geometrically), in seconds
+ *************************************************************************/
+double Histogram::getValue(int bucket)
+{
+   assert(0 <= bucket && bucket < BUCKETS);
+   if (bucket == 0)
+      return 0.0000005;
+   return pow(2.0, (bucket - 0.5) / PER_OCTAVE) / 1000000.0;
+}
+
+/************************************************************************
+ * HISTOGRAM : RECORD
+ * Add a frame, taking out the oldest if the window is full
+ *************************************************************************/
+void Histogram::record(double seconds)
+{
+   if (count == WINDOW)
+      counts[window[next]]--;
+   else
+      count++;
+
+   int bucket = getBucket(seconds);
+   counts[bucket]++;
+   window[next] = (unsigned char)bucket;
+   next = (next + 1) % WINDOW;
+}
+
+/************************************************************************
+ * HISTOGRAM : GET PERCENTILE
+ * Walk the buckets until we have passed the given percent of the frames
+ *    INPUT  percent   0 to 100
+ *************************************************************************/
+double Histogram::getPercentile(double percent) const
+{
+   assert(0.0 <= percent && percent <= 100.0);
+   if (count == 0)
+      return 0.0;
+
+   int rank = (int)ceil(percent / 100.0 * count);
+   int sum = 0;
+   for (int bucket = 0; bucket < BUCKETS; bucket++)
+   {
+      sum += counts[bucket];
+      if (sum >= rank && sum > 0)
+         return getValue(bucket);
+   }
+   return getValue(BUCKETS - 1);
+}
+
+/************************************************************************
+ * PROFILER : SET ENABLED
+ * Turn the timing on or off. Anything timed so far this frame is thrown
+ * out so a half-timed frame does not skew the numbers.
+ *************************************************************************/
+void Profiler::setEnabled(bool enabled)
+{
+   for (int phase = 0; phase < NUM_PHASES; phase++)
+      frameTime[phase].store(0, memory_order_relaxed);
+   Profiler::enabled.store(enabled, memory_order_relaxed);
+}
+
+/************************************************************************
+ * PROFILER : END FRAME
+ * File the time each phase took this frame. A phase that never ran this
+ * frame (no projectile in the air, no step due) is left out rather than
+ * counted as taking no time at all.
+ *************************************************************************/
+void Profiler::endFrame()
+{
+   if (!isEnabled())
+      return;
+
+   for (int phase = 0; phase < NUM_PHASES; phase++)
+   {
+      long long nanoseconds = frameTime[phase].exchange(0, memory_order_relaxed);
+      if (nanoseconds > 0)
+         histograms[phase].record(nanoseconds / 1000000000.0);
+   }
+}
+
+/************************************************************************
+ * PROFILER : GET NAME
+ * What to call the phase on the screen
+ *************************************************************************/
+const char * Profiler::getName(Phase phase)
+{
+   switch (phase)
+   {
+      case INPUT:     return "input";
+      case ADVANCE:   return "advance";
+      case DRAG:      return "  drag";
+      case INTEGRATE: return "  integrate";
+      case COLLIDE:   return "  collide";
+      case DRAW:      return "draw";
+      case SWAP:      return "swap";
+      case SLEEP:     return "sleep";
+      default:        return "?";
+   }
+}
+
+/************************************************************************
+ * PROFILER : DRAW
+ * A line per phase: the 50th, 95th and 99th percentile in milliseconds
+ *    INPUT  gout        where to draw it
+ *           posTopLeft  the top-left corner of the overlay
+ *************************************************************************/
+void Profiler::draw(ogstream & gout, const Position & posTopLeft)
+{
+   if (!isEnabled())
+      return;
+
+   gout.setPosition(posTopLeft);
+   gout << "ms         p50    p95    p99\n";
+   gout << fixed << setprecision(2);
+   for (int phase = 0; phase < NUM_PHASES; phase++)
+   {
+      const Histogram & histogram = histograms[phase];
+      gout << left << setw(11) << getName((Phase)phase) << right
+           << setw(5) << histogram.getPercentile(50.0) * 1000.0 << "  "
+           << setw(5) << histogram.getPercentile(95.0) * 1000.0 << "  "
+           << setw(5) << histogram.getPercentile(99.0) * 1000.0 << "\n";
+   }
+   gout.flush();
+}
+
+/***************************************************
+ * STATICS
+ **************************************************/
+atomic <bool>      Profiler::enabled(false);
+thread_local bool  Profiler::isFrameThread(false);
+atomic <long long> Profiler::frameTime[Profiler::NUM_PHASES];
+Histogram          Profiler::histograms[Profiler::NUM_PHASES];
@@ -0,0 +1,141 @@
+/***********************************************************************
+ * Header File:
+ *    Profiler : where does the time in a frame go?
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    Times each phase of a frame (input, advance and its parts, draw,
+ *    swap, and sleep) and keeps the recent frames in a fixed histogram
+ *    per phase so we can report the 50th, 95th and 99th percentiles.
+ *    Wrap a phase in a ProfileScope. When the profiler is turned off,
+ *    a scope costs one load and one branch. Only the threads that run
+ *    the frame are timed: the same physics run by the workers of a
+ *    parallelFor is not part of any frame.
+ ************************************************************************/
+
+#ifndef profiler_h
+#define profiler_h
+
+#include <atomic>
+#include <chrono>
+
+class ogstream;
+class Position;
+class TestProfiler;
+
+/*************************************************************************
+ * HISTOGRAM
+ * The durations of the last WINDOW frames, sorted into buckets four to
+ * an octave starting at one microsecond. Rolling: the oldest frame is
+ * taken out as the newest goes in. Nothing is ever allocated.
+ *************************************************************************/
+class Histogram
+{
+public:
+   Histogram();
+
+   // add the time one frame spent in the phase
+   void record(double seconds);
+
+   // the duration, in seconds, that percent of the recent frames were under
+   double getPercentile(double percent) const;
+   int    getCount() const { return count; }
+
+   friend TestProfiler;
+
+private:
+   static const int BUCKETS = 80;     // 1us to about 0.9s, then everything longer
+   static const int PER_OCTAVE = 4;   // each bucket is 19% wider than the last
+   static const int WINDOW = 120;     // four seconds at 30 fps
+
+   static int    getBucket(double seconds);
+   static double getValue(int bucket);
+
+   unsigned short counts[BUCKETS];    // how many of the window are in each bucket
+   unsigned char  window[WINDOW];     // which bucket each recent frame went into
+   int next;
+   int count;
+};
+
+/*************************************************************************
+ * PROFILER
+ * Everything is static, like the Interface, so any code can time itself
+ * without being handed anything. Scopes count only on the threads that
+ * called setFrameThread(), and are ignored anywhere else; only the
+ * thread drawing the frames calls endFrame() and draw().
+ *************************************************************************/
+class Profiler
+{
+public:
+   enum Phase
+   {
+      INPUT,      // Game::input
+      ADVANCE,    // Game::advance, which includes the three below
+      DRAG,       //    looking up the drag
+      INTEGRATE,  //    moving the projectile
+      COLLIDE,    //    checking against the ground
+      DRAW,       // Game::draw
+      SWAP,       // glutSwapBuffers
+      SLEEP,      // waiting for the time to draw
+      NUM_PHASES
+   };
+
+   static bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+   static void setEnabled(bool enabled);
+   static void toggle() { setEnabled(!isEnabled()); }
+
+   // the calling thread runs the frame, so its scopes count
+   static void setFrameThread() { isFrameThread = true; }
+   static bool isTiming() { return isEnabled() && isFrameThread; }
+
+   // a scope in this phase took this long
+   static void add(Phase phase, std::chrono::steady_clock::duration duration)
+   {
+      frameTime[phase].fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count(),
+                                 std::memory_order_relaxed);
+   }
+
+   // the frame is on the screen: file each phase into its histogram
+   static void endFrame();
+
+   static const Histogram & getHistogram(Phase phase) { return histograms[phase]; }
+   static const char * getName(Phase phase);
+
+   // put the percentiles on the screen, one phase to a line
+   static void draw(ogstream & gout, const Position & posTopLeft);
+
+private:
+   static std::atomic <bool> enabled;
+   static thread_local bool isFrameThread;
+   static std::atomic <long long> frameTime[NUM_PHASES];   // ns so far this frame
+   static Histogram histograms[NUM_PHASES];
+};
+
+/*************************************************************************
+ * PROFILE SCOPE
+ * Time from here to the end of the enclosing block. Scopes in the same
+ * phase add up over the frame, so a phase run by several steps in one
+ * frame counts all of them. On a thread not running the frame it does
+ * nothing.
+ *************************************************************************/
+class ProfileScope
+{
+public:
+   ProfileScope(Profiler::Phase phase) : phase(phase), isTiming(Profiler::isTiming())
+   {
+      if (isTiming)
+         timeBegin = std::chrono::steady_clock::now();
+   }
+   ~ProfileScope()
+   {
+      if (isTiming)
+         Profiler::add(phase, std::chrono::steady_clock::now() - timeBegin);
+   }
+
+private:
+   Profiler::Phase phase;
+   bool isTiming;
+   std::chrono::steady_clock::time_point timeBegin;
+};
+
+#endif /* profiler_h */
@@ -0,0 +1,73 @@
+/***********************************************************************
+ * Header File:
+ *    Random Stream : many independent streams of random numbers
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    random() in uiDraw.h shares one generator across the program,
+ *    so what a round gets depends on who asked before it. A RandomStream
+ *    is made from a seed and a stream number (the round), so round 417
+ *    always sees the same numbers no matter which thread flies it or
+ *    in what order. The stream number is mixed with SplitMix64 into the
+ *    state of a xoshiro256** generator.
+ ************************************************************************/
+
+#ifndef randomStream_h
+#define randomStream_h
+
+#include <cmath>     // for sqrt(), log(), cos()
+#include <cstdint>   // for uint64_t
+
+/*********************************************
+ * RANDOM STREAM
+ *********************************************/
+class RandomStream
+{
+public:
+   RandomStream(uint64_t seed, uint64_t stream)
+   {
+      uint64_t mix = seed ^ (stream * 0xD1B54A32D192ED03ULL);
+      for (int i = 0; i < 4; i++)
+         state[i] = splitMix(mix);
+   }
+
+   // 64 random bits
+   uint64_t next()
+   {
+      uint64_t result = rotate(state[1] * 5, 7) * 9;
+      uint64_t t = state[1] << 17;
+      state[2] ^= state[0];
+      state[3] ^= state[1];
+      state[1] ^= state[2];
+      state[0] ^= state[3];
+      state[2] ^= t;
+      state[3] = rotate(state[3], 45);
+      return result;
+   }
+
+   // uniformly in [0, 1)
+   double uniform() { return (next() >> 11) * (1.0 / 9007199254740992.0); }
+
+   // a standard normal: mean 0, standard deviation 1 (Box-Muller)
+   double normal()
+   {
+      double u1 = 1.0 - uniform();   // (0, 1] so log() is safe
+      double u2 = uniform();
+      return sqrt(-2.0 * log(u1)) * cos(6.283185307179586 * u2);
+   }
+
+private:
+   static uint64_t rotate(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+   static uint64_t splitMix(uint64_t & x)
+   {
+      uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+      z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+      z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+      return z ^ (z >> 31);
+   }
+
+   uint64_t state[4];
+};
+
+#endif /* randomStream_h */
@@ -0,0 +1,124 @@
+/***********************************************************************
+ * Source File:
+ *    Simulation : run the simulation on its own thread
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    The worker thread's loop, and the two ends of the hand-offs
+ *    between it and the OpenGL thread.
+ ************************************************************************/
+
+#include "simulation.h"
+#include "uiInteract.h"   // for Interface
+#include "profiler.h"     // for Profiler
+#include "trace.h"        // for TRACE_SPAN
+#include <cassert>
+#include <chrono>
+
+using namespace std;
+
+/************************************************************************
+ * SIMULATION THREAD : START
+ * Set the worker thread in motion
+ *************************************************************************/
+void SimulationThread::start()
+{
+   assert(stepCallBack != NULL && recordCallBack != NULL);
+   if (isRunning())
+      return;
+
+   running.store(true, memory_order_release);
+   thread = std::thread(&SimulationThread::loop, this);
+}
+
+/************************************************************************
+ * SIMULATION THREAD : STOP
+ * Ask the worker thread to finish its step, then wait for it
+ *************************************************************************/
+void SimulationThread::stop()
+{
+   running.store(false, memory_order_release);
+   if (thread.joinable())
+      thread.join();
+}
+
+/************************************************************************
+ * SIMULATION THREAD : DRAW
+ * Draw the newest snapshot. If nothing new has been published since
+ * last time, we draw the same one again.
+ *************************************************************************/
+chrono::steady_clock::time_point SimulationThread::draw(ogstream & gout)
+{
+   chrono::steady_clock::time_point timeInput;
+   if (snapshots.update())
+      timeInput = snapshots.getFront().timeInput;
+   gout.drawBuffer(snapshots.getFront().buffer);
+
+   Interface ui;
+   ui.drawTimeWarp(gout, snapshots.getFront().timeWarp);
+   return timeInput;
+}
+
+/************************************************************************
+ * SIMULATION THREAD : LOOP
+ * The worker thread. Take one fixed step, record and publish what the
+ * screen should look like, then sleep until the next step is due. If we
+ * fall behind by more than a few steps, we let it go rather than spiral.
+ * Warping, take as many steps as the time warp calls for in most of the
+ * period, and record only the last.
+ *************************************************************************/
+void SimulationThread::loop()
+{
+   // even though this is a local variable, all the members are static.
+   // While we run, only this thread touches the key state.
+   Interface ui;
+
+   const int MAX_STEPS_BEHIND = 8;
+   const double BUDGET = 0.8;         // of the period, while warping
+   chrono::steady_clock::duration period =
+      chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(ui.stepPeriod()));
+   chrono::steady_clock::time_point timeNext = chrono::steady_clock::now();
+
+   TRACE_THREAD("simulation");
+   Profiler::setFrameThread();
+   while (running.load(memory_order_acquire))
+   {
+      // advance the simulation. In real time, exactly one step
+      {
+         TRACE_SPAN("step");
+         TimeWarp & timeWarp = ui.getTimeWarp();
+         chrono::steady_clock::time_point timeStart = chrono::steady_clock::now();
+         timeWarp.begin(ui.stepPeriod(), ui.stepPeriod());
+         while (timeWarp.isStepDue(chrono::duration<double>(chrono::steady_clock::now() - timeStart).count(),
+                                   ui.stepPeriod() * BUDGET))
+         {
+            ui.pollKeyEvents();
+            stepCallBack(&ui, p);
+            timeWarp.step();
+            ui.keyEvent();
+         }
+         timeWarp.end();
+      }
+
+      // record the screen and hand it over. If this snapshot is skipped
+      // for a newer one, its input latency goes unmeasured
+      Snapshot & snapshot = snapshots.getBack();
+      snapshot.buffer.clear();
+      {
+         TRACE_SPAN("record");
+         ogstreamRecord gout(snapshot.buffer, ui.getViewport());
+         gout.setCopyCaches(true);   // the caches may change before it is drawn
+         recordCallBack(&ui, p, gout);
+      }
+      snapshot.timeInput = ui.takeInputTime();
+      snapshot.timeWarp = ui.getTimeWarp().getName();
+      snapshots.publish();
+
+      // wait for the next step
+      timeNext += period;
+      chrono::steady_clock::time_point timeNow = chrono::steady_clock::now();
+      if (timeNow - timeNext > period * MAX_STEPS_BEHIND)
+         timeNext = timeNow;
+      this_thread::sleep_until(timeNext);
+   }
+}
@@ -0,0 +1,71 @@
+/***********************************************************************
+ * Header File:
+ *    Simulation : run the simulation on its own thread
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    The simulation advances in fixed steps on a worker thread. After
+ *    every step it records what the screen should look like into a
+ *    DrawBuffer and publishes it through a triple buffer. The OpenGL
+ *    thread only picks up the newest snapshot and draws it, so heavy
+ *    simulation never eats into the frame. Key presses go the other
+ *    way through the Interface's lock-free key event queue.
+ ************************************************************************/
+
+#ifndef simulation_h
+#define simulation_h
+
+#include "lockFree.h"   // for TripleBuffer
+#include "uiRecord.h"   // for DrawBuffer
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+class Interface;
+
+/*********************************************
+ * SIMULATION THREAD
+ * Owns the worker thread. start() and stop()
+ * and everything else public is called from
+ * the OpenGL thread.
+ *********************************************/
+class SimulationThread
+{
+public:
+   typedef void (*StepCallBack)(const Interface *, void *);
+   typedef void (*RecordCallBack)(const Interface *, void *, ogstream &);
+
+   SimulationThread(StepCallBack stepCallBack, RecordCallBack recordCallBack, void * p) :
+      stepCallBack(stepCallBack), recordCallBack(recordCallBack), p(p), running(false) {}
+   ~SimulationThread() { stop(); }
+
+   // start and stop the worker thread
+   void start();
+   void stop();
+   bool isRunning() const { return running.load(std::memory_order_acquire); }
+
+   // draw the newest snapshot the simulation has published. Returns
+   // the time of the oldest key event it responds to, if any
+   std::chrono::steady_clock::time_point draw(ogstream & gout);
+
+private:
+   // what the screen looks like after one step
+   struct Snapshot
+   {
+      DrawBuffer buffer;
+      std::chrono::steady_clock::time_point timeInput;
+      const char * timeWarp = NULL;   // how fast, from TimeWarp::getName()
+   };
+
+   void loop();          // the worker thread
+
+   StepCallBack   stepCallBack;
+   RecordCallBack recordCallBack;
+   void *         p;
+
+   std::thread          thread;
+   std::atomic <bool>   running;
+   TripleBuffer <Snapshot> snapshots;     // simulation -> OpenGL thread
+};
+
+#endif /* simulation_h */
@@ -0,0 +1,127 @@
+/***********************************************************************
+ * Source File:
+ *    Target Track : where a moving target is at any time
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    Straight lines between the points of the track
+ ************************************************************************/
+
+#include "targetTrack.h"
+#include "ground.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+using namespace std;
+
+/************************************************************************
+ * TARGET TRACK : CONSTRUCTOR
+ * Standing still
+ *************************************************************************/
+TargetTrack::TargetTrack(const Position & pos) :
+   points(1, pos), times(1, 0.0), dxAfter(0.0), dyAfter(0.0)
+{
+}
+
+/************************************************************************
+ * TARGET TRACK : CONSTRUCTOR
+ * At a constant velocity
+ *************************************************************************/
+TargetTrack::TargetTrack(const Position & pos, double dx, double dy) :
+   points(1, pos), times(1, 0.0), dxAfter(dx), dyAfter(dy)
+{
+}
+
+/************************************************************************
+ * TARGET TRACK : CONSTRUCTOR
+ * Through waypoints. The time at each is how long the distance to it
+ * takes at the speed
+ *************************************************************************/
+TargetTrack::TargetTrack(const vector <Position> & waypoints, double speed) :
+   points(waypoints), dxAfter(0.0), dyAfter(0.0)
+{
+   assert(!waypoints.empty());
+   assert(speed > 0.0);
+   times.reserve(points.size());
+   times.push_back(0.0);
+   for (size_t i = 1; i < points.size(); i++)
+      times.push_back(times.back() + computeDistance(points[i - 1], points[i]) / speed);
+}
+
+/************************************************************************
+ * TARGET TRACK : ALONG GROUND
+ * A waypoint on every column of the ground between the two, so the
+ * target goes up and down the hills
+ *************************************************************************/
+TargetTrack TargetTrack::alongGround(const Ground & ground, double xFrom, double xTo, double speed)
+{
+   double metersPerColumn = ground.getMetersPerColumn();
+   int columns = (int)(fabs(xTo - xFrom) / metersPerColumn);
+   double dx = xTo > xFrom ? metersPerColumn : -metersPerColumn;
+
+   vector <Position> waypoints;
+   waypoints.reserve(columns + 2);
+   for (int column = 0; column <= columns; column++)
+   {
+      double x = xFrom + column * dx;
+      waypoints.push_back(Position(x, ground.getElevationMeters(Position(x, 0.0))));
+   }
+   waypoints.push_back(Position(xTo, ground.getElevationMeters(Position(xTo, 0.0))));
+   return TargetTrack(waypoints, speed);
+}
+
+/************************************************************************
+ * TARGET TRACK : GET LEG
+ *************************************************************************/
+int TargetTrack::getLeg(double time) const
+{
+   return (int)(upper_bound(times.begin(), times.end(), time) - times.begin()) - 1;
+}
+
+/************************************************************************
+ * TARGET TRACK : GET POSITION
+ * Before the track starts, the target waits at the start
+ *************************************************************************/
+Position TargetTrack::getPosition(double time) const
+{
+   int leg = getLeg(time);
+   if (leg < 0)
+      return points.front();
+
+   const Position & pos = points[leg];
+   if (leg == (int)points.size() - 1)
+      return Position(pos.getMetersX() + dxAfter * (time - times[leg]),
+                      pos.getMetersY() + dyAfter * (time - times[leg]));
+
+   const Position & posNext = points[leg + 1];
+   double fraction = (time - times[leg]) / (times[leg + 1] - times[leg]);
+   return Position(pos.getMetersX() + fraction * (posNext.getMetersX() - pos.getMetersX()),
+                   pos.getMetersY() + fraction * (posNext.getMetersY() - pos.getMetersY()));
+}
+
+/************************************************************************
+ * TARGET TRACK : GET VELOCITY X
+ *************************************************************************/
+double TargetTrack::getVelocityX(double time) const
+{
+   int leg = getLeg(time);
+   if (leg < 0)
+      return 0.0;
+   if (leg == (int)points.size() - 1)
+      return dxAfter;
+   return (points[leg + 1].getMetersX() - points[leg].getMetersX()) / (times[leg + 1] - times[leg]);
+}
+
+/************************************************************************
+ * TARGET TRACK : GET VELOCITY Y
+ *************************************************************************/
+double TargetTrack::getVelocityY(double time) const
+{
+   int leg = getLeg(time);
+   if (leg < 0)
+      return 0.0;
+   if (leg == (int)points.size() - 1)
+      return dyAfter;
+   return (points[leg + 1].getMetersY() - points[leg].getMetersY()) / (times[leg + 1] - times[leg]);
+}
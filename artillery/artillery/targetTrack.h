@@ -0,0 +1,59 @@
+/***********************************************************************
+ * Header File:
+ *    Target Track : where a moving target is at any time
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    A target that stands still, drives at a constant velocity, or
+ *    follows waypoints at a constant speed and stops at the last. The
+ *    track is a line through points with the time the target reaches
+ *    each, and the velocity it keeps after the last.
+ ************************************************************************/
+
+#ifndef targetTrack_h
+#define targetTrack_h
+
+#include "position.h"
+#include <vector>
+
+class Ground;
+
+/*********************************************
+ * TARGET TRACK
+ * Times are in seconds from when the track
+ * starts
+ *********************************************/
+class TargetTrack
+{
+public:
+   // standing still
+   TargetTrack(const Position & pos = Position());
+
+   // from pos at a constant velocity, in meters/second
+   TargetTrack(const Position & pos, double dx, double dy);
+
+   // through the waypoints, in order, at speed meters/second
+   TargetTrack(const std::vector <Position> & waypoints, double speed);
+
+   // on the ground, from x to x at speed meters/second, over the hills
+   static TargetTrack alongGround(const Ground & ground, double xFrom, double xTo, double speed);
+
+   // where the target is
+   Position getPosition(double time) const;
+
+   // how fast it is going, in meters/second
+   double getVelocityX(double time) const;
+   double getVelocityY(double time) const;
+
+private:
+   // the leg of the track the time is on: -1 before the first point,
+   // and the last point after it
+   int getLeg(double time) const;
+
+   std::vector <Position> points;
+   std::vector <double> times;    // when the target is at each point
+   double dxAfter;                // meters/second after the last point
+   double dyAfter;
+};
+
+#endif /* targetTrack_h */
@@ -10,14 +10,191 @@
 #include "test.h"
 #include "testPosition.h"
 #include "testGround.h"
+#include "testRecord.h"
+#include "testRaster.h"
+#include "testLockFree.h"
+#include "testProfiler.h"
+#include "testTrace.h"
+#include "testGolden.h"
+#include "testDispersion.h"
+#include "testHeatmap.h"
+#include "testDual.h"
+#include "testViewport.h"
+#include "testCamera.h"
+#include "testPreview.h"
+#include "testTimeWarp.h"
+#include "testAmmunitionPool.h"
+#include "testTargetTrack.h"
+
+#include <chrono>
+#include <cstdio>     // for tmpfile()
+#include <iomanip>    // for setw()
+#include <iostream>
+#include <string>
+#include <thread>     // for hardware_concurrency()
+
+#ifndef _WIN32
+#include <sys/wait.h> // for waitpid()
+#include <unistd.h>   // for fork()
+#endif // !_WIN32
+
+using namespace std;
+
+const double TestRegistry::DEFAULT_BUDGET = 0.5;
+
+/*****************************************************************
+ * TEST RESULT
+ * How one test went
+ ****************************************************************/
+struct TestResult
+{
+   bool isPassed;
+   double seconds;
+   string output;    // everything it wrote, if it failed
+};
+
+/*****************************************************************
+ * READ ALL
+ * Everything written to a temporary file
+ ****************************************************************/
+static string readAll(FILE * file)
+{
+   string text;
+   char buffer[1024];
+   rewind(file);
+   size_t size;
+   while ((size = fread(buffer, 1, sizeof(buffer), file)) > 0)
+      text.append(buffer, size);
+   return text;
+}
+
+/*****************************************************************
+ * TEST REGISTRY : RUN ALL
+ * Fork a process for each test, up to jobs at a time. A test passes
+ * when its process exits normally; a failed assert aborts only that
+ * process. What a test writes goes to a temporary file that we show
+ * if it fails. Windows has no fork(), so there we run them one at a
+ * time in this process and the first failed assert ends everything.
+ ****************************************************************/
+int TestRegistry::runAll(ostream & out, int jobs)
+{
+   const vector <Test> & tests = getTests();
+   vector <TestResult> results(tests.size());
+   chrono::steady_clock::time_point timeBegin = chrono::steady_clock::now();
+
+#ifdef _WIN32
+   for (size_t i = 0; i < tests.size(); i++)
+   {
+      chrono::steady_clock::time_point timeTest = chrono::steady_clock::now();
+      tests[i].run();
+      results[i].isPassed = true;
+      results[i].seconds = chrono::duration<double>(chrono::steady_clock::now() - timeTest).count();
+   }
+#else // LINUX, XCODE
+   if (jobs <= 0)
+      jobs = max(1, (int)thread::hardware_concurrency());
+
+   struct Running
+   {
+      pid_t pid;
+      size_t iTest;
+      FILE * output;
+      chrono::steady_clock::time_point timeBegin;
+   };
+   vector <Running> running;
+   size_t iNext = 0;
+
+   while (iNext < tests.size() || !running.empty())
+   {
+      // start as many as we have room for
+      while (iNext < tests.size() && (int)running.size() < jobs)
+      {
+         FILE * output = tmpfile();
+         out.flush();
+         fflush(stdout);
+         fflush(stderr);
+         pid_t pid = fork();
+         if (pid < 0)
+         {
+            results[iNext].isPassed = false;
+            results[iNext].seconds = 0.0;
+            results[iNext].output = "unable to start a process\n";
+            if (output != NULL)
+               fclose(output);
+            iNext++;
+            continue;
+         }
+         if (pid == 0)
+         {
+            if (output != NULL)
+            {
+               dup2(fileno(output), 1);
+               dup2(fileno(output), 2);
+               setvbuf(stdout, NULL, _IONBF, 0);   // an abort does not flush
+            }
+            tests[iNext].run();
+            fflush(stdout);
+            _exit(0);
+         }
+         running.push_back({ pid, iNext, output, chrono::steady_clock::now() });
+         iNext++;
+      }
+
+      // wait for one to finish
+      int status = 0;
+      pid_t pid = waitpid(-1, &status, 0);
+      if (pid < 0)
+         break;
+      for (size_t i = 0; i < running.size(); i++)
+         if (running[i].pid == pid)
+         {
+            TestResult & result = results[running[i].iTest];
+            result.seconds = chrono::duration<double>(chrono::steady_clock::now() -
+                                                      running[i].timeBegin).count();
+            result.isPassed = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+            if (running[i].output != NULL)
+            {
+               if (!result.isPassed)
+                  result.output = readAll(running[i].output);
+               fclose(running[i].output);
+            }
+            if (WIFSIGNALED(status))
+               result.output += "killed by signal " + to_string(WTERMSIG(status)) + "\n";
+            running.erase(running.begin() + i);
+            break;
+         }
+   }
+#endif // LINUX, XCODE
+
+   // report
+   int numFailed = 0;
+   int numSlow = 0;
+   for (size_t i = 0; i < tests.size(); i++)
+   {
+      const TestResult & result = results[i];
+      bool isSlow = result.seconds > tests[i].budget;
+      out << (!result.isPassed ? "  FAIL  " : (isSlow ? "  SLOW  " : "  pass  "))
+          << left << setw(20) << tests[i].name << right << fixed << setprecision(3)
+          << setw(8) << result.seconds << "s";
+      if (isSlow)
+         out << " (budget " << tests[i].budget << "s)";
+      out << "\n";
+      if (!result.isPassed)
+         out << result.output;
+      numFailed += !result.isPassed;
+      numSlow += isSlow;
+   }
+   out << tests.size() << " tests, " << numFailed << " failed, " << numSlow << " slow, "
+       << chrono::duration<double>(chrono::steady_clock::now() - timeBegin).count()
+       << "s\n";
+   return numFailed;
+}
 
 /*****************************************************************
  * TEST RUNNER
  * Runs all the unit tests
  ****************************************************************/
-void testRunner()
+int testRunner()
 {
-   TestPosition().run();
-   TestGround().run();
+   return TestRegistry::runAll(cout);
 }
-
@@ -4,13 +4,69 @@
  * Author:
  *    Br. Helfrich
  * Summary:
- *    The test runner for all the unit tests
+ *    The test runner for all the unit tests. Each test class registers
+ *    itself with REGISTER_TEST() after its declaration and the runner
+ *    finds it from there. Each runs in its own process, several at a
+ *    time, so a failed assert only takes down its own test.
  ************************************************************************/
 
 #ifndef test_h
 #define test_h
 
-void testRunner();
+#include <ostream>
+#include <vector>
 
+// run every unit test. Returns how many failed
+int testRunner();
+
+/*********************************************
+ * TEST REGISTRY
+ * Every test class in the program, and how
+ * long each may take before we call it slow
+ *********************************************/
+class TestRegistry
+{
+public:
+   typedef void (*Run)();
+
+   struct Test
+   {
+      const char * name;
+      Run run;
+      double budget;   // seconds
+   };
+
+   static const double DEFAULT_BUDGET;   // seconds
+
+   static void add(const char * name, Run run, double budget) { getTests().push_back({ name, run, budget }); }
+
+   // run them, jobs at a time (0 means one per core), and report how
+   // each one did. Returns how many failed
+   static int runAll(std::ostream & out, int jobs = 0);
+
+private:
+   static std::vector <Test> & getTests()
+   {
+      static std::vector <Test> tests;   // filled before main() starts
+      return tests;
+   }
+};
+
+/*********************************************
+ * TEST REGISTRATION
+ * Construct one at file scope to add a test
+ * class to the registry
+ *********************************************/
+template <class T>
+class TestRegistration
+{
+public:
+   TestRegistration(const char * name, double budget = TestRegistry::DEFAULT_BUDGET)
+   {
+      TestRegistry::add(name, []() { T().run(); }, budget);
+   }
+};
+
+#define REGISTER_TEST(T) static TestRegistration <T> registration##T(#T)
 
 #endif /* test_h */
@@ -0,0 +1,124 @@
+/***********************************************************************
+ * Header File:
+ *    Test Ammunition Pool : Test many rounds in the air
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    All the unit tests for AmmunitionPool and SustainedFire that need
+ *    no drag tables
+ ************************************************************************/
+
+#ifndef testAmmunitionPool_h
+#define testAmmunitionPool_h
+
+#include "test.h"
+#include "ammunitionPool.h"
+#include <cassert>
+
+using namespace std;
+
+/*******************************
+ * TEST AMMUNITION POOL
+ ********************************/
+class TestAmmunitionPool
+{
+public:
+   void run()
+   {
+      fire_neverMoves();
+      fire_full();
+      compact_swapsLast();
+      compact_allDead();
+      sustainedFire_cadence();
+   }
+
+private:
+   // a round fired along the ground, this fast, so we can tell them apart
+   Ammunition * fire(AmmunitionPool & pool, double velocity) const
+   {
+      return pool.fire(Position(0.0, 0.0), velocity, Angle(0.0));
+   }
+
+   double getVelocity(const Ammunition & ammo) const
+   {
+      return ammo.getVelocity().getMetersX();
+   }
+
+   // the rounds stay where the first was put: no reallocation
+   void fire_neverMoves() const
+   {  // setup
+      AmmunitionPool pool(16);
+      const Ammunition * pFirst = fire(pool, 1.0);
+      // exercise
+      for (int i = 2; i <= 16; i++)
+         fire(pool, (double)i);
+      // verify
+      assert(pool.size() == 16);
+      assert(&pool[0] == pFirst);
+      assert(getVelocity(pool[15]) == 16.0);
+   }  // teardown
+
+   // no room, no round
+   void fire_full() const
+   {  // setup
+      AmmunitionPool pool(2);
+      fire(pool, 1.0);
+      fire(pool, 2.0);
+      // exercise
+      Ammunition * pAmmo = fire(pool, 3.0);
+      // verify
+      assert(pAmmo == NULL);
+      assert(pool.isFull());
+      assert(pool.size() == 2);
+   }  // teardown
+
+   // a round that lands is replaced by the last one
+   void compact_swapsLast() const
+   {  // setup
+      AmmunitionPool pool(8);
+      for (int i = 1; i <= 5; i++)
+         fire(pool, (double)i);
+      pool[1].setIsAlive(false);
+      pool[4].setIsAlive(false);
+      // exercise
+      pool.compact();
+      // verify: 5 is dead, so 4 takes the place of 2
+      assert(pool.size() == 3);
+      assert(getVelocity(pool[0]) == 1.0);
+      assert(getVelocity(pool[1]) == 4.0);
+      assert(getVelocity(pool[2]) == 3.0);
+   }  // teardown
+
+   // everything landed at once
+   void compact_allDead() const
+   {  // setup
+      AmmunitionPool pool(8);
+      for (int i = 1; i <= 8; i++)
+         fire(pool, (double)i)->setIsAlive(false);
+      // exercise
+      pool.compact();
+      // verify
+      assert(pool.empty());
+      assert(fire(pool, 9.0) != NULL);
+   }  // teardown
+
+   // a round at once, then one every so many steps
+   void sustainedFire_cadence() const
+   {  // setup
+      SustainedFire fire(3);
+      assert(!fire.update());
+      fire.toggle();
+      // exercise
+      bool fired[7];
+      for (int step = 0; step < 7; step++)
+         fired[step] = fire.update();
+      // verify
+      assert( fired[0] && !fired[1] && !fired[2]);
+      assert( fired[3] && !fired[4] && !fired[5]);
+      assert( fired[6]);
+   }  // teardown
+};
+
+REGISTER_TEST(TestAmmunitionPool);
+
+#endif /* testAmmunitionPool_h */
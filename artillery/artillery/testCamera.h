@@ -0,0 +1,112 @@
+/***********************************************************************
+ * Header File:
+ *    Test Camera : Test panning and zooming
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    All the unit tests for Camera
+ ************************************************************************/
+
+#ifndef testCamera_h
+#define testCamera_h
+
+#include "test.h"
+#include "camera.h"
+#include <cassert>
+#include <cmath>
+
+using namespace std;
+
+/*******************************
+ * TEST CAMERA
+ ********************************/
+class TestCamera
+{
+public:
+   void run()
+   {
+      pan_right();
+      zoom_keepsPoint();
+      zoom_limit();
+      reset_home();
+      transform_matchesViewport();
+   }
+
+private:
+   // the whole window: 700 x 500 pixels of 40m
+   Viewport home() const
+   {
+      return Viewport(700.0, 500.0, 40.0);
+   }
+
+   // panning right shows what was to the right
+   void pan_right() const
+   {  // setup
+      Camera camera(home());
+      // exercise
+      camera.pan(10.0, -5.0);
+      // verify
+      assert(camera.getViewport().getBottomLeft().getMetersX() == 400.0);
+      assert(camera.getViewport().getBottomLeft().getMetersY() == -200.0);
+      assert(camera.getViewport().getMetersFromPixels() == 40.0);
+      assert(camera.getHome().getBottomLeft().getMetersX() == 0.0);
+   }  // teardown
+
+   // what is under the pointer stays under the pointer
+   void zoom_keepsPoint() const
+   {  // setup
+      Camera camera(home());
+      double xMeters = camera.getViewport().toMetersX(100.0);
+      double yMeters = camera.getViewport().toMetersY(50.0);
+      // exercise
+      camera.zoom(4.0, 100.0, 50.0);
+      // verify
+      assert(camera.getViewport().getMetersFromPixels() == 10.0);
+      assert(camera.getViewport().toPixelsX(xMeters) == 100.0);
+      assert(camera.getViewport().toPixelsY(yMeters) == 50.0);
+   }  // teardown
+
+   // it will not zoom forever
+   void zoom_limit() const
+   {  // setup
+      Camera camera(home());
+      // exercise
+      for (int i = 0; i < 100; i++)
+         camera.zoom(0.5);
+      // verify
+      assert(camera.getViewport().getMetersFromPixels() == 40.0 * Camera::MAX_ZOOM);
+   }  // teardown
+
+   // home again
+   void reset_home() const
+   {  // setup
+      Camera camera(home());
+      camera.pan(100.0, 100.0);
+      camera.zoom(2.0);
+      // exercise
+      camera.reset();
+      // verify
+      assert(camera.getViewport() == home());
+   }  // teardown
+
+   // scaling and moving what was drawn at home puts it where the camera
+   // would have drawn it
+   void transform_matchesViewport() const
+   {  // setup
+      Camera camera(home());
+      camera.pan(30.0, -20.0);
+      camera.zoom(2.0, 100.0, 50.0);
+      double xMeters = camera.getHome().toMetersX(250.0);
+      double yMeters = camera.getHome().toMetersY(120.0);
+      // exercise
+      double xPixels = 250.0 * camera.getScale() + camera.getOffsetX();
+      double yPixels = 120.0 * camera.getScale() + camera.getOffsetY();
+      // verify
+      assert(fabs(xPixels - camera.getViewport().toPixelsX(xMeters)) < 1e-9);
+      assert(fabs(yPixels - camera.getViewport().toPixelsY(yMeters)) < 1e-9);
+   }  // teardown
+};
+
+REGISTER_TEST(TestCamera);
+
+#endif /* testCamera_h */
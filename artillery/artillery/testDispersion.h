@@ -0,0 +1,159 @@
+/***********************************************************************
+ * Header File:
+ *    Test Dispersion : Test the pieces of the Monte Carlo engine
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    All the unit tests for RandomStream, parallelFor and the
+ *    dispersion statistics
+ ************************************************************************/
+
+#ifndef testDispersion_h
+#define testDispersion_h
+
+#include "test.h"
+#include "dispersion.h"
+#include "parallel.h"
+#include "randomStream.h"
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+using namespace std;
+
+/*******************************
+ * TEST DISPERSION
+ * Unit tests for everything but the flying
+ ********************************/
+class TestDispersion
+{
+public:
+   void run()
+   {
+      random_sameStream();
+      random_differentStreams();
+      random_normal();
+      parallelFor_everyOnce();
+      stats_known();
+      histogram_cells();
+   }
+
+private:
+   bool closeEnough(double value, double test, double tolerance) const
+   {
+      return fabs(value - test) <= tolerance;
+   }
+
+   // the same seed and stream give the same numbers, whenever we ask
+   void random_sameStream() const
+   {  // setup
+      RandomStream random1(42, 7);
+      RandomStream random2(42, 7);
+      // exercise
+      uint64_t first1 = random1.next();
+      uint64_t second1 = random1.next();
+      uint64_t first2 = random2.next();
+      uint64_t second2 = random2.next();
+      // verify
+      assert(first1 == first2);
+      assert(second1 == second2);
+      assert(first1 != second1);
+   }  // teardown
+
+   // neighboring streams, and neighboring seeds, have nothing in common
+   void random_differentStreams() const
+   {  // setup
+      RandomStream random1(42, 7);
+      RandomStream random2(42, 8);
+      RandomStream random3(43, 7);
+      // exercise
+      int same = 0;
+      for (int i = 0; i < 100; i++)
+      {
+         uint64_t value1 = random1.next();
+         same += value1 == random2.next();
+         same += value1 == random3.next();
+      }
+      // verify
+      assert(same == 0);
+   }  // teardown
+
+   // a standard normal has a mean of 0 and a deviation of 1
+   void random_normal() const
+   {  // setup
+      const int NUM = 100000;
+      RandomStream random(1, 0);
+      double sum = 0.0;
+      double sumSquares = 0.0;
+      // exercise
+      for (int i = 0; i < NUM; i++)
+      {
+         double value = random.normal();
+         sum += value;
+         sumSquares += value * value;
+      }
+      // verify
+      double mean = sum / NUM;
+      double deviation = sqrt(sumSquares / NUM - mean * mean);
+      assert(closeEnough(mean, 0.0, 0.02));
+      assert(closeEnough(deviation, 1.0, 0.02));
+   }  // teardown
+
+   // every index is visited exactly once
+   void parallelFor_everyOnce() const
+   {  // setup
+      const size_t NUM = 10000;
+      vector <atomic <int>> visits(NUM);
+      for (atomic <int> & visit : visits)
+         visit = 0;
+      // exercise
+      parallelFor(NUM, [&visits](size_t i) { visits[i]++; }, 4 /*threads*/, 16 /*chunk*/);
+      // verify
+      for (atomic <int> & visit : visits)
+         assert(visit == 1);
+   }  // teardown
+
+   // four rounds at the corners of a square, and one that never landed
+   void stats_known() const
+   {  // setup
+      vector <Impact> impacts =
+      {
+         {  3.0,  4.0, true },
+         { -3.0,  4.0, true },
+         {  3.0, -4.0, true },
+         { -3.0, -4.0, true },
+         { 99.0, 99.0, false }
+      };
+      // exercise
+      DispersionStats stats = Dispersion::computeStats(impacts, 1000.0);
+      // verify
+      assert(stats.rounds == 5);
+      assert(stats.landed == 4);
+      assert(stats.nominalRange == 1000.0);
+      assert(closeEnough(stats.meanRange, 0.0, 0.0001));
+      assert(closeEnough(stats.meanDeflection, 0.0, 0.0001));
+      assert(closeEnough(stats.deviationRange, sqrt(12.0), 0.0001));
+      assert(closeEnough(stats.deviationDeflection, sqrt(64.0 / 3.0), 0.0001));
+      assert(closeEnough(stats.cep, 5.0, 0.0001));
+   }  // teardown
+
+   // impacts go in the cell around them; the aim is the middle cell
+   void histogram_cells() const
+   {  // setup
+      ImpactHistogram histogram(5, 10.0);
+      // exercise
+      histogram.add({  0.0,   4.0, true  });
+      histogram.add({ 12.0, -18.0, true  });
+      histogram.add({ 60.0,   0.0, true  });
+      histogram.add({  0.0,   0.0, false });
+      // verify
+      assert(histogram.getCount(2, 2) == 1);
+      assert(histogram.getCount(3, 0) == 1);
+      assert(histogram.getOutside() == 2);
+   }  // teardown
+};
+
+REGISTER_TEST(TestDispersion);
+
+#endif /* testDispersion_h */
@@ -0,0 +1,24 @@
+/***********************************************************************
+ * Source File:
+ *    Test Driver : run the unit tests on their own
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    A main() that only runs the unit tests, for ctest and for anyone
+ *    who wants to run them without opening the game. Built by the
+ *    "unit_tests" target in CMakeLists.txt.
+ ************************************************************************/
+
+#include "test.h"
+#include "position.h"
+
+// the game defines this; we are not the game
+double Position::metersFromPixels = 40.0;
+
+/*********************************
+ * Run the tests. Fail if any of them do
+ *********************************/
+int main()
+{
+   return testRunner() == 0 ? 0 : 1;
+}
@@ -0,0 +1,101 @@
+/***********************************************************************
+ * Header File:
+ *    Test Dual : Test the numbers that carry their derivatives
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    All the unit tests for Dual, and for Angle and Motion on Duals
+ ************************************************************************/
+
+#ifndef testDual_h
+#define testDual_h
+
+#include "test.h"
+#include "dual.h"
+#include "motion.h"
+#include <cassert>
+#include <cmath>
+
+using namespace std;
+
+/*******************************
+ * TEST DUAL
+ ********************************/
+class TestDual
+{
+public:
+   void run()
+   {
+      arithmetic();
+      functions();
+      angle_snapKeepsDerivative();
+      motion_movement();
+   }
+
+private:
+   typedef Dual <2> D2;
+
+   bool closeEnough(double value, double test, double tolerance) const
+   {
+      return fabs(value - test) <= tolerance;
+   }
+
+   // f(x, y) = (x * y + 3) / (x - y) at (2, 5)
+   void arithmetic() const
+   {  // setup
+      D2 x = D2::variable(2.0, 0);
+      D2 y = D2::variable(5.0, 1);
+      // exercise
+      D2 f = (x * y + 3.0) / (x - y);
+      // verify: df/dx = (y(x - y) - (xy + 3)) / (x - y)^2
+      assert(closeEnough(f.getValue(), 13.0 / -3.0, 0.0000001));
+      assert(closeEnough(f.getDerivative(0), (5.0 * -3.0 - 13.0) / 9.0, 0.0000001));
+      assert(closeEnough(f.getDerivative(1), (2.0 * -3.0 + 13.0) / 9.0, 0.0000001));
+      assert(f < 0.0);
+   }  // teardown
+
+   // g(x, y) = sqrt(x) * sin(y) + atan2(y, x) at (4, 1)
+   void functions() const
+   {  // setup
+      D2 x = D2::variable(4.0, 0);
+      D2 y = D2::variable(1.0, 1);
+      // exercise
+      D2 g = sqrt(x) * sin(y) + atan2(y, x);
+      // verify
+      assert(closeEnough(g.getValue(), 2.0 * std::sin(1.0) + std::atan2(1.0, 4.0), 0.0000001));
+      assert(closeEnough(g.getDerivative(0), 0.25 * std::sin(1.0) - 1.0 / 17.0, 0.0000001));
+      assert(closeEnough(g.getDerivative(1), 2.0 * std::cos(1.0) + 4.0 / 17.0, 0.0000001));
+   }  // teardown
+
+   // nearly 45 degrees reads as 45, but still moves with its input
+   void angle_snapKeepsDerivative() const
+   {  // setup
+      D2 radians = D2::variable(PI / 4.0 + 0.0001, 0);
+      // exercise
+      AngleT <D2> angle(radians);
+      // verify
+      assert(angle.getRadians().getValue() == PI / 4.0);
+      assert(angle.getRadians().getDerivative(0) == 1.0);
+      assert(angle.getRadians().getDerivative(1) == 0.0);
+   }  // teardown
+
+   // 100m/s at 0.5 radians: the speed moves with the rate, the direction with the angle
+   void motion_movement() const
+   {  // setup
+      D2 rate = D2::variable(100.0, 0);
+      D2 radians = D2::variable(0.5, 1);
+      MotionT <D2> motion;
+      // exercise
+      motion.setMovement(rate, AngleT <D2>(radians));
+      // verify
+      assert(closeEnough(motion.getMetersX().getDerivative(1), -100.0 * std::sin(0.5), 0.0000001));
+      assert(closeEnough(motion.getMetersY().getDerivative(0), std::sin(0.5), 0.0000001));
+      assert(closeEnough(motion.getRateOfChange().getDerivative(0), 1.0, 0.0000001));
+      assert(closeEnough(motion.getRateOfChange().getDerivative(1), 0.0, 0.0000001));
+      assert(closeEnough(motion.getDirection().getRadians().getDerivative(1), 1.0, 0.0000001));
+   }  // teardown
+};
+
+REGISTER_TEST(TestDual);
+
+#endif /* testDual_h */
@@ -0,0 +1,134 @@
+/***********************************************************************
+ * Header File:
+ *    Test Golden : Test the golden trajectory comparison
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    All the unit tests for GoldenFile and compareGolden
+ ************************************************************************/
+
+#ifndef testGolden_h
+#define testGolden_h
+
+#include "test.h"
+#include "golden.h"
+#include <cassert>
+#include <sstream>
+
+using namespace std;
+
+/*******************************
+ * TEST GOLDEN
+ * Unit tests for reading, writing and comparing trajectories
+ ********************************/
+class TestGolden
+{
+public:
+   void run()
+   {
+      readWrite_same();
+      compare_same();
+      compare_withinTolerance();
+      compare_position();
+      compare_impact();
+   }
+
+private:
+   // a straight line of three steps that lands at x=2.5
+   GoldenEntry entry() const
+   {
+      GoldenEntry entry;
+      entry.name = "test";
+      entry.shot.angle = 45.0;
+      entry.shot.velocity = 100.0;
+      entry.shot.altitude = 0.0;
+      for (int i = 0; i < 3; i++)
+      {
+         TrajectoryPoint point = { (double)i, 1.0 * i, 10.0 - 4.0 * i, 1.0, -4.0 };
+         entry.points.push_back(point);
+      }
+      TrajectoryPoint impact = { 2.5, 2.5, 0.0, 1.0, -4.0 };
+      entry.impact = impact;
+      entry.landed = true;
+      return entry;
+   }
+
+   // what goes out comes back in, to the last digit
+   void readWrite_same() const
+   {  // setup
+      GoldenFile golden;
+      GoldenEntry expected = entry();
+      expected.points[1].x = 1.0 / 3.0;
+      golden.add(expected);
+      stringstream stream;
+      // exercise
+      golden.write(stream);
+      GoldenFile copy;
+      bool success = copy.read(stream);
+      // verify
+      assert(success);
+      assert(copy.getEntries().size() == 1);
+      const GoldenEntry * pActual = copy.find("test");
+      assert(pActual != nullptr);
+      assert(pActual->points.size() == 3);
+      assert(pActual->points[1].x == 1.0 / 3.0);
+      assert(pActual->impact.x == 2.5);
+      assert(pActual->landed);
+      assert(copy.find("missing") == nullptr);
+   }  // teardown
+
+   // the same flight matches
+   void compare_same() const
+   {  // setup
+      ostringstream report;
+      // exercise
+      bool isSame = compareGolden(entry(), entry(), GoldenTolerance(), report);
+      // verify
+      assert(isSame);
+      assert(report.str().empty());
+   }  // teardown
+
+   // a little rounding is fine
+   void compare_withinTolerance() const
+   {  // setup
+      GoldenEntry actual = entry();
+      actual.points[2].y += 0.05;
+      actual.points[2].dx += 0.005;
+      actual.impact.x += 0.2;
+      ostringstream report;
+      // exercise
+      bool isSame = compareGolden(entry(), actual, GoldenTolerance(), report);
+      // verify
+      assert(isSame);
+   }  // teardown
+
+   // a round off course is reported
+   void compare_position() const
+   {  // setup
+      GoldenEntry actual = entry();
+      actual.points[1].y += 1.0;
+      ostringstream report;
+      // exercise
+      bool isSame = compareGolden(entry(), actual, GoldenTolerance(), report);
+      // verify
+      assert(!isSame);
+      assert(report.str().find("test: y at t=1") == 0);
+   }  // teardown
+
+   // a round landing somewhere else is reported
+   void compare_impact() const
+   {  // setup
+      GoldenEntry actual = entry();
+      actual.impact.x += 2.0;
+      ostringstream report;
+      // exercise
+      bool isSame = compareGolden(entry(), actual, GoldenTolerance(), report);
+      // verify
+      assert(!isSame);
+      assert(report.str().find("impact x") != string::npos);
+   }  // teardown
+};
+
+REGISTER_TEST(TestGolden);
+
+#endif /* testGolden_h */
@@ -10,6 +10,7 @@
 #ifndef testGround_h
 #define testGround_h
 
+#include "test.h"
 #include "ground.h"
 #include <cassert>
 #include <vector>
@@ -30,6 +31,8 @@ public:
 
 	  getElevationMeters_out();
 	  getElevationMeters_two();
+	  getElevations_matches();
+	  makeGroundAt_left();
 
 	  reset_two();
 
@@ -37,6 +40,12 @@ public:
 	  getTarget_seven();
 
 	  draw();
+	  draw_cached();
+	  draw_zoomedIn();
+	  draw_zoomedOut();
+	  draw_zoomedOutWide();
+
+	  buildLevels_minMax();
    }
 
 private:
@@ -44,28 +53,23 @@ private:
    // Test the default constructor
    void constructor()
    {  // setup
-	  Position posUpperRight;
-	  posUpperRight.setPixelsX(4);
-	  posUpperRight.setPixelsY(5);
+	  Viewport viewport(4.0, 5.0, 1100.0);
 	  // exercise
-	  Ground g(posUpperRight);
+	  Ground g(viewport);
 	  // verify
 	  assert(g.iHowitzer == 0);
 	  assert(g.ground != nullptr);
-	  assert(g.posUpperRight.getPixelsX() == 4);
-	  assert(g.posUpperRight.getPixelsY() == 5);
-	  assert(posUpperRight.getPixelsX() == 4);
-	  assert(posUpperRight.getPixelsY() == 5);
+	  assert(g.viewport.getWidth() == 4);
+	  assert(g.viewport.getHeight() == 5);
+	  assert(g.getMetersPerColumn() == 1100.0);
+	  assert(viewport.getWidth() == 4);
+	  assert(viewport.getHeight() == 5);
    }  // teardown
 
    // when the shell is out of range
    void getElevationMeters_out()
    {  // setup
-	  Position pos;
-	  double zoom = pos.getZoom();
-	  pos.setZoom(1100.0);
-	  pos.setPixelsX(-1);
-	  pos.setPixelsY(4);
+	  Position pos(-1100.0, 4400.0);   // (-1, 4) in pixels
 	  Ground g;
 	  setupStandardFixture(g);
 	  // exercise
@@ -73,18 +77,43 @@ private:
 	  // verify
 	  assert(elevation == 0.0);
 	  verifyStandardFixture(g);
-	  // teardown
-	  pos.setZoom(zoom);
+   }  // teardown
+
+   // the copy says what getElevationMeters() says, on and off the ground
+   void getElevations_matches()
+   {  // setup
+	  Ground g;
+	  setupStandardFixture(g);
+	  // exercise
+	  std::vector <double> elevations = g.getElevations();
+	  // verify
+	  assert(elevations.size() == 10);
+	  for (double x : { -1100.0, 0.0, 2200.0, 5000.0, 10900.0, 11000.0, 20000.0 })
+		 assert(Ground::getElevationAt(elevations, 1100.0, x) ==
+				g.getElevationMeters(Position(x, 0.0)));
+	  verifyStandardFixture(g);
+   }  // teardown
+
+   // down range to the left of the howitzer at column 5
+   void makeGroundAt_left()
+   {  // setup
+	  Ground g;
+	  setupStandardFixture(g);
+	  std::vector <double> elevations = g.getElevations();
+	  // exercise
+	  std::function <double (double)> groundAt =
+		 Ground::makeGroundAt(elevations, 1100.0, 5500.0 + 550.0, -1.0);
+	  // verify
+	  assert(groundAt(0.0) == 4400.0);      // column 5
+	  assert(groundAt(1100.0) == 5500.0);   // column 4
+	  assert(groundAt(7000.0) == 0.0);      // off the ground
+	  verifyStandardFixture(g);
    }  // teardown
 
    // The shell is 2 pixels above the ground
    void getElevationMeters_two()
    {  // setup
-	  Position pos;
-	  double zoom = pos.getZoom();
-	  pos.setZoom(1100.0);
-	  pos.setPixelsX(2);
-	  pos.setPixelsY(9);
+	  Position pos(2200.0, 9900.0);    // (2, 9) in pixels
 	  Ground g;
 	  setupStandardFixture(g);
 	  // exercise
@@ -92,8 +121,6 @@ private:
 	  // verify
 	  assert(elevation == 7700.0);  // 7 pixels high or 7700m
 	  verifyStandardFixture(g);
-	  // teardown
-	  pos.setZoom(zoom);
    }
 
    // The shell is 2 pixels above the ground
@@ -102,28 +129,28 @@ private:
 	  Position posHowitzer;
 	  Ground g;
 	  setupStandardFixture(g);
-	  posHowitzer.setPixelsX(3.0);
-	  posHowitzer.setPixelsY(4.0);
+	  posHowitzer.setMetersX(3300.0);
+	  posHowitzer.setMetersY(4400.0);
 	  // exercise
 	  g.reset(posHowitzer);
 	  // verify
 	  assert(g.iHowitzer == 3);
 	  assert(g.iTarget >= 0 && g.iTarget < 10);
-	  assert(g.posUpperRight.getPixelsX() == 10.0);
-	  assert(g.posUpperRight.getPixelsY() == 10.0);
+	  assert(g.viewport.getWidth() == 10.0);
+	  assert(g.viewport.getHeight() == 10.0);
 	  assert(g.ground != nullptr);
 	  if (g.ground != nullptr)
 	  {
-		 assert(g.ground[0] >= 0.0 && g.ground[0] < 10.0);
-		 assert(g.ground[1] >= 0.0 && g.ground[1] < 10.0);
-		 assert(g.ground[2] >= 0.0 && g.ground[2] < 10.0);
-		 assert(g.ground[3] >= 0.0 && g.ground[3] < 10.0);
-		 assert(g.ground[4] >= 0.0 && g.ground[4] < 10.0);
-		 assert(g.ground[5] >= 0.0 && g.ground[5] < 10.0);
-		 assert(g.ground[6] >= 0.0 && g.ground[6] < 10.0);
-		 assert(g.ground[7] >= 0.0 && g.ground[7] < 10.0);
-		 assert(g.ground[8] >= 0.0 && g.ground[8] < 10.0);
-		 assert(g.ground[9] >= 0.0 && g.ground[9] < 10.0);
+		 assert(g.ground[0] >= 0.0 && g.ground[0] < 11000.0);
+		 assert(g.ground[1] >= 0.0 && g.ground[1] < 11000.0);
+		 assert(g.ground[2] >= 0.0 && g.ground[2] < 11000.0);
+		 assert(g.ground[3] >= 0.0 && g.ground[3] < 11000.0);
+		 assert(g.ground[4] >= 0.0 && g.ground[4] < 11000.0);
+		 assert(g.ground[5] >= 0.0 && g.ground[5] < 11000.0);
+		 assert(g.ground[6] >= 0.0 && g.ground[6] < 11000.0);
+		 assert(g.ground[7] >= 0.0 && g.ground[7] < 11000.0);
+		 assert(g.ground[8] >= 0.0 && g.ground[8] < 11000.0);
+		 assert(g.ground[9] >= 0.0 && g.ground[9] < 11000.0);
 	  }
    }  // teardown
 
@@ -139,8 +166,8 @@ private:
 	  // exercise
 	  Position posTarget = g.getTarget();
 	  // verify
-	  assert(posTarget.getPixelsX() == 2.0);
-	  assert(posTarget.getPixelsY() == 7.0);
+	  assert(posTarget.getMetersX() == 2200.0);
+	  assert(posTarget.getMetersY() == 7700.0);
 	  g.iTarget = iTargetSave;
 	  verifyStandardFixture(g);
    }  // teardown
@@ -156,8 +183,8 @@ private:
 	  // exercise
 	  Position posTarget = g.getTarget();
 	  // verify
-	  assert(posTarget.getPixelsX() == 7.0);
-	  assert(posTarget.getPixelsY() == 2.0);
+	  assert(posTarget.getMetersX() == 7700.0);
+	  assert(posTarget.getMetersY() == 2200.0);
 	  g.iTarget = iTargetSave;
 	  verifyStandardFixture(g);
    }  // teardown
@@ -166,6 +193,7 @@ private:
    class ogstreamSpy : public ogstreamDummy
    {
    public:
+	  ogstreamSpy(const Viewport & viewport) : ogstreamDummy(viewport) {}
 	  // ignore lines
 	  void drawLine(const Position& begin, const Position& end,
 		 double red, double green, double blue) { }
@@ -196,55 +224,150 @@ private:
 	  Position pos;
 	  Ground g;
 	  setupStandardFixture(g);
-	  ogstreamSpy goutSpy;
+	  ogstreamSpy goutSpy(g.viewport);
 	  // exercise
 	  g.draw(goutSpy);
 	  // verify
 	  assert(goutSpy.targets.size() == 1);
-	  assert(0 <= goutSpy.targets.front().getPixelsX() && goutSpy.targets.front().getPixelsX() < 10);
-	  assert(0 <= goutSpy.targets.front().getPixelsY() && goutSpy.targets.front().getPixelsY() < 10);
+	  assert(0 <= goutSpy.targets.front().getMetersX() && goutSpy.targets.front().getMetersX() < 11000.0);
+	  assert(0 <= goutSpy.targets.front().getMetersY() && goutSpy.targets.front().getMetersY() < 11000.0);
 	  assert(goutSpy.rectanglesBegin.size() == 10);
 	  assert(goutSpy.rectanglesEnd.size() == 10);
-	  assert(goutSpy.rectanglesBegin[0].getPixelsX() == 0);
-	  assert(goutSpy.rectanglesBegin[1].getPixelsX() == 1);
-	  assert(goutSpy.rectanglesBegin[2].getPixelsX() == 2);
-	  assert(goutSpy.rectanglesBegin[3].getPixelsX() == 3);
-	  assert(goutSpy.rectanglesBegin[4].getPixelsX() == 4);
-	  assert(goutSpy.rectanglesBegin[5].getPixelsX() == 5);
-	  assert(goutSpy.rectanglesBegin[6].getPixelsX() == 6);
-	  assert(goutSpy.rectanglesBegin[7].getPixelsX() == 7);
-	  assert(goutSpy.rectanglesBegin[8].getPixelsX() == 8);
-	  assert(goutSpy.rectanglesBegin[9].getPixelsX() == 9);
-	  assert(goutSpy.rectanglesBegin[0].getPixelsY() == 0);
-	  assert(goutSpy.rectanglesBegin[1].getPixelsY() == 0);
-	  assert(goutSpy.rectanglesBegin[2].getPixelsY() == 0);
-	  assert(goutSpy.rectanglesBegin[3].getPixelsY() == 0);
-	  assert(goutSpy.rectanglesBegin[4].getPixelsY() == 0);
-	  assert(goutSpy.rectanglesBegin[5].getPixelsY() == 0);
-	  assert(goutSpy.rectanglesBegin[6].getPixelsY() == 0);
-	  assert(goutSpy.rectanglesBegin[7].getPixelsY() == 0);
-	  assert(goutSpy.rectanglesBegin[8].getPixelsY() == 0);
-	  assert(goutSpy.rectanglesBegin[9].getPixelsY() == 0);
-	  assert(goutSpy.rectanglesEnd[0].getPixelsX() == 1);
-	  assert(goutSpy.rectanglesEnd[1].getPixelsX() == 2);
-	  assert(goutSpy.rectanglesEnd[2].getPixelsX() == 3);
-	  assert(goutSpy.rectanglesEnd[3].getPixelsX() == 4);
-	  assert(goutSpy.rectanglesEnd[4].getPixelsX() == 5);
-	  assert(goutSpy.rectanglesEnd[5].getPixelsX() == 6);
-	  assert(goutSpy.rectanglesEnd[6].getPixelsX() == 7);
-	  assert(goutSpy.rectanglesEnd[7].getPixelsX() == 8);
-	  assert(goutSpy.rectanglesEnd[8].getPixelsX() == 9);
-	  assert(goutSpy.rectanglesEnd[9].getPixelsX() == 10);
-	  assert(goutSpy.rectanglesEnd[0].getPixelsY() == 9);
-	  assert(goutSpy.rectanglesEnd[1].getPixelsY() == 8);
-	  assert(goutSpy.rectanglesEnd[2].getPixelsY() == 7);
-	  assert(goutSpy.rectanglesEnd[3].getPixelsY() == 6);
-	  assert(goutSpy.rectanglesEnd[4].getPixelsY() == 5);
-	  assert(goutSpy.rectanglesEnd[5].getPixelsY() == 4);
-	  assert(goutSpy.rectanglesEnd[6].getPixelsY() == 3);
-	  assert(goutSpy.rectanglesEnd[7].getPixelsY() == 2);
-	  assert(goutSpy.rectanglesEnd[8].getPixelsY() == 1);
-	  assert(goutSpy.rectanglesEnd[9].getPixelsY() == 0);
+	  assert(goutSpy.rectanglesBegin[0].getMetersX() == 0);
+	  assert(goutSpy.rectanglesBegin[1].getMetersX() == 1100.0);
+	  assert(goutSpy.rectanglesBegin[2].getMetersX() == 2200.0);
+	  assert(goutSpy.rectanglesBegin[3].getMetersX() == 3300.0);
+	  assert(goutSpy.rectanglesBegin[4].getMetersX() == 4400.0);
+	  assert(goutSpy.rectanglesBegin[5].getMetersX() == 5500.0);
+	  assert(goutSpy.rectanglesBegin[6].getMetersX() == 6600.0);
+	  assert(goutSpy.rectanglesBegin[7].getMetersX() == 7700.0);
+	  assert(goutSpy.rectanglesBegin[8].getMetersX() == 8800.0);
+	  assert(goutSpy.rectanglesBegin[9].getMetersX() == 9900.0);
+	  assert(goutSpy.rectanglesBegin[0].getMetersY() == 0);
+	  assert(goutSpy.rectanglesBegin[1].getMetersY() == 0);
+	  assert(goutSpy.rectanglesBegin[2].getMetersY() == 0);
+	  assert(goutSpy.rectanglesBegin[3].getMetersY() == 0);
+	  assert(goutSpy.rectanglesBegin[4].getMetersY() == 0);
+	  assert(goutSpy.rectanglesBegin[5].getMetersY() == 0);
+	  assert(goutSpy.rectanglesBegin[6].getMetersY() == 0);
+	  assert(goutSpy.rectanglesBegin[7].getMetersY() == 0);
+	  assert(goutSpy.rectanglesBegin[8].getMetersY() == 0);
+	  assert(goutSpy.rectanglesBegin[9].getMetersY() == 0);
+	  assert(goutSpy.rectanglesEnd[0].getMetersX() == 1100.0);
+	  assert(goutSpy.rectanglesEnd[1].getMetersX() == 2200.0);
+	  assert(goutSpy.rectanglesEnd[2].getMetersX() == 3300.0);
+	  assert(goutSpy.rectanglesEnd[3].getMetersX() == 4400.0);
+	  assert(goutSpy.rectanglesEnd[4].getMetersX() == 5500.0);
+	  assert(goutSpy.rectanglesEnd[5].getMetersX() == 6600.0);
+	  assert(goutSpy.rectanglesEnd[6].getMetersX() == 7700.0);
+	  assert(goutSpy.rectanglesEnd[7].getMetersX() == 8800.0);
+	  assert(goutSpy.rectanglesEnd[8].getMetersX() == 9900.0);
+	  assert(goutSpy.rectanglesEnd[9].getMetersX() == 11000.0);
+	  assert(goutSpy.rectanglesEnd[0].getMetersY() == 9900.0);
+	  assert(goutSpy.rectanglesEnd[1].getMetersY() == 8800.0);
+	  assert(goutSpy.rectanglesEnd[2].getMetersY() == 7700.0);
+	  assert(goutSpy.rectanglesEnd[3].getMetersY() == 6600.0);
+	  assert(goutSpy.rectanglesEnd[4].getMetersY() == 5500.0);
+	  assert(goutSpy.rectanglesEnd[5].getMetersY() == 4400.0);
+	  assert(goutSpy.rectanglesEnd[6].getMetersY() == 3300.0);
+	  assert(goutSpy.rectanglesEnd[7].getMetersY() == 2200.0);
+	  assert(goutSpy.rectanglesEnd[8].getMetersY() == 1100.0);
+	  assert(goutSpy.rectanglesEnd[9].getMetersY() == 0);
+	  verifyStandardFixture(g);
+   }  // teardown
+
+
+   // drawing a second time reuses the geometry from the first
+   void draw_cached()
+   {  // setup
+	  Ground g;
+	  setupStandardFixture(g);
+	  ogstreamSpy goutSpy(g.viewport);
+	  g.draw(goutSpy);
+	  unsigned int generation = g.geometry.getGeneration();
+	  // exercise
+	  g.draw(goutSpy);
+	  // verify
+	  assert(g.geometry.getGeneration() == generation);
+	  assert(goutSpy.targets.size() == 2);
+	  assert(goutSpy.rectanglesBegin.size() == 20);
+	  assert(goutSpy.rectanglesEnd[19].getMetersX() == 11000.0);
+	  assert(goutSpy.rectanglesEnd[19].getMetersY() == 0);
+	  verifyStandardFixture(g);
+   }  // teardown
+
+
+   // zoomed in two times on columns 2 and 3: only they are drawn
+   void draw_zoomedIn()
+   {  // setup
+	  Ground g;
+	  setupStandardFixture(g);
+	  ogstreamSpy goutSpy(Viewport(4.0, 10.0, 550.0, 2200.0, 0.0));
+	  // exercise
+	  g.draw(goutSpy);
+	  // verify
+	  assert(goutSpy.rectanglesBegin.size() == 2);
+	  assert(goutSpy.rectanglesBegin[0].getMetersX() == 2200.0);
+	  assert(goutSpy.rectanglesBegin[1].getMetersX() == 3300.0);
+	  assert(goutSpy.rectanglesEnd[0].getMetersY() == 7700.0);
+	  assert(goutSpy.rectanglesEnd[1].getMetersY() == 6600.0);
+	  verifyStandardFixture(g);
+   }  // teardown
+
+   // zoomed out two times: a pixel is two columns, solid to the lower
+   // and lighter to the higher
+   void draw_zoomedOut()
+   {  // setup
+	  Ground g;
+	  setupStandardFixture(g);
+	  ogstreamSpy goutSpy(Viewport(5.0, 5.0, 2200.0));
+	  // exercise
+	  g.draw(goutSpy);
+	  // verify
+	  assert(goutSpy.rectanglesBegin.size() == 10);
+	  assert(goutSpy.rectanglesBegin[0].getMetersX() == 0.0);
+	  assert(goutSpy.rectanglesBegin[0].getMetersY() == 0.0);
+	  assert(goutSpy.rectanglesEnd[0].getMetersX() == 2200.0);
+	  assert(goutSpy.rectanglesEnd[0].getMetersY() == 8800.0);
+	  assert(goutSpy.rectanglesBegin[1].getMetersY() == 8800.0);
+	  assert(goutSpy.rectanglesEnd[1].getMetersY() == 9900.0);
+	  assert(goutSpy.rectanglesBegin[8].getMetersX() == 8800.0);
+	  assert(goutSpy.rectanglesEnd[9].getMetersX() == 11000.0);
+	  verifyStandardFixture(g);
+   }  // teardown
+
+   // a flat ground 4096 columns wide on a screen 8 pixels wide is 8 rectangles
+   void draw_zoomedOutWide()
+   {  // setup
+	  Ground g(Viewport(4096.0, 10.0, 1100.0));
+	  for (int i = 0; i < 4096; i++)
+		 g.ground[i] = 1100.0;
+	  g.iTarget = 7;
+	  ogstreamSpy goutSpy(Viewport(8.0, 10.0, 1100.0 * 512.0));
+	  // exercise
+	  g.draw(goutSpy);
+	  // verify
+	  assert(goutSpy.rectanglesBegin.size() == 8);
+	  assert(goutSpy.rectanglesEnd[7].getMetersX() == 4096.0 * 1100.0);
+	  assert(goutSpy.rectanglesEnd[7].getMetersY() == 1100.0);
+   }  // teardown
+
+   // every level has the extent of the columns under it
+   void buildLevels_minMax()
+   {  // setup
+	  Ground g;
+	  setupStandardFixture(g);
+	  // exercise
+	  g.buildLevels();
+	  // verify: 10, 5, 3, 2, and 1 entries
+	  assert(g.levels.size() == 5);
+	  assert(g.levels[1].lows.size() == 5);
+	  assert(g.levels[1].lows[0] == 8800.0);
+	  assert(g.levels[1].highs[0] == 9900.0);
+	  assert(g.levels[2].lows[2] == 0.0);      // columns 8 and 9
+	  assert(g.levels[2].highs[2] == 1100.0);
+	  assert(g.levels[4].lows[0] == 0.0);
+	  assert(g.levels[4].highs[0] == 9900.0);
 	  verifyStandardFixture(g);
    }  // teardown
 
@@ -254,7 +377,7 @@ private:
    //
 
 
-   // standard fixture: 10 x 10 with howitzer at 5 and target at 7
+   // standard fixture: 10 x 10 pixels, 1100m each, with howitzer at 5 and target at 7
    void setupStandardFixture(Ground& g)
    {
 	  // delete the old
@@ -263,10 +386,9 @@ private:
 	  g.ground = new double[10];
 
 	  for (int i = 0; i < 10; i++)
-		 g.ground[i] = 9.0 - (double)i;
+		 g.ground[i] = (9.0 - (double)i) * 1100.0;
 
-	  g.posUpperRight.setPixelsX(10.0);
-	  g.posUpperRight.setPixelsY(10.0);
+	  g.viewport = Viewport(10.0, 10.0, 1100.0);
 	  g.iHowitzer = 5;
 	  g.iTarget = 7;
    }
@@ -276,24 +398,27 @@ private:
    {
 	  assert(g.iHowitzer == 5);
 	  assert(g.iTarget == 7);
-	  assert(g.posUpperRight.getPixelsX() == 10);
-	  assert(g.posUpperRight.getPixelsY() == 10);
+	  assert(g.viewport.getWidth() == 10);
+	  assert(g.viewport.getHeight() == 10);
+	  assert(g.viewport.getMetersFromPixels() == 1100.0);
 	  assert(g.ground != nullptr);
 	  if (g.ground != nullptr)
 	  {
-		 assert(g.ground[0] == 9.0);
-		 assert(g.ground[1] == 8.0);
-		 assert(g.ground[2] == 7.0);
-		 assert(g.ground[3] == 6.0);
-		 assert(g.ground[4] == 5.0);
-		 assert(g.ground[5] == 4.0);
-		 assert(g.ground[6] == 3.0);
-		 assert(g.ground[7] == 2.0);
-		 assert(g.ground[8] == 1.0);
+		 assert(g.ground[0] == 9900.0);
+		 assert(g.ground[1] == 8800.0);
+		 assert(g.ground[2] == 7700.0);
+		 assert(g.ground[3] == 6600.0);
+		 assert(g.ground[4] == 5500.0);
+		 assert(g.ground[5] == 4400.0);
+		 assert(g.ground[6] == 3300.0);
+		 assert(g.ground[7] == 2200.0);
+		 assert(g.ground[8] == 1100.0);
 		 assert(g.ground[9] == 0.0);
 	  }
    }
 };
 
 
+REGISTER_TEST(TestGround);
+
 #endif /* testGround_h */
@@ -0,0 +1,110 @@
+/***********************************************************************
+ * Header File:
+ *    Test Heatmap : Test the chance of a hit from a fan of trajectories
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    All the unit tests for HitHeatmap that need no physics
+ ************************************************************************/
+
+#ifndef testHeatmap_h
+#define testHeatmap_h
+
+#include "test.h"
+#include "heatmap.h"
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+using namespace std;
+
+/*******************************
+ * TEST HEATMAP
+ ********************************/
+class TestHeatmap
+{
+public:
+   void run()
+   {
+      deviations_smooth();
+      deviations_overHill();
+      probability_oneAim();
+      probability_bestAim();
+   }
+
+private:
+   bool closeEnough(double value, double test, double tolerance) const
+   {
+      return fabs(value - test) <= tolerance;
+   }
+
+   // the impact moves 100m a degree and 30m a meter/second
+   void deviations_smooth() const
+   {  // setup
+      HeatmapConfig config;
+      config.deviationElevation = 0.1;
+      config.deviationVelocity = 1.0;
+      vector <FanShot> fan =
+      {
+         { 44.0,  900.0,  930.0, 0.0, true },
+         { 45.0, 1000.0, 1030.0, 0.0, true },
+         { 46.0, 1100.0, 1130.0, 0.0, true }
+      };
+      // exercise
+      HitHeatmap::computeDeviations(fan, config);
+      // verify: sqrt(10^2 + 30^2)
+      assert(closeEnough(fan[1].deviation, sqrt(1000.0), 0.0001));
+      assert(closeEnough(fan[0].deviation, sqrt(1000.0), 0.0001));
+      assert(closeEnough(fan[2].deviation, sqrt(1000.0), 0.0001));
+   }  // teardown
+
+   // one step more and the round clears the hill: ignore the jump
+   void deviations_overHill() const
+   {  // setup
+      HeatmapConfig config;
+      config.deviationElevation = 1.0;
+      config.deviationVelocity = 0.0;
+      vector <FanShot> fan =
+      {
+         { 44.0,  900.0,  900.0, 0.0, true },
+         { 45.0, 1000.0, 1000.0, 0.0, true },
+         { 46.0, 5000.0, 5000.0, 0.0, true }
+      };
+      // exercise
+      HitHeatmap::computeDeviations(fan, config);
+      // verify
+      assert(closeEnough(fan[1].deviation, 100.0, 0.0001));
+   }  // teardown
+
+   // a normal impact centered on the target: erf(radius / (deviation * sqrt(2)))
+   void probability_oneAim() const
+   {  // setup
+      vector <FanShot> fan = { { 45.0, 1000.0, 1000.0, 50.0, true } };
+      // exercise
+      double onTarget = HitHeatmap::getProbabilityHit(fan, 1000.0, 50.0);
+      double farAway  = HitHeatmap::getProbabilityHit(fan, 9000.0, 50.0);
+      // verify
+      assert(closeEnough(onTarget, erf(1.0 / sqrt(2.0)), 0.0001));
+      assert(farAway == 0.0);
+   }  // teardown
+
+   // the best aim wins, and rounds that never landed do not count
+   void probability_bestAim() const
+   {  // setup
+      vector <FanShot> fan =
+      {
+         { 44.0, 1000.0, 1000.0, 400.0, true },
+         { 45.0, 1010.0, 1010.0,  20.0, true },
+         { 46.0, 1000.0, 1000.0,   1.0, false }
+      };
+      // exercise
+      double probability = HitHeatmap::getProbabilityHit(fan, 1000.0, 50.0);
+      // verify
+      double expected = 0.5 * erfc(-40.0 / (20.0 * sqrt(2.0))) - 0.5 * erfc(60.0 / (20.0 * sqrt(2.0)));
+      assert(closeEnough(probability, expected, 0.0001));
+   }  // teardown
+};
+
+REGISTER_TEST(TestHeatmap);
+
+#endif /* testHeatmap_h */
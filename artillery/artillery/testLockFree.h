@@ -0,0 +1,271 @@
+/***********************************************************************
+ * Header File:
+ *    Test Lock Free : Test the queue and triple buffer
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    All the unit tests for SpscQueue and TripleBuffer, and for the
+ *    key events the Interface passes through its queue
+ ************************************************************************/
+
+#ifndef testLockFree_h
+#define testLockFree_h
+
+#include "test.h"
+#include "lockFree.h"
+#include "uiInteract.h"
+#include <cassert>
+#include <thread>
+
+using namespace std;
+
+/*******************************
+ * TEST LOCK FREE
+ * Unit tests for the single-producer single-consumer containers
+ ********************************/
+class TestLockFree
+{
+public:
+   void run()
+   {
+      queue_empty();
+      queue_order();
+      queue_full();
+      queue_threads();
+
+      tripleBuffer_nothingNew();
+      tripleBuffer_newest();
+      tripleBuffer_threads();
+
+      keyEvents_tap();
+      keyEvents_tapTwice();
+      latency_inputFrame();
+      latency_noInput();
+   }
+
+private:
+   // nothing to pop from a new queue
+   void queue_empty() const
+   {  // setup
+      SpscQueue <int, 4> queue;
+      int value = 99;
+      // exercise
+      bool success = queue.pop(value);
+      // verify
+      assert(!success);
+      assert(value == 99);
+      assert(queue.empty());
+   }  // teardown
+
+   // first in, first out
+   void queue_order() const
+   {  // setup
+      SpscQueue <int, 4> queue;
+      int first = 0;
+      int second = 0;
+      // exercise
+      queue.push(1);
+      queue.push(2);
+      queue.pop(first);
+      queue.pop(second);
+      // verify
+      assert(first == 1);
+      assert(second == 2);
+      assert(queue.empty());
+   }  // teardown
+
+   // a queue of four holds three
+   void queue_full() const
+   {  // setup
+      SpscQueue <int, 4> queue;
+      // exercise
+      bool pushed1 = queue.push(1);
+      bool pushed2 = queue.push(2);
+      bool pushed3 = queue.push(3);
+      bool pushed4 = queue.push(4);
+      // verify
+      assert(pushed1 && pushed2 && pushed3);
+      assert(!pushed4);
+   }  // teardown
+
+   // everything arrives, in order, across threads
+   void queue_threads() const
+   {  // setup
+      const int NUM = 100000;
+      SpscQueue <int, 64> queue;
+      // exercise
+      std::thread producer([&queue, NUM]()
+      {
+         for (int i = 0; i < NUM; i++)
+            while (!queue.push(i))
+               this_thread::yield();
+      });
+      int expected = 0;
+      while (expected < NUM)
+      {
+         int value;
+         if (queue.pop(value))
+         {
+            assert(value == expected);
+            expected++;
+         }
+         else
+            this_thread::yield();
+      }
+      producer.join();
+      // verify
+      assert(expected == NUM);
+      assert(queue.empty());
+   }  // teardown
+
+   // the consumer is told when nothing has been published
+   void tripleBuffer_nothingNew() const
+   {  // setup
+      TripleBuffer <int> buffer;
+      // exercise
+      bool isNew = buffer.update();
+      // verify
+      assert(!isNew);
+   }  // teardown
+
+   // only the newest of several snapshots is seen
+   void tripleBuffer_newest() const
+   {  // setup
+      TripleBuffer <int> buffer;
+      // exercise
+      buffer.getBack() = 1;
+      buffer.publish();
+      buffer.getBack() = 2;
+      buffer.publish();
+      bool isNew = buffer.update();
+      bool isNewAgain = buffer.update();
+      // verify
+      assert(isNew);
+      assert(!isNewAgain);
+      assert(buffer.getFront() == 2);
+   }  // teardown
+
+   // snapshots never go backwards and are never torn
+   void tripleBuffer_threads() const
+   {  // setup
+      struct Snapshot { int a; int b; };
+      const int NUM = 100000;
+      TripleBuffer <Snapshot> buffer;
+      // exercise
+      std::thread producer([&buffer, NUM]()
+      {
+         for (int i = 1; i <= NUM; i++)
+         {
+            buffer.getBack().a = i;
+            buffer.getBack().b = -i;
+            buffer.publish();
+         }
+      });
+      int last = 0;
+      while (last < NUM)
+         if (buffer.update())
+         {
+            const Snapshot & snapshot = buffer.getFront();
+            assert(snapshot.a > last);
+            assert(snapshot.b == -snapshot.a);
+            last = snapshot.a;
+         }
+         else
+            this_thread::yield();
+      producer.join();
+      // verify
+      assert(last == NUM);
+   }  // teardown
+
+   // a key pressed and released before one poll is down for one step
+   void keyEvents_tap() const
+   {  // setup
+      Interface ui;
+      drain(ui);
+      Interface::queueKeyEvent(' ', true);
+      Interface::queueKeyEvent(' ', false);
+      // exercise
+      ui.pollKeyEvents();
+      bool isDownFirst = ui.isSpace();
+      ui.keyEvent();         // the step
+      ui.pollKeyEvents();
+      bool isDownSecond = ui.isSpace();
+      // verify
+      assert(isDownFirst);
+      assert(!isDownSecond);
+   }  // teardown
+
+   // the release held for the next poll comes before the next press
+   void keyEvents_tapTwice() const
+   {  // setup
+      Interface ui;
+      drain(ui);
+      Interface::queueKeyEvent(' ', true);
+      Interface::queueKeyEvent(' ', false);
+      Interface::queueKeyEvent(' ', true);
+      Interface::queueKeyEvent(' ', false);
+      // exercise
+      ui.pollKeyEvents();
+      bool isDownFirst = ui.isSpace();
+      ui.keyEvent();
+      ui.pollKeyEvents();
+      bool isDownSecond = ui.isSpace();
+      ui.keyEvent();
+      ui.pollKeyEvents();
+      bool isDownThird = ui.isSpace();
+      // verify
+      assert(isDownFirst);
+      assert(isDownSecond);
+      assert(!isDownThird);
+   }  // teardown
+
+   // a frame that carried a key records how long it took to show
+   void latency_inputFrame() const
+   {  // setup
+      Interface ui;
+      drain(ui);
+      int count = ui.getInputLatency().getCount();
+      Interface::queueKeyEvent(' ', true);
+      // exercise
+      ui.pollKeyEvents();
+      chrono::steady_clock::time_point timeInput = ui.takeInputTime();
+      chrono::steady_clock::time_point timeAgain = ui.takeInputTime();
+      ui.recordInputLatency(timeInput);
+      // verify
+      assert(timeInput != chrono::steady_clock::time_point());
+      assert(timeAgain == chrono::steady_clock::time_point());
+      assert(ui.getInputLatency().getCount() == count + 1);
+      assert(ui.getInputLatency().getMaximum() >= 0.0);
+   }  // teardown
+
+   // a frame without a key records nothing
+   void latency_noInput() const
+   {  // setup
+      Interface ui;
+      drain(ui);
+      int count = ui.getInputLatency().getCount();
+      // exercise
+      ui.pollKeyEvents();
+      chrono::steady_clock::time_point timeInput = ui.takeInputTime();
+      ui.recordInputLatency(timeInput);
+      // verify
+      assert(timeInput == chrono::steady_clock::time_point());
+      assert(ui.getInputLatency().getCount() == count);
+   }  // teardown
+
+   // the key state is shared by every Interface: start from nothing
+   // queued, nothing held for the next poll, and no input unshown
+   void drain(Interface & ui) const
+   {
+      for (int i = 0; i < 2; i++)
+      {
+         ui.pollKeyEvents();
+         ui.keyEvent();
+      }
+      ui.takeInputTime();
+   }
+};
+
+REGISTER_TEST(TestLockFree);
+
+#endif /* testLockFree_h */
@@ -10,6 +10,7 @@
 #ifndef testPosition_h
 #define testPosition_h
 
+#include "test.h"
 #include <iostream>
 #include "position.h"
 #include <cassert>
@@ -36,6 +37,8 @@ public:
 	  
 	  addPixels();
 	  addMeters();
+
+	  addMetersFloat();
    }
    
 private:
@@ -144,7 +147,20 @@ private:
 	  assert(pos.y == 7000.0);
    }  // teardown
 
+   void addMetersFloat() const
+   {  // setup
+	  PositionT <float> pos(4000.0f, 2000.0f);
+	  // exercise
+	  pos.addMetersX(0.5f);
+	  pos.addMetersY(-0.25f);
+	  // verify
+	  assert(pos.getMetersX() == 4000.5f);
+	  assert(pos.getMetersY() == 1999.75f);
+   }  // teardown
+
 };
 
 
+REGISTER_TEST(TestPosition);
+
 #endif /* testPosition_h */
@@ -0,0 +1,164 @@
+/***********************************************************************
+ * Header File:
+ *    Test Preview : Test the trajectory preview
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    All the unit tests for TrajectoryPreview that need no physics.
+ *    The arcs are flown by a stand-in that remembers what it was asked
+ ************************************************************************/
+
+#ifndef testPreview_h
+#define testPreview_h
+
+#include "test.h"
+#include "preview.h"
+#include <cassert>
+#include <chrono>
+#include <vector>
+
+using namespace std;
+
+/*******************************
+ * TEST PREVIEW
+ ********************************/
+class TestPreview
+{
+public:
+   void run()
+   {
+      update_coarseFirst();
+      update_refinesWhenIdle();
+      aim_reusesArcs();
+      update_budget();
+      flyIfMissing_forgets();
+   }
+
+private:
+   // no budget: one flight a frame, and nobody next door
+   PreviewConfig config(int neighbors = 0) const
+   {
+      PreviewConfig config;
+      config.budget = chrono::microseconds(0);
+      config.idleFrames = 2;
+      config.neighbors = neighbors;
+      return config;
+   }
+
+   // lands as far to the right as the angle, in meters
+   TrajectoryPreview::Fly stub(vector <double> & angles) const
+   {
+      return [&angles](double angle, PreviewArc & arc)
+      {
+         angles.push_back(angle);
+         arc.points.assign(2, Position());
+         arc.impact = Position(angle, 0.0);
+         arc.landed = true;
+      };
+   }
+
+   double degrees(double angle) const
+   {
+      return angle * PI / 180.0;
+   }
+
+   // the first frame shows the nearest degree
+   void update_coarseFirst() const
+   {  // setup
+      vector <double> angles;
+      TrajectoryPreview preview(stub(angles), config());
+      preview.aim(degrees(12.34));
+      // exercise
+      int flown = preview.update();
+      // verify
+      assert(flown == 1);
+      assert(angles.size() == 1);
+      assert(angles[0] == 12.0);
+      assert(preview.getLevel() == 0);
+      assert(preview.getArc() != NULL);
+   }  // teardown
+
+   // still long enough, the aim is refined a level a frame
+   void update_refinesWhenIdle() const
+   {  // setup
+      vector <double> angles;
+      TrajectoryPreview preview(stub(angles), config());
+      preview.aim(degrees(12.34));
+      // exercise
+      for (int frame = 0; frame < 5; frame++)
+         preview.update();
+      // verify: coarse, nothing to do while not yet idle, then finer
+      assert(angles.size() == 3);
+      assert(closeEnough(angles[1], 12.3, 0.000001));
+      assert(closeEnough(angles[2], 12.34, 0.000001));
+      assert(preview.getLevel() == 2);
+      assert(closeEnough(preview.getArc()->impact.getMetersX(), 12.34, 0.000001));
+   }  // teardown
+
+   // going back to an angle we have flown costs nothing
+   void aim_reusesArcs() const
+   {  // setup
+      vector <double> angles;
+      TrajectoryPreview preview(stub(angles), config());
+      preview.aim(degrees(12.34));
+      preview.update();
+      preview.aim(degrees(20.0));
+      preview.update();
+      // exercise
+      preview.aim(degrees(12.34));
+      int flown = preview.update();
+      // verify
+      assert(flown == 0);
+      assert(angles.size() == 2);
+      assert(preview.getLevel() == 0);
+   }  // teardown
+
+   // a generous budget flies the neighbors in the same frame
+   void update_budget() const
+   {  // setup
+      vector <double> angles;
+      PreviewConfig configBig = config(2 /*neighbors*/);
+      configBig.budget = chrono::seconds(10);
+      TrajectoryPreview preview(stub(angles), configBig);
+      preview.aim(degrees(-30.0));
+      // exercise
+      int flown = preview.update();
+      // verify
+      assert(flown == 5);
+      assert(angles[0] == -30.0);
+      assert(angles[1] == -29.0);
+      assert(angles[2] == -31.0);
+      assert(angles[3] == -28.0);
+      assert(angles[4] == -32.0);
+   }  // teardown
+
+   // a level that gets too big starts again
+   void flyIfMissing_forgets() const
+   {  // setup
+      vector <double> angles;
+      PreviewConfig configSmall = config();
+      configSmall.maxArcs = 2;
+      TrajectoryPreview preview(stub(angles), configSmall);
+      // exercise
+      for (int angle = 10; angle <= 12; angle++)
+      {
+         preview.aim(degrees(angle));
+         preview.update();
+      }
+      preview.aim(degrees(10.0));
+      preview.update();
+      // verify: 10 was forgotten when 12 came along
+      assert(angles.size() == 4);
+      assert(angles[3] == 10.0);
+      assert(preview.getArc() != NULL);
+   }  // teardown
+
+   bool closeEnough(double value, double test, double tolerance) const
+   {
+      return fabs(value - test) <= tolerance;
+   }
+};
+
+REGISTER_TEST(TestPreview);
+
+#endif /* testPreview_h */
@@ -0,0 +1,154 @@
+/***********************************************************************
+ * Header File:
+ *    Test Profiler : Test the frame timing
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    All the unit tests for Histogram and ProfileScope
+ ************************************************************************/
+
+#ifndef testProfiler_h
+#define testProfiler_h
+
+#include "test.h"
+#include "profiler.h"
+#include <cassert>
+#include <thread>
+
+using namespace std;
+
+/*******************************
+ * TEST PROFILER
+ * Unit tests for the rolling histogram and the scopes
+ ********************************/
+class TestProfiler
+{
+public:
+   void run()
+   {
+      histogram_empty();
+      histogram_percentiles();
+      histogram_rolling();
+      scope_disabled();
+      scope_enabled();
+      scope_otherThread();
+   }
+
+private:
+   bool closeEnough(double value, double test) const
+   {
+      // a bucket is 19% wide, so we are within 10%
+      return value > test * 0.9 && value < test * 1.1;
+   }
+
+   // nothing recorded, nothing to report
+   void histogram_empty() const
+   {  // setup
+      Histogram histogram;
+      // exercise
+      double p50 = histogram.getPercentile(50.0);
+      // verify
+      assert(histogram.getCount() == 0);
+      assert(p50 == 0.0);
+   }  // teardown
+
+   // 90 fast frames and 10 slow ones
+   void histogram_percentiles() const
+   {  // setup
+      Histogram histogram;
+      // exercise
+      for (int i = 0; i < 90; i++)
+         histogram.record(0.001);
+      for (int i = 0; i < 10; i++)
+         histogram.record(0.020);
+      // verify
+      assert(histogram.getCount() == 100);
+      assert(closeEnough(histogram.getPercentile(50.0), 0.001));
+      assert(closeEnough(histogram.getPercentile(90.0), 0.001));
+      assert(closeEnough(histogram.getPercentile(95.0), 0.020));
+      assert(closeEnough(histogram.getPercentile(99.0), 0.020));
+   }  // teardown
+
+   // old frames fall out of the window
+   void histogram_rolling() const
+   {  // setup
+      Histogram histogram;
+      for (int i = 0; i < Histogram::WINDOW; i++)
+         histogram.record(0.050);
+      // exercise
+      for (int i = 0; i < Histogram::WINDOW; i++)
+         histogram.record(0.002);
+      // verify
+      assert(histogram.getCount() == Histogram::WINDOW);
+      assert(closeEnough(histogram.getPercentile(99.0), 0.002));
+      int sum = 0;
+      for (int i = 0; i < Histogram::BUCKETS; i++)
+         sum += histogram.counts[i];
+      assert(sum == Histogram::WINDOW);
+   }  // teardown
+
+   // when turned off, nothing is recorded
+   void scope_disabled() const
+   {  // setup
+      Profiler::setEnabled(false);
+      int countBefore = Profiler::getHistogram(Profiler::COLLIDE).getCount();
+      // exercise
+      {
+         ProfileScope scope(Profiler::COLLIDE);
+      }
+      Profiler::endFrame();
+      // verify
+      assert(Profiler::getHistogram(Profiler::COLLIDE).getCount() == countBefore);
+   }  // teardown
+
+   // when turned on, every phase that ran is recorded once a frame
+   void scope_enabled() const
+   {  // setup
+      Profiler::setEnabled(true);
+      Profiler::setFrameThread();
+      int countCollide = Profiler::getHistogram(Profiler::COLLIDE).getCount();
+      int countSwap = Profiler::getHistogram(Profiler::SWAP).getCount();
+      // exercise
+      for (int i = 0; i < 3; i++)
+      {
+         ProfileScope scope(Profiler::COLLIDE);
+         volatile double sum = 0.0;
+         for (int j = 0; j < 1000; j++)
+            sum = sum + j;
+      }
+      Profiler::endFrame();
+      // verify
+      assert(Profiler::getHistogram(Profiler::COLLIDE).getCount() == countCollide + 1);
+      assert(Profiler::getHistogram(Profiler::SWAP).getCount() == countSwap);
+      assert(Profiler::getHistogram(Profiler::COLLIDE).getPercentile(50.0) > 0.0);
+      // teardown
+      Profiler::setEnabled(false);
+   }
+
+   // a thread that is not running the frame, such as a worker of a
+   // parallelFor, adds nothing to it
+   void scope_otherThread() const
+   {  // setup
+      Profiler::setEnabled(true);
+      Profiler::setFrameThread();
+      int countCollide = Profiler::getHistogram(Profiler::COLLIDE).getCount();
+      // exercise
+      std::thread worker([]()
+      {
+         ProfileScope scope(Profiler::COLLIDE);
+         volatile double sum = 0.0;
+         for (int j = 0; j < 1000; j++)
+            sum = sum + j;
+      });
+      worker.join();
+      Profiler::endFrame();
+      // verify
+      assert(Profiler::getHistogram(Profiler::COLLIDE).getCount() == countCollide);
+      // teardown
+      Profiler::setEnabled(false);
+   }
+};
+
+REGISTER_TEST(TestProfiler);
+
+#endif /* testProfiler_h */
@@ -0,0 +1,209 @@
+/***********************************************************************
+ * Header File:
+ *    Test Raster : Test the software rasterizer
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    All the unit tests for ogstreamRaster
+ ************************************************************************/
+
+#ifndef testRaster_h
+#define testRaster_h
+
+#include "test.h"
+#include "uiRaster.h"
+#include <cassert>
+#include <sstream>
+#include <string>
+
+using namespace std;
+
+/*******************************
+ * TEST RASTER
+ * Unit tests for drawing into a frame buffer
+ ********************************/
+class TestRaster
+{
+public:
+   void run()
+   {
+      constructor();
+      drawRectangle_inside();
+      drawRectangle_zoomed();
+      drawLine_ends();
+      drawText_black();
+      drawProjectile_gray();
+      drawTarget_green();
+      drawHowitzer_barrel();
+      drawHowitzer_flash();
+      writePPM_header();
+      writePNG_signature();
+   }
+
+private:
+   bool isColor(const ogstreamRaster & gout, int x, int y,
+                unsigned char red, unsigned char green, unsigned char blue) const
+   {
+      const unsigned char * p = gout.getPixel(x, y);
+      return p[0] == red && p[1] == green && p[2] == blue && p[3] == 255;
+   }
+
+   Viewport screen(double width, double height) const
+   {
+      return Viewport(width, height, 1.0 /* 1m equals 1 pixel */);
+   }
+
+   // a new frame is all white
+   void constructor() const
+   {  // setup
+      // exercise
+      ogstreamRaster gout(screen(4.0, 3.0));
+      // verify
+      assert(gout.getWidth() == 4);
+      assert(gout.getHeight() == 3);
+      assert(gout.getFrame().size() == 4 * 3 * 4);
+      for (int y = 0; y < 3; y++)
+         for (int x = 0; x < 4; x++)
+            assert(isColor(gout, x, y, 255, 255, 255));
+   }  // teardown
+
+   // a rectangle fills the pixels whose centers are inside it
+   void drawRectangle_inside() const
+   {  // setup
+      ogstreamRaster gout(screen(10.0, 10.0));
+      // exercise
+      gout.drawRectangle(Position(2.0, 3.0), Position(5.0, 4.0), 1.0, 0.0, 0.0);
+      // verify
+      assert(isColor(gout, 2, 3, 255, 0, 0));
+      assert(isColor(gout, 4, 3, 255, 0, 0));
+      assert(isColor(gout, 5, 3, 255, 255, 255));
+      assert(isColor(gout, 1, 3, 255, 255, 255));
+      assert(isColor(gout, 2, 4, 255, 255, 255));
+      assert(isColor(gout, 2, 2, 255, 255, 255));
+   }  // teardown
+
+   // the same rectangle through a viewport twice as far out, and moved
+   void drawRectangle_zoomed() const
+   {  // setup
+      ogstreamRaster gout(Viewport(10.0, 10.0, 2.0 /* 2m equals 1 pixel */, 100.0, 0.0));
+      // exercise
+      gout.drawRectangle(Position(104.0, 6.0), Position(110.0, 8.0), 1.0, 0.0, 0.0);
+      // verify
+      assert(isColor(gout, 2, 3, 255, 0, 0));
+      assert(isColor(gout, 4, 3, 255, 0, 0));
+      assert(isColor(gout, 5, 3, 255, 255, 255));
+      assert(isColor(gout, 1, 3, 255, 255, 255));
+      assert(isColor(gout, 2, 4, 255, 255, 255));
+   }  // teardown
+
+   // a line covers both of its end points
+   void drawLine_ends() const
+   {  // setup
+      ogstreamRaster gout(screen(10.0, 10.0));
+      // exercise
+      gout.drawLine(Position(1.0, 1.0), Position(8.0, 5.0), 0.0, 0.0, 1.0);
+      // verify
+      assert(isColor(gout, 1, 1, 0, 0, 255));
+      assert(isColor(gout, 8, 5, 0, 0, 255));
+      assert(isColor(gout, 9, 9, 255, 255, 255));
+   }  // teardown
+
+   // text is black and sits on top of the point
+   void drawText_black() const
+   {  // setup
+      ogstreamRaster gout(screen(20.0, 20.0));
+      // exercise
+      gout.drawText(Position(2.0, 2.0), "1");
+      // verify: the foot of the "1" runs along the bottom row
+      assert(isColor(gout, 3, 2, 0, 0, 0));
+      assert(isColor(gout, 4, 2, 0, 0, 0));
+      assert(isColor(gout, 5, 2, 0, 0, 0));
+      assert(isColor(gout, 4, 8, 0, 0, 0));
+      assert(isColor(gout, 4, 1, 255, 255, 255));
+      assert(isColor(gout, 4, 9, 255, 255, 255));
+   }  // teardown
+
+   // a projectile is a square three pixels on a side, gray with age
+   void drawProjectile_gray() const
+   {  // setup
+      ogstreamRaster gout(screen(10.0, 10.0));
+      // exercise
+      gout.drawProjectile(Position(5.0, 5.0), 2.5 /* age, half the tail */);
+      // verify
+      assert(isColor(gout, 4, 4, 128, 128, 128));
+      assert(isColor(gout, 6, 6, 128, 128, 128));
+      assert(isColor(gout, 3, 5, 255, 255, 255));
+      assert(isColor(gout, 7, 5, 255, 255, 255));
+      assert(isColor(gout, 5, 7, 255, 255, 255));
+   }  // teardown
+
+   // the target is a green square ten pixels on a side
+   void drawTarget_green() const
+   {  // setup
+      ogstreamRaster gout(screen(20.0, 20.0));
+      // exercise
+      gout.drawTarget(Position(10.0, 10.0));
+      // verify
+      assert(isColor(gout, 5, 5, 51, 191, 51));
+      assert(isColor(gout, 14, 14, 51, 191, 51));
+      assert(isColor(gout, 4, 10, 255, 255, 255));
+      assert(isColor(gout, 15, 10, 255, 255, 255));
+   }  // teardown
+
+   // the barrel starts two pixels up and the wheels sit on the point
+   void drawHowitzer_barrel() const
+   {  // setup
+      ogstreamRaster gout(screen(40.0, 40.0));
+      // exercise
+      gout.drawHowitzer(Position(20.0, 10.0), 0.0 /* straight up */, 0.0 /* age */);
+      // verify
+      assert(isColor(gout, 20, 12, 0, 0, 0));
+      assert(isColor(gout, 14, 10, 0, 0, 0));
+      assert(isColor(gout, 26, 10, 0, 0, 0));
+      assert(isColor(gout, 20, 32, 255, 255, 255));
+   }  // teardown
+
+   // just fired, the muzzle flash ends with its most intense line
+   void drawHowitzer_flash() const
+   {  // setup
+      ogstreamRaster gout(screen(40.0, 40.0));
+      // exercise
+      gout.drawHowitzer(Position(20.0, 10.0), 0.0 /* straight up */, 1.0 /* age */);
+      // verify
+      assert(isColor(gout, 20, 32, 255, 26, 26));
+      assert(isColor(gout, 12, 32, 255, 128, 128));
+   }  // teardown
+
+   // a PPM is a small header followed by RGB
+   void writePPM_header() const
+   {  // setup
+      ogstreamRaster gout(screen(2.0, 2.0));
+      ostringstream sout;
+      // exercise
+      bool success = gout.writePPM(sout);
+      // verify
+      string ppm = sout.str();
+      assert(success);
+      assert(ppm.substr(0, 11) == "P6\n2 2\n255\n");
+      assert(ppm.size() == 11 + 2 * 2 * 3);
+   }  // teardown
+
+   // a PNG starts with its signature and ends with IEND
+   void writePNG_signature() const
+   {  // setup
+      ogstreamRaster gout(screen(2.0, 2.0));
+      ostringstream sout;
+      // exercise
+      bool success = gout.writePNG(sout);
+      // verify
+      string png = sout.str();
+      assert(success);
+      assert(png.substr(1, 3) == "PNG");
+      assert(png.substr(12, 4) == "IHDR");
+      assert(png.substr(png.size() - 8, 4) == "IEND");
+   }  // teardown
+};
+
+REGISTER_TEST(TestRaster);
+
+#endif /* testRaster_h */
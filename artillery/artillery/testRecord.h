@@ -0,0 +1,301 @@
+/***********************************************************************
+ * Header File:
+ *    Test Record : Test the draw buffer and recording graphics stream
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    All the unit tests for DrawBuffer and ogstreamRecord
+ ************************************************************************/
+
+#ifndef testRecord_h
+#define testRecord_h
+
+#include "test.h"
+#include "uiRecord.h"
+#include <cassert>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/*******************************
+ * TEST RECORD
+ * Unit tests for recording draw commands and playing them back
+ ********************************/
+class TestRecord
+{
+public:
+   void run()
+   {
+      record_empty();
+      record_line();
+      record_text();
+      replay_order();
+      clear_keepsMemory();
+      copyCaches_sameGeneration();
+      copyCaches_newGeneration();
+      copyCaches_sameAddress();
+      copyCaches_dropUnused();
+   }
+
+private:
+   // Spy to see exactly what ogstream::draw*() methods are called... and how.
+   class ogstreamSpy : public ogstreamDummy
+   {
+   public:
+      void flush() { }
+      void drawLine(const Position& begin, const Position& end,
+         double red, double green, double blue)
+      {
+         calls.push_back("line");
+         positions.push_back(begin);
+         positions.push_back(end);
+         colors.push_back(red);
+      }
+      void drawRectangle(const Position& begin, const Position& end,
+         double red, double green, double blue)
+      {
+         calls.push_back("rectangle");
+      }
+      void drawProjectile(const Position& pos, double age)
+      {
+         calls.push_back("projectile");
+         ages.push_back(age);
+      }
+      void drawHowitzer(const Position& pos, double angle, double age)
+      {
+         calls.push_back("howitzer");
+      }
+      void drawTarget(const Position& pos)
+      {
+         calls.push_back("target");
+         positions.push_back(pos);
+      }
+      void drawText(const Position& topLeft, const char* text)
+      {
+         calls.push_back(string("text ") + text);
+      }
+      vector <string>   calls;
+      vector <Position> positions;
+      vector <double>   colors;
+      vector <double>   ages;
+   };
+
+   // a new buffer has nothing in it
+   void record_empty() const
+   {  // setup
+      DrawBuffer buffer;
+      ogstreamSpy goutSpy;
+      // exercise
+      buffer.replay(goutSpy);
+      // verify
+      assert(buffer.empty());
+      assert(buffer.size() == 0);
+      assert(goutSpy.calls.empty());
+   }  // teardown
+
+   // a line goes in and comes back out the same
+   void record_line() const
+   {  // setup
+      DrawBuffer buffer;
+      ogstreamSpy goutSpy;
+      {
+         ogstreamRecord gout(buffer);
+         // exercise
+         gout.drawLine(Position(1000.0, 2000.0), Position(3000.0, 4000.0), 1.0, 0.0, 0.0);
+      }
+      buffer.replay(goutSpy);
+      // verify
+      assert(buffer.size() == 1);
+      assert(goutSpy.calls.size() == 1);
+      assert(goutSpy.calls[0] == "line");
+      assert(goutSpy.positions[0].getMetersX() == 1000.0);
+      assert(goutSpy.positions[0].getMetersY() == 2000.0);
+      assert(goutSpy.positions[1].getMetersX() == 3000.0);
+      assert(goutSpy.positions[1].getMetersY() == 4000.0);
+      assert(goutSpy.colors[0] == 1.0);
+   }  // teardown
+
+   // streamed text is recorded when the stream is flushed
+   void record_text() const
+   {  // setup
+      DrawBuffer buffer;
+      ogstreamSpy goutSpy;
+      {
+         ogstreamRecord gout(buffer, Viewport(700.0, 500.0, 1000.0 /* 1km equals 1 pixel */),
+                             Position(1000.0, 9000.0));
+         // exercise
+         gout << "Angle " << 45;
+      }
+      buffer.replay(goutSpy);
+      // verify
+      assert(buffer.size() == 1);
+      assert(goutSpy.calls.size() == 1);
+      assert(goutSpy.calls[0] == "text Angle 45");
+   }  // teardown
+
+   // every kind of command comes back in the order it went in
+   void replay_order() const
+   {  // setup
+      DrawBuffer buffer;
+      ogstreamSpy goutSpy;
+      ogstreamRecord gout(buffer);
+      // exercise
+      gout.drawTarget(Position(5000.0, 1000.0));
+      gout.drawHowitzer(Position(2000.0, 1000.0), 0.5, 0.0);
+      gout.drawProjectile(Position(3000.0, 3000.0), 1.5);
+      gout.drawRectangle(Position(), Position(1000.0, 1000.0), 0.6, 0.4, 0.2);
+      gout.drawText(Position(), "km");
+      buffer.replay(goutSpy);
+      // verify
+      assert(goutSpy.calls.size() == 5);
+      assert(goutSpy.calls[0] == "target");
+      assert(goutSpy.calls[1] == "howitzer");
+      assert(goutSpy.calls[2] == "projectile");
+      assert(goutSpy.calls[3] == "rectangle");
+      assert(goutSpy.calls[4] == "text km");
+      assert(goutSpy.positions[0].getMetersX() == 5000.0);
+      assert(goutSpy.ages[0] == 1.5);
+   }  // teardown
+
+   // clearing the buffer forgets the commands but keeps the memory
+   void clear_keepsMemory() const
+   {  // setup
+      DrawBuffer buffer;
+      ogstreamRecord gout(buffer);
+      for (int i = 0; i < 1000; i++)
+         gout.drawProjectile(Position(), 0.0);
+      size_t capacity = buffer.getCommands().capacity();
+      // exercise
+      buffer.clear();
+      // verify
+      assert(buffer.empty());
+      assert(buffer.getCommands().capacity() == capacity);
+   }  // teardown
+
+   // a cache that has not changed is copied once, not every frame
+   void copyCaches_sameGeneration() const
+   {  // setup
+      DrawCache cache;
+      cache.addLine(Position(), Position(1000.0, 1000.0));
+      DrawBuffer buffer;
+      const DrawCache * pCopies[2];
+      // exercise
+      for (int frame = 0; frame < 2; frame++)
+      {
+         buffer.clear();
+         ogstreamRecord gout(buffer);
+         gout.setCopyCaches(true);
+         gout.drawCache(cache);
+         pCopies[frame] = &buffer.getCache(buffer.getCommands()[0]);
+      }
+      // verify
+      assert(buffer.size() == 1);
+      assert(pCopies[0] != &cache);
+      assert(pCopies[1] == pCopies[0]);
+      assert(pCopies[1]->getPrimitives().size() == 1);
+   }  // teardown
+
+   // a cache rebuilt since the last frame is copied again, and what was
+   // recorded before is not what the cache is now
+   void copyCaches_newGeneration() const
+   {  // setup
+      DrawCache cache;
+      cache.addLine(Position(), Position(1000.0, 1000.0));
+      DrawBuffer buffer;
+      {
+         ogstreamRecord gout(buffer);
+         gout.setCopyCaches(true);
+         gout.drawCache(cache);
+      }
+      const DrawCache & copy = buffer.getCache(buffer.getCommands()[0]);
+      unsigned int generation = copy.getGeneration();
+      cache.clear();
+      cache.addRectangle(Position(), Position(1000.0, 1000.0));
+      assert(copy.getPrimitives()[0].type == DrawCache::LINE);
+      // exercise
+      buffer.clear();
+      {
+         ogstreamRecord gout(buffer);
+         gout.setCopyCaches(true);
+         gout.drawCache(cache);
+      }
+      ogstreamSpy goutSpy;
+      buffer.replay(goutSpy);
+      // verify
+      assert(&buffer.getCache(buffer.getCommands()[0]) == &copy);
+      assert(copy.getGeneration() != generation);
+      assert(goutSpy.calls.size() == 1);
+      assert(goutSpy.calls[0] == "rectangle");
+   }  // teardown
+
+   // a new cache where an old one was, at the same generation the old one
+   // was, is copied rather than mistaken for the old one
+   void copyCaches_sameAddress() const
+   {  // setup
+      optional <DrawCache> cache;
+      cache.emplace();
+      cache->addLine(Position(), Position(1000.0, 1000.0));
+      const DrawCache * pOld = &*cache;
+      unsigned int generation = cache->getGeneration();
+      DrawBuffer buffer;
+      {
+         ogstreamRecord gout(buffer);
+         gout.setCopyCaches(true);
+         gout.drawCache(*cache);
+      }
+      cache.emplace();
+      cache->addRectangle(Position(), Position(1000.0, 1000.0));
+      assert(&*cache == pOld);
+      assert(cache->getGeneration() == generation);
+      // exercise
+      buffer.clear();
+      {
+         ogstreamRecord gout(buffer);
+         gout.setCopyCaches(true);
+         gout.drawCache(*cache);
+      }
+      ogstreamSpy goutSpy;
+      buffer.replay(goutSpy);
+      // verify
+      assert(goutSpy.calls.size() == 1);
+      assert(goutSpy.calls[0] == "rectangle");
+   }  // teardown
+
+   // a copy kept for a cache that is no longer drawn goes after a frame
+   void copyCaches_dropUnused() const
+   {  // setup
+      DrawCache cacheKept;
+      cacheKept.addLine(Position(), Position(1000.0, 1000.0));
+      DrawCache cacheDropped;
+      cacheDropped.addLine(Position(), Position(1000.0, 1000.0));
+      DrawBuffer buffer;
+      {
+         ogstreamRecord gout(buffer);
+         gout.setCopyCaches(true);
+         gout.drawCache(cacheDropped);
+         gout.drawCache(cacheKept);
+      }
+      assert(buffer.sizeCacheCopies() == 2);
+      // exercise
+      buffer.clear();
+      {
+         ogstreamRecord gout(buffer);
+         gout.setCopyCaches(true);
+         gout.drawCache(cacheKept);
+      }
+      size_t sizeDrawnOnce = buffer.sizeCacheCopies();
+      buffer.clear();
+      // verify
+      assert(sizeDrawnOnce == 2);
+      assert(buffer.sizeCacheCopies() == 1);
+      buffer.clear();
+      assert(buffer.sizeCacheCopies() == 0);
+   }  // teardown
+};
+
+REGISTER_TEST(TestRecord);
+
+#endif /* testRecord_h */
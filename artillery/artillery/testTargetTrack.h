@@ -0,0 +1,112 @@
+/***********************************************************************
+ * Header File:
+ *    Test Target Track : Test where a moving target goes
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    All the unit tests for TargetTrack
+ ************************************************************************/
+
+#ifndef testTargetTrack_h
+#define testTargetTrack_h
+
+#include "test.h"
+#include "targetTrack.h"
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+using namespace std;
+
+/*******************************
+ * TEST TARGET TRACK
+ ********************************/
+class TestTargetTrack
+{
+public:
+   void run()
+   {
+      still();
+      constantVelocity();
+      waypoints_between();
+      waypoints_velocity();
+      waypoints_beforeAndAfter();
+   }
+
+private:
+   bool closeEnough(double value, double test, double tolerance) const
+   {
+      return fabs(value - test) <= tolerance;
+   }
+
+   // a target that does not move is where it was put, whenever
+   void still() const
+   {  // setup
+      TargetTrack track(Position(1000.0, 50.0));
+      // exercise
+      Position pos = track.getPosition(30.0);
+      // verify
+      assert(pos.getMetersX() == 1000.0);
+      assert(pos.getMetersY() == 50.0);
+      assert(track.getVelocityX(30.0) == 0.0);
+   }  // teardown
+
+   // ten seconds at 10 m/s to the left and 1 m/s up
+   void constantVelocity() const
+   {  // setup
+      TargetTrack track(Position(1000.0, 50.0), -10.0, 1.0);
+      // exercise
+      Position pos = track.getPosition(10.0);
+      // verify
+      assert(closeEnough(pos.getMetersX(), 900.0, 0.0001));
+      assert(closeEnough(pos.getMetersY(), 60.0, 0.0001));
+      assert(track.getVelocityX(10.0) == -10.0);
+      assert(track.getVelocityY(10.0) == 1.0);
+   }  // teardown
+
+   // 300m then 400m up at 10 m/s: 30 seconds, then 40 more
+   void waypoints_between() const
+   {  // setup
+      vector <Position> waypoints = { Position(0.0, 0.0), Position(300.0, 0.0), Position(300.0, 400.0) };
+      TargetTrack track(waypoints, 10.0);
+      // exercise
+      Position posFirst = track.getPosition(15.0);
+      Position posSecond = track.getPosition(50.0);
+      // verify
+      assert(closeEnough(posFirst.getMetersX(), 150.0, 0.0001));
+      assert(closeEnough(posFirst.getMetersY(), 0.0, 0.0001));
+      assert(closeEnough(posSecond.getMetersX(), 300.0, 0.0001));
+      assert(closeEnough(posSecond.getMetersY(), 200.0, 0.0001));
+   }  // teardown
+
+   // the velocity is that of the leg we are on
+   void waypoints_velocity() const
+   {  // setup
+      vector <Position> waypoints = { Position(0.0, 0.0), Position(300.0, 0.0), Position(300.0, 400.0) };
+      TargetTrack track(waypoints, 10.0);
+      // exercise and verify
+      assert(closeEnough(track.getVelocityX(15.0), 10.0, 0.0001));
+      assert(closeEnough(track.getVelocityY(15.0), 0.0, 0.0001));
+      assert(closeEnough(track.getVelocityX(50.0), 0.0, 0.0001));
+      assert(closeEnough(track.getVelocityY(50.0), 10.0, 0.0001));
+   }  // teardown
+
+   // waits at the start before it, and stops at the end after it
+   void waypoints_beforeAndAfter() const
+   {  // setup
+      vector <Position> waypoints = { Position(100.0, 0.0), Position(200.0, 0.0) };
+      TargetTrack track(waypoints, 10.0);
+      // exercise
+      Position posBefore = track.getPosition(-5.0);
+      Position posAfter = track.getPosition(500.0);
+      // verify
+      assert(posBefore.getMetersX() == 100.0);
+      assert(posAfter.getMetersX() == 200.0);
+      assert(track.getVelocityX(-5.0) == 0.0);
+      assert(track.getVelocityX(500.0) == 0.0);
+   }  // teardown
+};
+
+REGISTER_TEST(TestTargetTrack);
+
+#endif /* testTargetTrack_h */
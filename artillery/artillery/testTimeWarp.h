@@ -0,0 +1,137 @@
+/***********************************************************************
+ * Header File:
+ *    Test Time Warp : Test simulating faster than the wall clock
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    All the unit tests for TimeWarp. No clock is read: every step is
+ *    pretended to take so long
+ ************************************************************************/
+
+#ifndef testTimeWarp_h
+#define testTimeWarp_h
+
+#include "test.h"
+#include "timeWarp.h"
+#include <cassert>
+#include <cmath>
+
+using namespace std;
+
+/*******************************
+ * TEST TIME WARP
+ ********************************/
+class TestTimeWarp
+{
+public:
+   void run()
+   {
+      realTime_wallClock();
+      realTime_dropsBacklog();
+      times10_tenTimes();
+      times100_budget();
+      fastest_fillsBudget();
+      faster_cycles();
+   }
+
+private:
+   // one frame of so much wall time, each step taking secondsPerStep
+   int frame(TimeWarp & timeWarp, double elapsed, double timeStep,
+             double secondsPerStep = 0.0, double budget = 1.0) const
+   {
+      timeWarp.begin(elapsed, timeStep);
+      int steps = 0;
+      while (timeWarp.isStepDue(steps * secondsPerStep, budget))
+      {
+         timeWarp.step();
+         steps++;
+      }
+      return steps;
+   }
+
+   // in real time, steps are taken as the wall clock passes them
+   void realTime_wallClock() const
+   {  // setup
+      TimeWarp timeWarp;
+      // exercise
+      int steps = frame(timeWarp, 0.15625, 0.0625);
+      double interpolation = timeWarp.end();
+      // verify
+      assert(steps == 2);
+      assert(interpolation == 0.5);
+      assert(timeWarp.getStepsLastFrame() == 2);
+      assert(timeWarp.getName() == NULL);
+   }  // teardown
+
+   // a long hitch is not caught up
+   void realTime_dropsBacklog() const
+   {  // setup
+      TimeWarp timeWarp;
+      // exercise
+      int steps = frame(timeWarp, 10.0, 0.0078125);
+      double interpolation = timeWarp.end();
+      // verify
+      assert(steps == TimeWarp::MAX_STEPS_PER_FRAME);
+      assert(0.0 <= interpolation && interpolation < 1.0);
+      assert(frame(timeWarp, 0.0, 0.0078125) == 0);
+   }  // teardown
+
+   // ten steps where there would be one, and draw the last
+   void times10_tenTimes() const
+   {  // setup
+      TimeWarp timeWarp;
+      timeWarp.setScale(TimeWarp::TIMES_10);
+      // exercise
+      int steps = frame(timeWarp, 0.125, 0.125);
+      double interpolation = timeWarp.end();
+      // verify
+      assert(steps == 10);
+      assert(interpolation == 1.0);
+      assert(timeWarp.isWarping());
+   }  // teardown
+
+   // it stops when the budget is gone, and does not try to catch up
+   void times100_budget() const
+   {  // setup
+      TimeWarp timeWarp;
+      timeWarp.setScale(TimeWarp::TIMES_100);
+      // exercise
+      int steps = frame(timeWarp, 0.125, 0.125, 0.002 /*secondsPerStep*/, 0.01 /*budget*/);
+      timeWarp.end();
+      // verify
+      assert(steps == 5);
+      assert(frame(timeWarp, 0.0, 0.125) == 0);
+   }  // teardown
+
+   // as fast as possible: as many as fit, and at least one
+   void fastest_fillsBudget() const
+   {  // setup
+      TimeWarp timeWarp;
+      timeWarp.setScale(TimeWarp::FASTEST);
+      // exercise
+      int steps = frame(timeWarp, 0.0, 0.125, 0.001, 0.0095);
+      int stepsSlow = frame(timeWarp, 0.0, 0.125, 1.0, 0.0095);
+      // verify
+      assert(steps == 10);
+      assert(stepsSlow == 1);
+   }  // teardown
+
+   // T goes round the scales
+   void faster_cycles() const
+   {  // setup
+      TimeWarp timeWarp;
+      // exercise and verify
+      timeWarp.faster();
+      assert(timeWarp.getMultiplier() == 10.0);
+      timeWarp.faster();
+      assert(timeWarp.getMultiplier() == 100.0);
+      timeWarp.faster();
+      assert(timeWarp.getScale() == TimeWarp::FASTEST);
+      timeWarp.faster();
+      assert(timeWarp.getScale() == TimeWarp::REAL_TIME);
+   }  // teardown
+};
+
+REGISTER_TEST(TestTimeWarp);
+
+#endif /* testTimeWarp_h */
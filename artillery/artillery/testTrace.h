@@ -0,0 +1,161 @@
+/***********************************************************************
+ * Header File:
+ *    Test Trace : Test the trace spans
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    All the unit tests for Trace and TraceSpan
+ ************************************************************************/
+
+#ifndef testTrace_h
+#define testTrace_h
+
+#include "test.h"
+#include "trace.h"
+#include "parallel.h"
+#include <atomic>
+#include <cassert>
+#include <sstream>
+#include <string>
+#include <thread>
+
+using namespace std;
+
+/*******************************
+ * TEST TRACE
+ * Unit tests for recording spans and writing them out
+ ********************************/
+class TestTrace
+{
+public:
+   void run()
+   {
+      bool isEnabled = Trace::enabled.load();
+
+      span_stopped();
+      span_recorded();
+      span_sampled();
+      write_threads();
+      write_manyThreads();
+
+      if (isEnabled)
+         Trace::start();
+      else
+         Trace::stop();
+   }
+
+private:
+   // how many spans has this thread recorded?
+   size_t getCount() const
+   {
+      return Trace::getBuffer().getCount();
+   }
+
+   // nothing is recorded while tracing is stopped
+   void span_stopped() const
+   {  // setup
+      Trace::stop();
+      size_t countBefore = getCount();
+      // exercise
+      {
+         TraceSpan span("stopped");
+      }
+      // verify
+      assert(getCount() == countBefore);
+   }  // teardown
+
+   // a span records its name and a beginning before its end
+   void span_recorded() const
+   {  // setup
+      Trace::start();
+      Trace::setSampling(1);
+      size_t countBefore = getCount();
+      // exercise
+      {
+         TraceSpan span("recorded");
+      }
+      // verify
+      assert(getCount() == countBefore + 1);
+      const TraceEvent & event = Trace::getBuffer().getEvent(countBefore);
+      assert(string(event.name) == "recorded");
+      assert(event.begin <= event.end);
+   }  // teardown
+
+   // with sampling, only one frame in so many is recorded
+   void span_sampled() const
+   {  // setup
+      Trace::start();
+      Trace::setSampling(4);
+      size_t countBefore = getCount();
+      // exercise
+      for (int i = 0; i < 8; i++)
+      {
+         TraceSpan span("sampled");
+         Trace::nextFrame();
+      }
+      // verify
+      assert(getCount() == countBefore + 2);
+      // teardown
+      Trace::setSampling(1);
+   }
+
+   // each thread gets its own timeline, with its name
+   void write_threads() const
+   {  // setup
+      Trace::start();
+      std::thread worker([]()
+      {
+         Trace::setThreadName("worker");
+         TraceSpan span("on the worker");
+      });
+      worker.join();
+      {
+         TraceSpan span("on the test");
+      }
+      ostringstream sout;
+      // exercise
+      bool success = Trace::write(sout);
+      // verify
+      string json = sout.str();
+      assert(success);
+      assert(json.find("{\"traceEvents\":[") == 0);
+      assert(json.find("\"name\":\"on the worker\",\"ph\":\"X\"") != string::npos);
+      assert(json.find("\"name\":\"on the test\",\"ph\":\"X\"") != string::npos);
+      assert(json.find("\"args\":{\"name\":\"worker\"}") != string::npos);
+      assert(json.substr(json.size() - 4) == "\n]}\n");
+   }  // teardown
+
+   // threads that have finished hand their buffers on, so however many
+   // come and go, every span is written out
+   void write_manyThreads() const
+   {  // setup
+      Trace::start();
+      // exercise: 4 threads at a time, 3 of them new every time. Each
+      // waits for the others so none of them does two
+      for (int i = 0; i < 20; i++)
+      {
+         atomic <int> started(0);
+         parallelFor(4, [&started](size_t)
+         {
+            TraceSpan span("many threads");
+            started++;
+            while (started.load() < 4)
+               this_thread::yield();
+         }, 4 /*threads*/, 1 /*chunk*/);
+      }
+      ostringstream sout;
+      bool success = Trace::write(sout);
+      // verify
+      string json = sout.str();
+      assert(success);
+      int count = 0;
+      for (size_t i = json.find("\"many threads\""); i != string::npos;
+           i = json.find("\"many threads\"", i + 1))
+         count++;
+      assert(count == 20 * 4);
+   }  // teardown
+};
+
+REGISTER_TEST(TestTrace);
+
+#endif /* testTrace_h */
@@ -0,0 +1,107 @@
+/***********************************************************************
+ * Header File:
+ *    Test Viewport : Test the transform from meters to pixels
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    All the unit tests for Viewport
+ ************************************************************************/
+
+#ifndef testViewport_h
+#define testViewport_h
+
+#include "test.h"
+#include "viewport.h"
+#include <cassert>
+
+using namespace std;
+
+/*******************************
+ * TEST VIEWPORT
+ ********************************/
+class TestViewport
+{
+public:
+   void run()
+   {
+      toPixels_origin();
+      toMeters_roundTrip();
+      offset_pixels();
+      inset_center();
+      twoViewports_independent();
+   }
+
+private:
+   // the origin moves the field before it is scaled
+   void toPixels_origin() const
+   {  // setup
+      Viewport viewport(700.0, 500.0, 40.0, 1000.0, 2000.0);
+      // exercise
+      double x = viewport.toPixelsX(1400.0);
+      double y = viewport.toPixelsY(2800.0);
+      // verify
+      assert(x == 10.0);
+      assert(y == 20.0);
+      assert(viewport.getPixelsFromMeters() == 1.0 / 40.0);
+   }  // teardown
+
+   // there and back again
+   void toMeters_roundTrip() const
+   {  // setup
+      Viewport viewport(700.0, 500.0, 40.0, 1000.0, 2000.0);
+      // exercise
+      Position pos = viewport.toMeters(10.0, 20.0);
+      Position posUpperRight = viewport.getUpperRight();
+      // verify
+      assert(pos.getMetersX() == 1400.0);
+      assert(pos.getMetersY() == 2800.0);
+      assert(posUpperRight.getMetersX() == 1000.0 + 700.0 * 40.0);
+      assert(posUpperRight.getMetersY() == 2000.0 + 500.0 * 40.0);
+   }  // teardown
+
+   // an offset in pixels is the same on the screen at any zoom
+   void offset_pixels() const
+   {  // setup
+      Viewport viewport(700.0, 500.0, 40.0);
+      Position pos(4000.0, 400.0);
+      // exercise
+      Position posOffset = viewport.offset(pos, -10.0, 15.0);
+      // verify
+      assert(posOffset.getMetersX() == 4000.0 - 400.0);
+      assert(posOffset.getMetersY() == 400.0 + 600.0);
+      assert(pos.getMetersX() == 4000.0);
+   }  // teardown
+
+   // a four times inset has the point it is centered on in the middle
+   void inset_center() const
+   {  // setup
+      Viewport viewport(700.0, 500.0, 40.0);
+      // exercise
+      Viewport inset = viewport.inset(Position(14000.0, 2000.0), 4.0, 200.0, 100.0);
+      // verify
+      assert(inset.getMetersFromPixels() == 10.0);
+      assert(inset.getWidth() == 200.0);
+      assert(inset.toPixelsX(14000.0) == 100.0);
+      assert(inset.toPixelsY(2000.0) == 50.0);
+      assert(inset != viewport);
+   }  // teardown
+
+   // neither the other viewport nor Position's zoom are disturbed
+   void twoViewports_independent() const
+   {  // setup
+      double zoom = Position().getZoom();
+      Viewport viewport(700.0, 500.0, 40.0);
+      Viewport other(viewport);
+      // exercise
+      other.setZoom(10.0);
+      // verify
+      assert(viewport.toPixelsX(400.0) == 10.0);
+      assert(other.toPixelsX(400.0) == 40.0);
+      assert(other != viewport);
+      assert(Position().getZoom() == zoom);
+   }  // teardown
+};
+
+REGISTER_TEST(TestViewport);
+
+#endif /* testViewport_h */
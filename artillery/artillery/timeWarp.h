@@ -0,0 +1,116 @@
+/***********************************************************************
+ * Header File:
+ *    Time Warp : simulate faster than the wall clock
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    How many fixed simulation steps to take before the next frame. In
+ *    real time that is what the wall clock calls for. At 10x and 100x it
+ *    is ten and a hundred times that, and as fast as possible it is as
+ *    many as fit. While warping the steps stop when the frame's budget
+ *    is spent, whatever is left over is dropped, and only the last step
+ *    is drawn. The steps themselves are the same length at every scale,
+ *    so a round lands in the same place however fast we watch it.
+ ************************************************************************/
+
+#ifndef timeWarp_h
+#define timeWarp_h
+
+#include <cassert>
+#include <cmath>
+
+/*********************************************
+ * TIME WARP
+ * One frame at a time: begin(), then step()
+ * while isStepDue(), then end()
+ *********************************************/
+class TimeWarp
+{
+public:
+   enum Scale { REAL_TIME, TIMES_10, TIMES_100, FASTEST, NUM_SCALES };
+
+   TimeWarp() : scale(REAL_TIME), timeStep(1.0 / 30.0), accumulator(0.0),
+      stepsFrame(0), stepsLastFrame(1) {}
+
+   Scale getScale() const { return scale; }
+   void setScale(Scale scale)
+   {
+      assert(REAL_TIME <= scale && scale < NUM_SCALES);
+      this->scale = scale;
+      accumulator = 0.0;   // the backlog of one scale means nothing in another
+   }
+
+   // 1x, 10x, 100x, as fast as possible, and round again
+   void faster() { setScale((Scale)((scale + 1) % NUM_SCALES)); }
+
+   bool isWarping() const { return scale != REAL_TIME; }
+
+   // simulated seconds for every second of wall time, 0 for as fast as possible
+   double getMultiplier() const
+   {
+      static const double multipliers[NUM_SCALES] = { 1.0, 10.0, 100.0, 0.0 };
+      return multipliers[scale];
+   }
+
+   // "10x" and the like for the screen, NULL in real time
+   const char * getName() const
+   {
+      static const char * names[NUM_SCALES] = { NULL, "10x", "100x", "max" };
+      return names[scale];
+   }
+
+   // a frame starts, so many seconds of wall time after the last one
+   void begin(double elapsed, double timeStep)
+   {
+      assert(timeStep > 0.0);
+      this->timeStep = timeStep;
+      stepsFrame = 0;
+      accumulator += (elapsed < MAX_FRAME_TIME ? elapsed : MAX_FRAME_TIME) * getMultiplier();
+   }
+
+   // should we take another step, having spent so many seconds of the
+   // budget on this frame already? There is always at least one while
+   // warping so a slow machine still gets somewhere
+   bool isStepDue(double secondsSpent, double budget) const
+   {
+      if (scale != FASTEST && accumulator < timeStep)
+         return false;
+      if (scale == REAL_TIME)
+         return stepsFrame < MAX_STEPS_PER_FRAME;
+      return stepsFrame == 0 || secondsSpent < budget;
+   }
+
+   // one was taken
+   void step()
+   {
+      stepsFrame++;
+      if (scale != FASTEST)
+         accumulator -= timeStep;
+   }
+
+   // the frame is done. Still behind? Let it go. Returns how far between
+   // the last two steps to draw: always the last one while warping
+   double end()
+   {
+      if (accumulator >= timeStep)
+         accumulator = fmod(accumulator, timeStep);
+      stepsLastFrame = stepsFrame;
+      return isWarping() ? 1.0 : accumulator / timeStep;
+   }
+
+   // how many steps the last frame took, which is how far apart the
+   // points of a trail should be for it to look the same at any scale
+   int getStepsLastFrame() const { return stepsLastFrame; }
+
+   static constexpr double MAX_FRAME_TIME = 0.25;   // wall seconds in one frame
+   static const int MAX_STEPS_PER_FRAME = 8;        // in real time
+
+private:
+   Scale  scale;
+   double timeStep;       // simulated seconds in one step
+   double accumulator;    // simulated time not yet stepped
+   int    stepsFrame;     // taken since begin()
+   int    stepsLastFrame; // taken between the last begin() and end()
+};
+
+#endif /* timeWarp_h */
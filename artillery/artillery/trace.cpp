@@ -0,0 +1,177 @@
+/***********************************************************************
+ * Source File:
+ *    Trace : a timeline of what every thread was doing
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    Hand each thread its own buffer and write them all out in the
+ *    Chrome trace event format
+ ************************************************************************/
+
+#include "trace.h"
+#include <cassert>
+#include <fstream>
+
+using namespace std;
+
+/************************************************************************
+ * TRACE : SET SAMPLING
+ * Record every frame (1), every other frame (2), and so on
+ *************************************************************************/
+void Trace::setSampling(int everyFrames)
+{
+   assert(everyFrames >= 1);
+   sampling.store(everyFrames, memory_order_relaxed);
+}
+
+/************************************************************************
+ * TRACE SLOT
+ * A thread's hold on its buffer. When the thread ends, the buffer goes
+ * back for the next thread to take, spans and all: the two share a
+ * timeline, one after the other. A thread that found every slot taken
+ * had a buffer of its own, which nobody will write out
+ *************************************************************************/
+struct TraceSlot
+{
+   TraceSlot() : pBuffer(nullptr), slot(-1) {}
+   ~TraceSlot()
+   {
+      if (slot >= 0)
+         Trace::release(slot);
+      else
+         delete pBuffer;
+   }
+
+   TraceBuffer * pBuffer;
+   int slot;
+};
+
+/************************************************************************
+ * TRACE : GET BUFFER
+ * The current thread's buffer, taken the first time it records a span:
+ * the first slot nobody holds, made if nobody has used it yet
+ *************************************************************************/
+TraceBuffer & Trace::getBuffer()
+{
+   thread_local TraceSlot slot;
+   if (slot.pBuffer == nullptr)
+   {
+      for (int i = 0; i < MAX_THREADS && slot.slot < 0; i++)
+      {
+         bool isHeld = false;
+         if (held[i].compare_exchange_strong(isHeld, true, memory_order_acquire))
+            slot.slot = i;
+      }
+
+      if (slot.slot < 0)
+         slot.pBuffer = new TraceBuffer(MAX_THREADS);
+      else
+      {
+         slot.pBuffer = buffers[slot.slot].load(memory_order_acquire);
+         if (slot.pBuffer == nullptr)
+         {
+            slot.pBuffer = new TraceBuffer(slot.slot);
+            buffers[slot.slot].store(slot.pBuffer, memory_order_release);
+         }
+      }
+   }
+   return *slot.pBuffer;
+}
+
+/************************************************************************
+ * TRACE : RELEASE
+ * A thread is done with its slot
+ *************************************************************************/
+void Trace::release(int slot)
+{
+   assert(slot >= 0 && slot < MAX_THREADS);
+   held[slot].store(false, memory_order_release);
+}
+
+/************************************************************************
+ * WRITE STRING
+ * A name as a JSON string
+ *************************************************************************/
+static void writeString(ostream & out, const char * text)
+{
+   out << '"';
+   for (const char * p = text; *p; p++)
+   {
+      if (*p == '"' || *p == '\\')
+         out << '\\';
+      out << *p;
+   }
+   out << '"';
+}
+
+/************************************************************************
+ * TRACE : WRITE
+ * Every span every thread has finished, as complete ("X") events with
+ * times in microseconds, plus the name of each thread. Threads may keep
+ * recording while we write; we take what was there when we got to it.
+ *************************************************************************/
+bool Trace::write(ostream & out)
+{
+   out << "{\"traceEvents\":[";
+   bool isFirst = true;
+
+   for (int iBuffer = 0; iBuffer < MAX_THREADS; iBuffer++)
+   {
+      const TraceBuffer * pBuffer = buffers[iBuffer].load(memory_order_acquire);
+      if (pBuffer == nullptr)
+         continue;
+
+      const char * name = pBuffer->getName();
+      if (name != nullptr)
+      {
+         out << (isFirst ? "\n" : ",\n")
+             << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+             << pBuffer->getId() << ",\"args\":{\"name\":";
+         writeString(out, name);
+         out << "}}";
+         isFirst = false;
+      }
+
+      size_t count = pBuffer->getCount();
+      for (size_t i = 0; i < count; i++)
+      {
+         const TraceEvent & event = pBuffer->getEvent(i);
+         out << (isFirst ? "\n" : ",\n") << "{\"name\":";
+         writeString(out, event.name);
+         out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << pBuffer->getId()
+             << ",\"ts\":" << event.begin / 1000 << '.' << (event.begin % 1000) / 100
+             << ",\"dur\":" << (event.end - event.begin) / 1000 << '.'
+             << ((event.end - event.begin) % 1000) / 100 << "}";
+         isFirst = false;
+      }
+   }
+
+   out << "\n]}\n";
+   return !out.fail();
+}
+
+/************************************************************************
+ * TRACE : WRITE
+ * Everything recorded so far into a .json file
+ *************************************************************************/
+bool Trace::write(const char * fileName)
+{
+   ofstream fout(fileName);
+   if (fout.fail())
+      return false;
+   return write(fout);
+}
+
+/***************************************************
+ * STATICS
+ **************************************************/
+#ifdef TRACE_SPANS
+atomic <bool>      Trace::enabled(true);    // the build asked for it
+#else
+atomic <bool>      Trace::enabled(false);
+#endif // TRACE_SPANS
+atomic <int>       Trace::sampling(1);
+atomic <long long> Trace::frame(0);
+const chrono::steady_clock::time_point Trace::timeOrigin = chrono::steady_clock::now();
+atomic <TraceBuffer *> Trace::buffers[Trace::MAX_THREADS];
+atomic <bool>      Trace::held[Trace::MAX_THREADS];
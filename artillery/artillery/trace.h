@@ -0,0 +1,169 @@
+/***********************************************************************
+ * Header File:
+ *    Trace : a timeline of what every thread was doing
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    Mark a block with TRACE_SPAN("name") and, while tracing, when it
+ *    started and finished goes into a buffer belonging to the thread
+ *    that ran it. Trace::write() turns all the buffers into the Chrome
+ *    trace event format, which loads in chrome://tracing or Perfetto.
+ *
+ *    The spans only exist when built with TRACE_SPANS defined, so a
+ *    normal build pays nothing. With it defined, they cost a load and
+ *    a branch when tracing is stopped, and setSampling() records only
+ *    one frame in so many to keep long runs small.
+ ************************************************************************/
+
+#ifndef trace_h
+#define trace_h
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>   // for size_t
+#include <ostream>
+
+class TestTrace;
+struct TraceSlot;
+
+/*************************************************************************
+ * TRACE EVENT
+ * One span: a name (always a string literal) and when it began and
+ * ended, in nanoseconds since the program started tracing
+ *************************************************************************/
+struct TraceEvent
+{
+   const char * name;
+   long long begin;
+   long long end;
+};
+
+/*************************************************************************
+ * TRACE BUFFER
+ * The spans of one thread at a time. Only that thread adds to it;
+ * anybody may read the spans it has finished. When it is full, spans
+ * are dropped.
+ *************************************************************************/
+class TraceBuffer
+{
+public:
+   TraceBuffer(int id) : id(id), name(nullptr), count(0), dropped(0) {}
+
+   void add(const char * name, long long begin, long long end)
+   {
+      size_t i = count.load(std::memory_order_relaxed);
+      if (i == CAPACITY)
+      {
+         dropped++;
+         return;
+      }
+      events[i].name = name;
+      events[i].begin = begin;
+      events[i].end = end;
+      count.store(i + 1, std::memory_order_release);
+   }
+
+   int    getId()    const { return id; }
+   size_t getCount() const { return count.load(std::memory_order_acquire); }
+   const TraceEvent & getEvent(size_t i) const { return events[i]; }
+   const char * getName() const { return name.load(std::memory_order_acquire); }
+   void setName(const char * name) { this->name.store(name, std::memory_order_release); }
+
+   static const size_t CAPACITY = 1 << 16;   // 1.5MB a thread
+
+private:
+   int id;
+   std::atomic <const char *> name;
+   std::atomic <size_t> count;
+   size_t dropped;
+   TraceEvent events[CAPACITY];
+};
+
+/*************************************************************************
+ * TRACE
+ * Everything is static so any code on any thread can mark a span
+ *************************************************************************/
+class Trace
+{
+public:
+   // start and stop recording
+   static void start() { enabled.store(true,  std::memory_order_relaxed); }
+   static void stop()  { enabled.store(false, std::memory_order_relaxed); }
+
+   // only record one frame out of every so many
+   static void setSampling(int everyFrames);
+   static void nextFrame() { frame.fetch_add(1, std::memory_order_relaxed); }
+
+   static bool isRecording()
+   {
+      return enabled.load(std::memory_order_relaxed) &&
+         frame.load(std::memory_order_relaxed) % sampling.load(std::memory_order_relaxed) == 0;
+   }
+
+   // nanoseconds since we started keeping time
+   static long long now()
+   {
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(
+         std::chrono::steady_clock::now() - timeOrigin).count();
+   }
+
+   // what to call the current thread in the viewer. Must be a literal
+   static void setThreadName(const char * name) { getBuffer().setName(name); }
+
+   // the current thread's span is done
+   static void add(const char * name, long long begin, long long end)
+   {
+      getBuffer().add(name, begin, end);
+   }
+
+   // write everything recorded so far as Chrome trace event JSON
+   static bool write(std::ostream & out);
+   static bool write(const char * fileName);
+
+   friend TestTrace;
+   friend struct TraceSlot;
+
+private:
+   static TraceBuffer & getBuffer();
+   static void release(int slot);
+
+   static const int MAX_THREADS = 16;   // recording at once
+
+   static std::atomic <bool> enabled;
+   static std::atomic <int> sampling;
+   static std::atomic <long long> frame;
+   static const std::chrono::steady_clock::time_point timeOrigin;
+   static std::atomic <TraceBuffer *> buffers[MAX_THREADS];
+   static std::atomic <bool> held[MAX_THREADS];   // by a running thread
+};
+
+/*************************************************************************
+ * TRACE SPAN
+ * Record from here to the end of the enclosing block
+ *************************************************************************/
+class TraceSpan
+{
+public:
+   TraceSpan(const char * name) : name(name), begin(Trace::isRecording() ? Trace::now() : -1) {}
+   ~TraceSpan()
+   {
+      if (begin >= 0)
+         Trace::add(name, begin, Trace::now());
+   }
+
+private:
+   const char * name;
+   long long begin;
+};
+
+#ifdef TRACE_SPANS
+#define TRACE_CONCAT2(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT2(a, b)
+#define TRACE_SPAN(name) TraceSpan TRACE_CONCAT(traceSpan, __LINE__)(name)
+#define TRACE_THREAD(name) Trace::setThreadName(name)
+#else
+#define TRACE_SPAN(name)
+#define TRACE_THREAD(name)
+#endif // TRACE_SPANS
+
+#endif /* trace_h */
@@ -0,0 +1,205 @@
+/***********************************************************************
+ * Source File:
+ *    Trajectory : fly one shot without a screen
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    Follow a round step by step the way the game does
+ ************************************************************************/
+
+#include "trajectory.h"
+#include "ammunition.h"
+#include "drag.h"
+#include "dual.h"
+#include "position.h"
+#include <cassert>
+
+using namespace std;
+
+/************************************************************************
+ * GET POINT
+ * Where a round is right now
+ *************************************************************************/
+template <class T>
+static TrajectoryPoint getPoint(const AmmunitionT <T> & ammo, double time)
+{
+   TrajectoryPoint point;
+   point.time = time;
+   point.x = ammo.getPosition().getMetersX();
+   point.y = ammo.getPosition().getMetersY();
+   point.dx = ammo.getVelocity().getMetersX();
+   point.dy = ammo.getVelocity().getMetersY();
+   return point;
+}
+
+/************************************************************************
+ * TRAJECTORY : FLY
+ * Over flat ground at the altitude it was fired from
+ *************************************************************************/
+void Trajectory::fly(const Shot & shot, int maxSteps)
+{
+   double altitude = shot.altitude;
+   fly(shot, [altitude](double) { return altitude; }, maxSteps);
+}
+
+/************************************************************************
+ * TRAJECTORY : FLY
+ * Over any ground, in the precision we were made with
+ *************************************************************************/
+void Trajectory::fly(const Shot & shot, const GroundAt & groundAt, int maxSteps)
+{
+   if (precision == FLOAT)
+      flyWith <float> (shot, groundAt, maxSteps);
+   else
+      flyWith <double> (shot, groundAt, maxSteps);
+}
+
+/************************************************************************
+ * TRAJECTORY : FLY WITH
+ * Fire from (0, altitude) and, every step, apply the drag and advance
+ * until the round goes below the ground. The impact is found by
+ * interpolating the height above the ground between the last two
+ * steps. The round is launched quietly, unlike the game's fire(), and
+ * at exactly the angle of the shot.
+ * The points are doubles whatever the physics ran on.
+ *    INPUT  shot      how it was fired
+ *           groundAt  the elevation of the ground down range
+ *           maxSteps  when to give up on it coming down
+ *************************************************************************/
+template <class T>
+void Trajectory::flyWith(const Shot & shot, const GroundAt & groundAt, int maxSteps)
+{
+   assert(shot.velocity > 0.0);
+   points.clear();
+   landed = false;
+
+   PositionT <T> posHowitzer(0.0, (T)shot.altitude);
+   AmmunitionT <T> ammo(TRIPLE7_AREA, shot.mass, posHowitzer);
+   ammo.launchRadians((T)shot.velocity, (T)(shot.angle * PI / 180.0));
+   DragT <T> drag(&ammo);
+   TrajectoryPoint after = getPoint(ammo, 0.0);
+   double heightAfter = after.y - groundAt(after.x);   // groundAt(0) need not be the shot's altitude
+   points.push_back(after);
+
+   for (int step = 1; step <= maxSteps && !landed; step++)
+   {
+      ammo.applyDrag(drag.getAcceleration());
+      ammo.advance();
+      TrajectoryPoint before = after;
+      double heightBefore = heightAfter;
+      after = getPoint(ammo, (double)step);
+      heightAfter = after.y - groundAt(after.x);
+      if (isRecording)
+         points.push_back(after);
+
+      // did it go into the ground?
+      if (heightAfter < 0.0)
+      {
+         double fraction = heightBefore / (heightBefore - heightAfter);
+         impact.time = before.time + fraction * (after.time - before.time);
+         impact.x    = before.x    + fraction * (after.x    - before.x);
+         impact.y    = before.y    + fraction * (after.y    - before.y);
+         impact.dx   = before.dx   + fraction * (after.dx   - before.dx);
+         impact.dy   = before.dy   + fraction * (after.dy   - before.dy);
+         landed = true;
+      }
+   }
+
+   if (!isRecording)
+      points.push_back(after);
+}
+
+/************************************************************************
+ * TRAJECTORY : FINISH
+ * The rest of a flight the game started, as fast as it will go. The
+ * round is left where the game would find it: on the first step below
+ * the ground, its trail behind it.
+ *    INPUT  ammo      the round, in the air
+ *           groundAt  the elevation of the ground under x
+ *           maxSteps  when to give up on it coming down
+ *************************************************************************/
+int Trajectory::finish(Ammunition & ammo, const GroundAt & groundAt, int maxSteps)
+{
+   Drag drag(&ammo);
+   for (int step = 1; step <= maxSteps; step++)
+   {
+      ammo.applyDrag(drag.getAcceleration());
+      ammo.advance();
+      Position pos = ammo.getPosition();
+      if (pos.getMetersY() < groundAt(pos.getMetersX()))
+         return step;
+   }
+   return -1;
+}
+
+/************************************************************************
+ * TRAJECTORY : FLY SENSITIVITY
+ * The same flight as fly() over flat ground, step for step, but the
+ * angle and the velocity are the two inputs of a Dual. The impact is
+ * interpolated the same way, so the derivatives are those of exactly
+ * the range fly() reports.
+ *************************************************************************/
+Sensitivity Trajectory::flySensitivity(const Shot & shot, int maxSteps)
+{
+   return flySensitivityTo(shot, shot.altitude, maxSteps);
+}
+
+/************************************************************************
+ * TRAJECTORY : FLY SENSITIVITY TO
+ * The same over flat ground at another altitude. A round fired below
+ * it must climb through it before it can come down through it, so it
+ * has only landed when it goes from above to below. One that starts
+ * down while still below it never will: then where it did is kept, to
+ * say how close a steeper round could come down.
+ *************************************************************************/
+Sensitivity Trajectory::flySensitivityTo(const Shot & shot, double altitude, int maxSteps)
+{
+   typedef Dual <2> Scalar;   // d/d(angle in degrees), d/d(velocity)
+   assert(shot.velocity > 0.0);
+
+   Scalar angle = Scalar::variable(shot.angle, 0);
+   Scalar velocity = Scalar::variable(shot.velocity, 1);
+
+   PositionT <Scalar> posHowitzer(0.0, shot.altitude);
+   AmmunitionT <Scalar> ammo(TRIPLE7_AREA, shot.mass, posHowitzer);
+   ammo.launchRadians(velocity, angle * PI / 180.0);
+   DragT <Scalar> drag(&ammo);
+
+   Sensitivity sensitivity = { 0.0, 0.0, 0.0, 0.0, 0.0, false };
+   PositionT <Scalar> after = ammo.getPosition();
+   Scalar heightAfter = shot.altitude - altitude;
+   for (int step = 1; step <= maxSteps; step++)
+   {
+      double dyBefore = ammo.getVelocity().getMetersY().getValue();
+      ammo.applyDrag(drag.getAcceleration());
+      ammo.advance();
+      PositionT <Scalar> before = after;
+      Scalar heightBefore = heightAfter;
+      after = ammo.getPosition();
+      heightAfter = after.getMetersY() - altitude;
+
+      // the top is where it stopped climbing, between the two steps
+      double dyAfter = ammo.getVelocity().getMetersY().getValue();
+      if (dyBefore > 0.0 && dyAfter <= 0.0)
+      {
+         double fraction = dyBefore / (dyBefore - dyAfter);
+         sensitivity.rangeTop = before.getMetersX().getValue() +
+            fraction * (after.getMetersX().getValue() - before.getMetersX().getValue());
+      }
+
+      if (heightAfter < 0.0 && heightBefore >= 0.0)
+      {
+         Scalar fraction = heightBefore / (heightBefore - heightAfter);
+         Scalar range = before.getMetersX() + fraction * (after.getMetersX() - before.getMetersX());
+         sensitivity.range = range.getValue();
+         sensitivity.rangePerDegree = range.getDerivative(0);
+         sensitivity.rangePerVelocity = range.getDerivative(1);
+         sensitivity.time = (step - 1) + fraction.getValue();
+         sensitivity.landed = true;
+         break;
+      }
+      if (heightAfter < 0.0 && after.getMetersY() < before.getMetersY())
+         break;
+   }
+   return sensitivity;
+}
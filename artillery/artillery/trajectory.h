@@ -0,0 +1,127 @@
+/***********************************************************************
+ * Header File:
+ *    Trajectory : fly one shot without a screen
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    The same physics the game runs every step (drag, then advance)
+ *    with no window, no input and no random ground, so a shot can be
+ *    flown as fast as the CPU allows and always lands in the same place.
+ ************************************************************************/
+
+#ifndef trajectory_h
+#define trajectory_h
+
+#include "constants.h"   // for TRIPLE7_MASS
+#include <functional>
+#include <vector>
+
+template <class T> class AmmunitionT;
+
+/*********************************************
+ * TRAJECTORY POINT
+ * Where the round is after so many steps
+ *********************************************/
+struct TrajectoryPoint
+{
+   double time;   // steps since it was fired. Each is a second
+   double x;      // meters down range
+   double y;      // meters of altitude
+   double dx;     // meters/second
+   double dy;     // meters/second
+};
+
+/*********************************************
+ * SHOT
+ * How a round is fired
+ *********************************************/
+struct Shot
+{
+   double angle;      // degrees above the horizon
+   double velocity;   // muzzle velocity in meters/second
+   double altitude;   // of the howitzer and the (flat) ground, in meters
+   double mass = TRIPLE7_MASS;   // kilograms
+};
+
+/*********************************************
+ * PRECISION
+ * The scalar the physics runs on. FLOAT is
+ * close enough for Monte Carlo but not for
+ * aiming: see the study in precisionDriver.cpp
+ *********************************************/
+enum Precision { DOUBLE, FLOAT };
+
+/*********************************************
+ * SENSITIVITY
+ * Where a round lands on flat ground, and how
+ * far that moves as the way it is fired moves
+ *********************************************/
+struct Sensitivity
+{
+   double range;              // meters down range
+   double rangePerDegree;     // d(range) / d(angle)
+   double rangePerVelocity;   // d(range) / d(velocity), per meter/second
+   double time;               // of flight, in seconds
+   double rangeTop;           // meters down range of the top of the flight
+   bool landed;
+};
+
+/*********************************************
+ * TRAJECTORY
+ * The flight of one round over flat ground
+ *********************************************/
+class Trajectory
+{
+public:
+   // only remember every point if we are going to look at them
+   Trajectory(bool isRecording = true, Precision precision = DOUBLE) :
+      isRecording(isRecording), precision(precision), landed(false) {}
+
+   // the elevation of the ground, in meters, so many meters down range
+   typedef std::function <double (double)> GroundAt;
+
+   // fire and follow the round until it hits the ground or we give up
+   void fly(const Shot & shot, int maxSteps = MAX_STEPS);
+
+   // the same, over ground that is not flat
+   void fly(const Shot & shot, const GroundAt & groundAt, int maxSteps = MAX_STEPS);
+
+   // fly on Dual numbers, so the impact comes with its exact derivatives
+   // for the price of one flight. Over flat ground, and nothing is recorded
+   static Sensitivity flySensitivity(const Shot & shot, int maxSteps = MAX_STEPS);
+
+   // the same, landing where it comes down through another altitude,
+   // such as that of a target on a hill. Not landed if it never gets
+   // that high
+   static Sensitivity flySensitivityTo(const Shot & shot, double altitude,
+                                       int maxSteps = MAX_STEPS);
+
+   // skip to the impact: step a round that is already in the air the
+   // way the game does until it goes below the ground, drawing none of
+   // it. Here the ground is under x in the same meters as the round.
+   // Returns the steps taken, or -1 if it was still flying after maxSteps
+   static int finish(AmmunitionT <double> & ammo, const GroundAt & groundAt,
+                     int maxSteps = MAX_STEPS);
+
+   // every step, or just the first and the last if we are not recording
+   const std::vector <TrajectoryPoint> & getPoints() const { return points; }
+   bool hasLanded() const { return landed; }
+
+   // where it crossed the ground, between the last two steps
+   const TrajectoryPoint & getImpact() const { return impact; }
+
+   static const int MAX_STEPS = 10000;
+
+private:
+   // fly() on one scalar or another
+   template <class T>
+   void flyWith(const Shot & shot, const GroundAt & groundAt, int maxSteps);
+
+   std::vector <TrajectoryPoint> points;
+   TrajectoryPoint impact;
+   bool isRecording;
+   Precision precision;
+   bool landed;
+};
+
+#endif /* trajectory_h */
@@ -40,6 +40,7 @@
 
 #include "position.h"
 #include "uiDraw.h"
+#include "uiRecord.h"
 
 using namespace std;
 
@@ -55,11 +56,34 @@ inline void glResetColor()
 
 /*************************************************************************
  * GL VERTEXT POINT
- * Just a more convenient format of glVertext2f
+ * Just a more convenient format of glVertext2f, from meters to pixels
  *************************************************************************/
-inline void glVertexPoint(const Position & pos)
+inline void glVertexPoint(const Viewport & viewport, const Position & pos)
 {
-   glVertex2f((GLfloat)pos.getPixelsX(), (GLfloat)pos.getPixelsY());
+   glVertex2f((GLfloat)viewport.toPixelsX(pos.getMetersX()),
+              (GLfloat)viewport.toPixelsY(pos.getMetersY()));
+}
+
+/*************************************************************************
+ * GL QUAD PIXELS
+ * Emit the four corners of an axis-aligned rectangle given in pixels
+ *************************************************************************/
+inline void glQuadPixels(double x0, double y0, double x1, double y1)
+{
+   glVertex2f((GLfloat)x0, (GLfloat)y0);
+   glVertex2f((GLfloat)x0, (GLfloat)y1);
+   glVertex2f((GLfloat)x1, (GLfloat)y1);
+   glVertex2f((GLfloat)x1, (GLfloat)y0);
+}
+
+/*************************************************************************
+ * GL QUAD POINTS
+ * The same, for a rectangle given in meters
+ *************************************************************************/
+inline void glQuadPoints(const Viewport & viewport, const Position & begin, const Position & end)
+{
+   glQuadPixels(viewport.toPixelsX(begin.getMetersX()), viewport.toPixelsY(begin.getMetersY()),
+                viewport.toPixelsX(end.getMetersX()),   viewport.toPixelsY(end.getMetersY()));
 }
 
 /*************************************************************************
@@ -77,7 +101,7 @@ void ogstream :: flush()
 	  {
 		 drawText(pos, sOut.c_str());
 		 sOut.clear();
-		 pos.addPixelsY(-18);
+		 pos = viewport.offset(pos, 0.0, -18.0);
 	  }
 	  // othewise append
 	  else
@@ -87,7 +111,7 @@ void ogstream :: flush()
    if (!sOut.empty())
    {
 	  drawText(pos, sOut.c_str());
-	  pos.addPixelsY(-18);
+	  pos = viewport.offset(pos, 0.0, -18.0);
    }
    
    // reset the buffer
@@ -105,7 +129,8 @@ void ogstream :: drawText(const Position & topLeft, const char * text)
    void *pFont = GLUT_TEXT;
 
    // prepare to draw the text from the top-left corner
-   glRasterPos2f((GLfloat)topLeft.getPixelsX(), (GLfloat)topLeft.getPixelsY());
+   glRasterPos2f((GLfloat)viewport.toPixelsX(topLeft.getMetersX()),
+                 (GLfloat)viewport.toPixelsY(topLeft.getMetersY()));
 
    // loop through the text
    for (const char *p = text; *p; p++)
@@ -124,12 +149,8 @@ void ogstream :: drawProjectile(const Position& pos, double age)
 
    GLfloat color = (GLfloat)(age / tailLength);
    
-   Position posBegin;
-   Position posEnd;
-   posBegin.setPixelsX(pos.getPixelsX() - 1.5);
-   posBegin.setPixelsY(pos.getPixelsY() - 1.5);
-   posEnd.setPixelsX(pos.getPixelsX() + 1.5);
-   posEnd.setPixelsY(pos.getPixelsY() + 1.5);
+   Position posBegin = viewport.offset(pos, -1.5, -1.5);
+   Position posEnd   = viewport.offset(pos,  1.5,  1.5);
    drawRectangle(posBegin, posEnd, color /* red % */, color /* green % */, color /* blue % */);
 }
 
@@ -148,8 +169,8 @@ void ogstream :: drawLine(const Position & begin, const Position & end,
    glColor3f((GLfloat)red, (GLfloat)green, (GLfloat)blue);
 
    // Draw the actual line
-   glVertexPoint(begin);
-   glVertexPoint(end);
+   glVertexPoint(viewport, begin);
+   glVertexPoint(viewport, end);
 
    // Complete drawing
    glResetColor();
@@ -171,10 +192,7 @@ void ogstream :: drawRectangle(const Position & begin, const Position & end,
    glColor3f((GLfloat)red, (GLfloat)green, (GLfloat)blue);
    
    // Draw the actual line
-   glVertex2f((GLfloat)begin.getPixelsX(), (GLfloat)begin.getPixelsY());
-   glVertex2f((GLfloat)begin.getPixelsX(), (GLfloat)end.getPixelsY());
-   glVertex2f((GLfloat)end.getPixelsX(),   (GLfloat)end.getPixelsY());
-   glVertex2f((GLfloat)end.getPixelsX(),   (GLfloat)begin.getPixelsY());
+   glQuadPoints(viewport, begin, end);
    
    // Complete drawing
    glResetColor();
@@ -182,6 +200,185 @@ void ogstream :: drawRectangle(const Position & begin, const Position & end,
 }
 
 
+/***********************************************************************
+ * DRAW CACHE
+ * Draw geometry that was recorded ahead of time. The first time we see
+ * the cache (or whenever it changes) we compile it into an OpenGL display
+ * list, batching runs of the same primitive into one glBegin()/glEnd().
+ * Every frame after that is a single glCallList().
+ *    cache    The recorded geometry
+ ***********************************************************************/
+void ogstream :: drawCache(const DrawCache & cache)
+{
+   if (cache.empty())
+      return;
+
+   // compile the geometry if it changed since last time
+   if (cache.idList == 0 ||
+       cache.idGeneration != cache.generation ||
+       cache.idViewport != viewport)
+   {
+      if (cache.idList == 0)
+         cache.idList = glGenLists(1);
+      glNewList(cache.idList, GL_COMPILE);
+
+      const vector <DrawCache::Primitive> & primitives = cache.primitives;
+      size_t i = 0;
+      while (i < primitives.size())
+      {
+         DrawCache::Type type = primitives[i].type;
+
+         // text cannot go in a glBegin()/glEnd() pair
+         if (type == DrawCache::TEXT)
+         {
+            drawText(primitives[i].begin, primitives[i].text.c_str());
+            i++;
+            continue;
+         }
+
+         // one batch for the whole run of lines or rectangles
+         glBegin(type == DrawCache::LINE ? GL_LINES : GL_QUADS);
+         for (; i < primitives.size() && primitives[i].type == type; i++)
+         {
+            const DrawCache::Primitive & primitive = primitives[i];
+            glColor3f((GLfloat)primitive.red, (GLfloat)primitive.green, (GLfloat)primitive.blue);
+            if (type == DrawCache::LINE)
+            {
+               glVertexPoint(viewport, primitive.begin);
+               glVertexPoint(viewport, primitive.end);
+            }
+            else
+            {
+               glQuadPoints(viewport, primitive.begin, primitive.end);
+            }
+         }
+         glResetColor();
+         glEnd();
+      }
+
+      glEndList();
+      cache.idGeneration = cache.generation;
+      cache.idViewport = viewport;
+   }
+
+   glCallList(cache.idList);
+}
+
+/***********************************************************************
+ * DRAW CACHE : REPLAY
+ * Send each recorded primitive through the ordinary ogstream methods.
+ * This is what back-ends without a compiled form (and the unit tests) use.
+ *    gout     Where the primitives are drawn
+ ***********************************************************************/
+void DrawCache :: replay(ogstream & gout) const
+{
+   for (vector <Primitive> :: const_iterator it = primitives.begin(); it != primitives.end(); ++it)
+      switch (it->type)
+      {
+         case LINE:
+            gout.drawLine(it->begin, it->end, it->red, it->green, it->blue);
+            break;
+         case RECTANGLE:
+            gout.drawRectangle(it->begin, it->end, it->red, it->green, it->blue);
+            break;
+         case TEXT:
+            gout.drawText(it->begin, it->text.c_str());
+            break;
+      }
+}
+
+/***********************************************************************
+ * DRAW CACHE : DESTRUCTOR
+ * Give the compiled form back to OpenGL
+ ***********************************************************************/
+DrawCache :: ~DrawCache()
+{
+   if (idList != 0)
+      glDeleteLists(idList, 1);
+}
+
+/***********************************************************************
+ * DRAW BUFFER
+ * Play back recorded draw commands. Consecutive lines go out in one
+ * GL_LINES batch and consecutive rectangles, projectiles, and targets
+ * go out in one GL_QUADS batch, so a typical frame is a handful of
+ * glBegin()/glEnd() pairs. The order of the commands is preserved.
+ *    buffer   The recorded commands
+ ***********************************************************************/
+void ogstream :: drawBuffer(const DrawBuffer & buffer)
+{
+   const vector <DrawCommand> & commands = buffer.getCommands();
+   size_t i = 0;
+   while (i < commands.size())
+   {
+      DrawCommand::Type type = commands[i].type;
+      bool isLine = (type == DrawCommand::LINE);
+      bool isQuad = (type == DrawCommand::RECTANGLE ||
+                     type == DrawCommand::PROJECTILE ||
+                     type == DrawCommand::TARGET);
+
+      // the rest do not fit in a glBegin()/glEnd() pair
+      if (!isLine && !isQuad)
+      {
+         const DrawCommand & command = commands[i++];
+         if (type == DrawCommand::HOWITZER)
+            drawHowitzer(DrawBuffer::getBegin(command), (double)command.x1, (double)command.y1);
+         else if (type == DrawCommand::TEXT)
+            drawText(DrawBuffer::getBegin(command), buffer.getText(command));
+         else
+            drawCache(buffer.getCache(command));
+         continue;
+      }
+
+      glBegin(isLine ? GL_LINES : GL_QUADS);
+      for (; i < commands.size(); i++)
+      {
+         const DrawCommand & command = commands[i];
+         Position posBegin = DrawBuffer::getBegin(command);
+         double xPixels = viewport.toPixelsX(posBegin.getMetersX());
+         double yPixels = viewport.toPixelsY(posBegin.getMetersY());
+
+         if (isLine && command.type == DrawCommand::LINE)
+         {
+            glColor3ub(command.red, command.green, command.blue);
+            glVertexPoint(viewport, posBegin);
+            glVertexPoint(viewport, DrawBuffer::getEnd(command));
+         }
+         else if (isQuad && command.type == DrawCommand::RECTANGLE)
+         {
+            glColor3ub(command.red, command.green, command.blue);
+            glQuadPoints(viewport, posBegin, DrawBuffer::getEnd(command));
+         }
+         else if (isQuad && command.type == DrawCommand::PROJECTILE)
+         {
+            // same as drawProjectile()
+            GLfloat color = (GLfloat)(command.x1 / 5.0);
+            glColor3f(color, color, color);
+            glQuadPixels(xPixels - 1.5, yPixels - 1.5, xPixels + 1.5, yPixels + 1.5);
+         }
+         else if (isQuad && command.type == DrawCommand::TARGET)
+         {
+            // same as drawTarget()
+            glColor3f((GLfloat)0.2, (GLfloat)0.75, (GLfloat)0.2);
+            glQuadPixels(xPixels - 5.0, yPixels - 5.0, xPixels + 5.0, yPixels + 5.0);
+         }
+         else
+            break;
+      }
+      glResetColor();
+      glEnd();
+   }
+}
+
+/***********************************************************************
+ * DUMMY : DRAW BUFFER
+ * No graphics here: hand each command to the individual draw methods
+ ***********************************************************************/
+void ogstreamDummy :: drawBuffer(const DrawBuffer & buffer)
+{
+   buffer.replay(*this);
+}
+
 /***********************************************************************
  * DRAW Target
  * Draw a target on the screen at a given point
@@ -195,11 +392,10 @@ void ogstream :: drawTarget(const Position& pos)
    glBegin(GL_QUADS);
    glColor3f((GLfloat)0.2 /* red % */, (GLfloat)0.75 /* green % */, (GLfloat)0.2 /* blue % */);
 
-   // specify the corners
-   glVertex2f((GLfloat)(pos.getPixelsX() - size/2.0), (GLfloat)(pos.getPixelsY() - size/2.0));
-   glVertex2f((GLfloat)(pos.getPixelsX() - size/2.0), (GLfloat)(pos.getPixelsY() + size/2.0));
-   glVertex2f((GLfloat)(pos.getPixelsX() + size/2.0), (GLfloat)(pos.getPixelsY() + size/2.0));
-   glVertex2f((GLfloat)(pos.getPixelsX() + size/2.0), (GLfloat)(pos.getPixelsY() - size/2.0));
+   // specify the corners, in pixels so it is the same size at any zoom
+   double xPixels = viewport.toPixelsX(pos.getMetersX());
+   double yPixels = viewport.toPixelsY(pos.getMetersY());
+   glQuadPixels(xPixels - size/2.0, yPixels - size/2.0, xPixels + size/2.0, yPixels + size/2.0);
 
    // done
    glResetColor();
@@ -207,28 +403,31 @@ void ogstream :: drawTarget(const Position& pos)
 }
 
 /***********************************************************************
- * DRAW Howitzer
- * Draw a howitzer on the screen at a given point
- *    point    The position of the Howitzer on the screen
+ * GET HOWITZER SHAPE
+ * Work out where the lines of the howitzer go. This is shared by every
+ * back-end so they all draw the same gun.
+ *    pos      The position of the Howitzer on the screen
  *    angle    The angle of the barrel where 0 is straight up
- *    age      Seconds since the howitzer was fired
+ *    strip    OUTPUT: HOWITZER_STRIP points to be joined by a line strip
+ *    flash    OUTPUT: HOWITZER_FLASH muzzle flash lines, least intense first
  ***********************************************************************/
-void ogstream :: drawHowitzer(const Position & pos, double angle, double age)
+void ogstream :: getHowitzerShape(const Position & pos, double angle,
+                                  Position strip[], Position flash[][2])
 {
    // outline for the Barrel, the Base, and the muzzle flash
-   PT pointsBarrel[] =
+   static const PT pointsBarrel[] =
    {
 	  {0, 0},  {-1, 18}, {1, 18}, {0, 0},  // barrell
 	  {-2, 2}, {-2, 10}, {2, 10}, {2, 2}, {0, 0}  // recoil
    };
-   PT pointsBase[] =
+   static const PT pointsBase[] =
    {
 	  {-3, 1}, {-4, 0}, {-6, 0}, {-7, 1}, {-7, 3}, {-6, 4}, {-4, 4},  // left wheel
 	  {-3, 3}, {0, 5}, {3, 3},  // middle part
 	  {4, 4}, {6, 4},{7, 3},{7, 1},{6, 0},{4, 0},{3, 1},  // right wheel
 	  {-3, 1}
    };
-   PT pointsMuzzleFlash[10][2] =
+   static const PT pointsMuzzleFlash[HOWITZER_FLASH][2] =
    {
 	  { {-11,21}, {11,21} },      // least intense
 	  { {-11,19}, {11,19} },
@@ -241,22 +440,46 @@ void ogstream :: drawHowitzer(const Position & pos, double angle, double age)
 	  { { -5,20}, { 5,20} },
 	  { { -2,20}, { 2,20} }      // most intense
    };
+   const int numBarrel = sizeof(pointsBarrel) / sizeof(pointsBarrel[0]);
+   const int numBase   = sizeof(pointsBase)   / sizeof(pointsBase[0]);
+   assert(numBarrel + numBase == HOWITZER_STRIP);
 
-   // begin drawing
-   glBegin(GL_LINE_STRIP);
+   // the rotating parts: the barrel
+   Position posRotate = viewport.offset(pos, 0.0, 2.0);
+   for (int i = 0; i < numBarrel; i++)
+	  strip[i] = rotate(posRotate, pointsBarrel[i].x, pointsBarrel[i].y, angle);
+
+   // non-rotating points: the base
+   for (int i = 0; i < numBase; i++)
+   {
+	  strip[numBarrel + i] = viewport.offset(pos, pointsBase[i].x, pointsBase[i].y);
+   }
 
-   // draw the rotating parts: the barrel
-   Position posRotate(pos);
-   posRotate.addPixelsY(2);
-   for (int i = 0; i < sizeof(pointsBarrel) / sizeof(pointsBarrel[0]); i++)
-	  glVertexPoint(rotate(posRotate, pointsBarrel[i].x, pointsBarrel[i].y, angle));
+   // the muzzle flash
+   for (int i = 0; i < HOWITZER_FLASH; i++)
+   {
+	  flash[i][0] = rotate(posRotate, pointsMuzzleFlash[i][0].x, pointsMuzzleFlash[i][0].y, angle);
+	  flash[i][1] = rotate(posRotate, pointsMuzzleFlash[i][1].x, pointsMuzzleFlash[i][1].y, angle);
+   }
+}
 
-   // draw non-rotating points: the base
-   for (int i = 0; i < sizeof(pointsBase) / sizeof(pointsBase[0]); i++)
-	  glVertex2f((GLfloat)(pos.getPixelsX() + pointsBase[i].x),
-				 (GLfloat)(pos.getPixelsY() + pointsBase[i].y));
+/***********************************************************************
+ * DRAW Howitzer
+ * Draw a howitzer on the screen at a given point
+ *    point    The position of the Howitzer on the screen
+ *    angle    The angle of the barrel where 0 is straight up
+ *    age      Seconds since the howitzer was fired
+ ***********************************************************************/
+void ogstream :: drawHowitzer(const Position & pos, double angle, double age)
+{
+   Position strip[HOWITZER_STRIP];
+   Position flash[HOWITZER_FLASH][2];
+   getHowitzerShape(pos, angle, strip, flash);
 
-   // complete drawing of the gun
+   // draw the gun
+   glBegin(GL_LINE_STRIP);
+   for (int i = 0; i < HOWITZER_STRIP; i++)
+	  glVertexPoint(viewport, strip[i]);
    glEnd();
 
    // Now for the muzzle flash
@@ -265,14 +488,12 @@ void ogstream :: drawHowitzer(const Position & pos, double angle, double age)
 	  // draw the muzzle flash
 	  glBegin(GL_LINES);
 
-	  for (int i = 0; i < 10; i++)
+	  for (int i = 0; i < HOWITZER_FLASH; i++)
 	  {
 		 GLfloat color = (GLfloat)((10.0 - (double)i) / 10.0);
 		 glColor3f(1.0 /* red % */, (GLfloat)color /* green % */, (GLfloat)color /* blue % */);
-		 glVertexPoint(rotate(posRotate, pointsMuzzleFlash[i][0].x,
-										pointsMuzzleFlash[i][0].y, angle));
-		 glVertexPoint(rotate(posRotate, pointsMuzzleFlash[i][1].x,
-										pointsMuzzleFlash[i][1].y, angle));
+		 glVertexPoint(viewport, flash[i][0]);
+		 glVertexPoint(viewport, flash[i][1]);
 	  }
 
 	  // complete drawing of the muzzle flash
@@ -296,14 +517,8 @@ Position ogstream :: rotate(const Position& origin, double x, double y, double r
    double cosA = cos(rotation);
    double sinA = sin(rotation);
 
-   // start with our original point
-   Position posReturn(origin);
-   
-   // find the new values
-   posReturn.addPixelsX(x * cosA + y * sinA);
-   posReturn.addPixelsY(y * cosA - x * sinA);
-
-   return posReturn;
+   // the offset is in pixels so the gun is the same size at any zoom
+   return viewport.offset(origin, x * cosA + y * sinA, y * cosA - x * sinA);
 }
 
 /******************************************************************
@@ -339,3 +554,7 @@ double random(double min, double max)
    return num;
 }
 
+/***************************************************
+ * STATICS
+ **************************************************/
+atomic <unsigned int> DrawCache::nextId(1);   // the id of the next cache made
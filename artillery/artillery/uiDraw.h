@@ -17,6 +17,7 @@
 #include <cmath>      // for M_PI, sin() and cos()
 #include <algorithm>  // used for min() and max()
 #include "position.h" // Where things are drawn
+#include "viewport.h" // and where that is on the screen
 using std::string;
 using std::min;
 using std::max;
@@ -27,7 +28,93 @@ using std::max;
  ************************************************************************/
 
 
+#include <atomic>
 #include <sstream>
+#include <vector>
+
+class ogstream;
+class DrawBuffer;
+
+/*************************************************************************
+ * DRAW CACHE
+ * Geometry that seldom changes, such as the ground, recorded once so it
+ * can be drawn with a single call instead of being rebuilt every frame.
+ * The drawing back-end is free to compile it into whatever form it likes
+ * (OpenGL uses a display list) and only recompiles when it changes.
+ *************************************************************************/
+class DrawCache
+{
+public:
+   DrawCache() : id(nextId++), generation(0), idList(0), idGeneration(0) {}
+   DrawCache(const DrawCache & rhs) : primitives(rhs.primitives), id(nextId++),
+      generation(rhs.generation), idList(0), idGeneration(0) {}
+   ~DrawCache();
+   DrawCache & operator = (const DrawCache & rhs)
+   {
+      primitives = rhs.primitives;
+      generation++;
+      return *this;
+   }
+
+   // the kinds of things we can remember
+   enum Type { LINE, RECTANGLE, TEXT };
+   struct Primitive
+   {
+      Type type;
+      Position begin;        // start of a line, corner of a rectangle, or top-left of text
+      Position end;          // end of a line or opposite corner of a rectangle
+      double red;
+      double green;
+      double blue;
+      std::string text;
+   };
+
+   // build the geometry
+   void clear()   { primitives.clear(); generation++; }
+   bool empty() const { return primitives.empty(); }
+   void addLine(const Position & begin, const Position & end,
+                double red = 0.0, double green = 0.0, double blue = 0.0)
+   {
+      add(LINE, begin, end, red, green, blue, std::string());
+   }
+   void addRectangle(const Position & begin, const Position & end,
+                     double red = 0.0, double green = 0.0, double blue = 0.0)
+   {
+      add(RECTANGLE, begin, end, red, green, blue, std::string());
+   }
+   void addText(const Position & topLeft, const std::string & text)
+   {
+      add(TEXT, topLeft, topLeft, 0.0, 0.0, 0.0, text);
+   }
+
+   // draw every primitive, one at a time, through the normal ogstream calls
+   void replay(ogstream & gout) const;
+
+   const std::vector <Primitive> & getPrimitives() const { return primitives; }
+   unsigned int getGeneration() const { return generation; }
+   unsigned int getId()         const { return id;         }
+
+private:
+   friend ogstream;
+
+   void add(Type type, const Position & begin, const Position & end,
+            double red, double green, double blue, const std::string & text)
+   {
+      Primitive primitive = { type, begin, end, red, green, blue, text };
+      primitives.push_back(primitive);
+      generation++;
+   }
+
+   std::vector <Primitive> primitives;
+   unsigned int id;                   // no other cache has it, even at this address
+   unsigned int generation;           // changes every time the geometry does
+   static std::atomic <unsigned int> nextId;
+
+   // owned by the drawing back-end
+   mutable unsigned int idList;       // compiled form of the geometry
+   mutable unsigned int idGeneration; // the generation that was compiled
+   mutable Viewport     idViewport;   // the viewport it was compiled for
+};
 
 /*************************************************************************
  * GRAPHICS STREAM
@@ -38,7 +125,14 @@ class ogstream : public std::ostringstream
 public:
    ogstream()                    : pos()    {          }
    ogstream(const Position& pos) : pos(pos) {          }
+   ogstream(const Viewport& viewport) : pos(), viewport(viewport) {}
+   ogstream(const Viewport& viewport, const Position& pos) : pos(pos), viewport(viewport) {}
    ~ogstream()                              { flush(); }
+
+   // where the field is on the screen. The positions handed to the
+   // draw methods are in meters; this turns them into pixels
+   const Viewport & getViewport() const { return viewport; }
+   void setViewport(const Viewport & viewport) { flush(); this->viewport = viewport; }
    
    // Methods specific to drawing text on the screen
    virtual void flush();
@@ -58,10 +152,21 @@ public:
    virtual void drawHowitzer(const Position & pos, double angle, double age);
    virtual void drawTarget(const Position& pos);
    virtual void drawText(const Position & topLeft, const char * text);
-private:
-   
+   virtual void drawCache(const DrawCache & cache);
+   virtual void drawBuffer(const DrawBuffer & buffer);
+
+protected:
+   // the lines that make up the howitzer, shared by every back-end
+   static const int HOWITZER_STRIP = 27;
+   static const int HOWITZER_FLASH = 10;
+   void getHowitzerShape(const Position & pos, double angle,
+                         Position strip[], Position flash[][2]);
+
    Position rotate(const Position& origin, double x, double y, double rotation);
+
+private:
    Position pos;
+   Viewport viewport;
 };
 
 
@@ -85,6 +190,7 @@ class ogstreamDummy : public ogstream
 {
 public:
    ogstreamDummy()  {          }
+   ogstreamDummy(const Viewport & viewport) : ogstream(viewport) {}
    ~ogstreamDummy() { str(""); }
    void flush()                                                              { assert(false); }
    void drawLine(const Position& begin, const Position& end,
@@ -95,6 +201,10 @@ public:
    void drawHowitzer(const Position& pos, double angle, double age)          { assert(false); }
    void drawTarget(const Position& pos)                                      { assert(false); }
    void drawText(const Position& topLeft, const char* text)                  { assert(false); }
+
+   // no graphics here: hand each cached primitive to the methods above
+   void drawCache(const DrawCache& cache)                                    { cache.replay(*this); }
+   void drawBuffer(const DrawBuffer& buffer);
 };
 
 #endif /* uiDraw_h */
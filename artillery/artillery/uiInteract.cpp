@@ -13,8 +13,11 @@
 #include <string>     // need you ask?
 #include <sstream>    // convert an integer into text
 #include <cassert>    // I feel the need... the need for asserts
-#include <time.h>     // for clock
+#include <time.h>     // for time()
 #include <cstdlib>    // for rand()
+#include <cmath>      // for fmod()
+#include <chrono>     // for steady_clock
+#include <thread>     // for sleep_until() and yield()
 
 
 #ifdef __APPLE__
@@ -32,7 +35,6 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <Gl/glut.h>           // OpenGL library we copied
-#include <ctime>            // for ::Sleep();
 #include <Windows.h>
 
 #define _USE_MATH_DEFINES
@@ -40,39 +42,15 @@
 #endif // _WIN32
 
 #include "uiInteract.h"
+#include "uiDraw.h"       // for ogstream
+#include "simulation.h"   // for SimulationThread
+#include "profiler.h"     // for ProfileScope
+#include "trace.h"        // for TRACE_SPAN
 #include "position.h"
 
 using namespace std;
 
 
-/*********************************************************************
- * SLEEP
- * Pause for a while.  We want to put the program to sleep until it
- * is time to draw again.  Note that this requires us to tell the OS
- * that we are idle.  the nanosleep function performs this task for us
- *   INPUT: msSleep: sleep time in milliseconds
- *********************************************************************/
-void sleep(unsigned long msSleep)
-{
-   // Windows handles sleep one way
-#ifdef _WIN32
-   ::Sleep(msSleep + 35);
-
-   // Unix-based operating systems (OS-X, Linux) do it another
-#else // LINUX, XCODE
-   timespec req = {};
-   time_t sec = (int)(msSleep / 1000);
-   msSleep -= (sec * 1000);
-
-   req.tv_sec = sec;
-   req.tv_nsec = msSleep * 1000000L;
-
-   while (nanosleep(&req, &req) == -1)
-	  ;
-#endif // LINUX, XCODE
-   return;
-}
-
 /************************************************************************
  * DRAW CALLBACK
  * This is the main callback from OpenGL. It gets called constantly by
@@ -85,28 +63,75 @@ void sleep(unsigned long msSleep)
  *************************************************************************/
 void drawCallback()
 {
+   TRACE_SPAN("frame");
+
    // even though this is a local variable, all the members are static
    Interface ui;
    // Prepare the background buffer for drawing
    glClear(GL_COLOR_BUFFER_BIT); //clear the screen
    glColor3f((GLfloat)0.0 /* red % */, (GLfloat)0.0 /* green % */, (GLfloat)0.0 /* blue % */);
    
-   //calls the client's display function
-   assert(ui.callBack != NULL);
-   ui.callBack(&ui, ui.p);
+   // the simulation is on another thread: draw what it last published
+   chrono::steady_clock::time_point timeInput;
+   if (ui.pSimulation != NULL)
+   {
+      ProfileScope scope(Profiler::DRAW);
+      ogstream gout(ui.getCamera().getViewport());
+      timeInput = ui.pSimulation->draw(gout);
+   }
+   else
+   {
+      // advance the simulation to catch up with the wall clock
+      if (ui.stepCallBack != NULL)
+         ui.advanceSimulation();
+      else
+         ui.pollKeyEvents();
+
+      // calls the client's display function. It draws through the home
+      // viewport, so move what it draws to where the camera is looking
+      assert(ui.callBack != NULL);
+      const Camera & camera = ui.getCamera();
+      glPushMatrix();
+      glTranslated(camera.getOffsetX(), camera.getOffsetY(), 0.0);
+      glScaled(camera.getScale(), camera.getScale(), 1.0);
+      ui.callBack(&ui, ui.p);
+      glPopMatrix();
+      timeInput = ui.takeInputTime();
+
+      ogstream gout(ui.getViewport());
+      ui.drawTimeWarp(gout, ui.getTimeWarp().getName());
+   }
+
+   // where the time went in the recent frames
+   if (Profiler::isEnabled())
+   {
+      const Viewport & viewport = ui.getViewport();
+      ogstream gout(viewport);
+      Position posTopLeft = viewport.toMeters(10.0, viewport.getHeight() - 20.0);
+      Profiler::draw(gout, posTopLeft);
+   }
    
    //loop until the timer runs out
-   if (!ui.isTimeToDraw())
-	  sleep((unsigned long)((ui.getNextTick() - clock()) / 1000));
+   {
+      ProfileScope scope(Profiler::SLEEP);
+      ui.waitToDraw();
+   }
+
+   // bring forth the background buffer
+   {
+      ProfileScope scope(Profiler::SWAP);
+      glutSwapBuffers();
+   }
+   ui.recordInputLatency(timeInput);
+   Profiler::endFrame();
 
    // from this point, set the next draw time
    ui.setNextDrawTime();
+   Trace::nextFrame();
 
-   // bring forth the background buffer
-   glutSwapBuffers();
-
-   // clear the space at the end
-   ui.keyEvent();
+   // clear the space at the end. With fixed steps that is done per step
+   if (ui.stepCallBack == NULL && ui.pSimulation == NULL)
+      ui.keyEvent();
 }
 
 /************************************************************************
@@ -118,10 +143,22 @@ void drawCallback()
  *************************************************************************/
 void keyDownCallback(int key, int x, int y)
 {
-   // Even though this is a local variable, all the members are static
-   // so we are actually getting the same version as in the constructor.
-   Interface ui;
-   ui.keyEvent(key, true /*fDown*/);
+   // F3 shows and hides the frame timing. The game never sees it
+   if (key == GLUT_KEY_F3)
+   {
+      Profiler::toggle();
+      return;
+   }
+
+   // nor does it see HOME, which puts the camera back
+   if (key == GLUT_KEY_HOME)
+   {
+      Interface::camera.reset();
+      return;
+   }
+
+   // Whoever runs the simulation will pick it up from the queue
+   Interface::queueKeyEvent(key, true /*fDown*/);
 }
 
 /************************************************************************
@@ -132,10 +169,11 @@ void keyDownCallback(int key, int x, int y)
  *************************************************************************/
 void keyUpCallback(int key, int x, int y)
 {
-   // Even though this is a local variable, all the members are static
-   // so we are actually getting the same version as in the constructor.
-   Interface ui;
-   ui.keyEvent(key, false /*fDown*/);
+   if (key == GLUT_KEY_F3 || key == GLUT_KEY_HOME)
+      return;
+
+   // Whoever runs the simulation will pick it up from the queue
+   Interface::queueKeyEvent(key, false /*fDown*/);
 }
 
 /***************************************************************
@@ -145,10 +183,63 @@ void keyUpCallback(int key, int x, int y)
  ***************************************************************/
 void keyboardCallback(unsigned char key, int x, int y)
 {
-   // Even though this is a local variable, all the members are static
-   // so we are actually getting the same version as in the constructor.
-   Interface ui;
-   ui.keyEvent(key, true /*fDown*/);
+   // the camera keys move the view, not the game
+   const double PAN = 50.0;    // pixels
+   const double ZOOM = 1.25;
+   switch (key)
+   {
+      case 'a': Interface::camera.pan(-PAN, 0.0); return;
+      case 'd': Interface::camera.pan( PAN, 0.0); return;
+      case 'w': Interface::camera.pan(0.0,  PAN); return;
+      case 's': Interface::camera.pan(0.0, -PAN); return;
+      case '+':
+      case '=': Interface::camera.zoom(ZOOM);        return;
+      case '-': Interface::camera.zoom(1.0 / ZOOM);  return;
+      case '0': Interface::camera.reset();           return;
+   }
+
+   // Whoever runs the simulation will pick it up from the queue
+   Interface::queueKeyEvent(key, true /*fDown*/);
+}
+
+/***************************************************************
+ * MOUSE CALLBACK
+ * The wheel zooms in and out about the pointer. Pressing the left
+ * button starts a drag. GLUT has the top of the window as y = 0
+ *   INPUT   button   which button, the wheel being 3 and 4
+ *           state    GLUT_DOWN or GLUT_UP
+ *           x y      the pointer, in pixels
+ ***************************************************************/
+static int xDrag = -1;    // where the drag last was, or -1 if not dragging
+static int yDrag = -1;
+
+void mouseCallback(int button, int state, int x, int y)
+{
+   const double ZOOM = 1.1;
+   double yFromBottom = Interface::viewport.getHeight() - (double)y;
+
+   if (button == 3 && state == GLUT_DOWN)
+      Interface::camera.zoom(ZOOM, (double)x, yFromBottom);
+   else if (button == 4 && state == GLUT_DOWN)
+      Interface::camera.zoom(1.0 / ZOOM, (double)x, yFromBottom);
+   else if (button == GLUT_LEFT_BUTTON)
+   {
+      xDrag = (state == GLUT_DOWN ? x : -1);
+      yDrag = (state == GLUT_DOWN ? y : -1);
+   }
+}
+
+/***************************************************************
+ * MOTION CALLBACK
+ * Dragging pulls the field along with the pointer
+ ***************************************************************/
+void motionCallback(int x, int y)
+{
+   if (xDrag < 0)
+      return;
+   Interface::camera.pan((double)(xDrag - x), (double)(y - yDrag));
+   xDrag = x;
+   yDrag = y;
 }
 
 /************************************************************************
@@ -157,6 +248,13 @@ void keyboardCallback(unsigned char key, int x, int y)
  *************************************************************************/
 void closeCallback()
 {
+   // let the simulation finish its step before we pull the rug out
+   Interface ui;
+   if (ui.pSimulation != NULL)
+      ui.pSimulation->stop();
+#ifdef TRACE_SPANS
+   Trace::write("artillery.trace.json");
+#endif // TRACE_SPANS
    exit(0);
 }
 
@@ -186,9 +284,97 @@ void Interface::keyEvent(int key, bool fDown)
 	  case ' ':
 		 isSpacePress = fDown;
 		 break;
+	  case 'i':
+	  case 'I':
+		 isSkipPress = fDown;
+		 break;
+	  case 't':
+	  case 'T':
+		 if (fDown)
+			timeWarp.faster();
+		 break;
    }
 }
 
+/***************************************************************
+ * INTERFACE : QUEUE KEY EVENT
+ * Remember a key event, and when it happened, for the simulation.
+ * Only the OpenGL callbacks call this. If the simulation is so far
+ * behind that the queue is full, the event is dropped.
+ *   INPUT   key     which key is pressed
+ *           fDown   down or up
+ ****************************************************************/
+bool Interface::queueKeyEvent(int key, bool fDown)
+{
+   KeyEvent event = { key, fDown, chrono::steady_clock::now() };
+   return keyEvents.push(event);
+}
+
+/***************************************************************
+ * INTERFACE : POLL KEY EVENTS
+ * Apply the queued key events in the order they happened. A key
+ * that is pressed and released between two polls would never be
+ * seen, so when we find the release we keep it for the next poll.
+ ****************************************************************/
+void Interface::pollKeyEvents()
+{
+   const int MAX_KEYS = 32;
+   int pressed[MAX_KEYS];
+   int numPressed = 0;
+
+   KeyEvent event;
+   while (isKeyPending || keyEvents.pop(event))
+   {
+      if (isKeyPending)
+      {
+         event = keyPending;
+         isKeyPending = false;
+      }
+      else if (!event.fDown)
+      {
+         bool isPressedThisPoll = false;
+         for (int i = 0; i < numPressed; i++)
+            if (pressed[i] == event.key)
+               isPressedThisPoll = true;
+         if (isPressedThisPoll)
+         {
+            keyPending = event;
+            isKeyPending = true;
+            return;
+         }
+      }
+
+      keyEvent(event.key, event.fDown);
+      if (event.fDown && numPressed < MAX_KEYS)
+         pressed[numPressed++] = event.key;
+      if (timeInput == chrono::steady_clock::time_point() || event.time < timeInput)
+         timeInput = event.time;
+   }
+}
+
+/***************************************************************
+ * INTERFACE : TAKE INPUT TIME
+ * When was the oldest key event we applied since last time?
+ ****************************************************************/
+chrono::steady_clock::time_point Interface::takeInputTime()
+{
+   chrono::steady_clock::time_point time = timeInput;
+   timeInput = chrono::steady_clock::time_point();
+   return time;
+}
+
+/***************************************************************
+ * INTERFACE : RECORD INPUT LATENCY
+ * The response to a key event is now on the screen
+ ****************************************************************/
+void Interface::recordInputLatency(chrono::steady_clock::time_point timeInput)
+{
+   if (timeInput == chrono::steady_clock::time_point())
+      return;
+   inputLatency.record(chrono::duration<double>(chrono::steady_clock::now() - timeInput).count(),
+                       false /*isLate*/);
+}
+
 /***************************************************************
  * INTERFACE : KEY EVENT
  * Either set the up or down event for a given key
@@ -206,6 +392,7 @@ void Interface::keyEvent()
    if (isRightPress)
 	  isRightPress++;
    isSpacePress = false;
+   isSkipPress = false;
 }
 
 /************************************************************************
@@ -215,17 +402,122 @@ void Interface::keyEvent()
  *************************************************************************/
 bool Interface::isTimeToDraw()
 {
-   return ((unsigned int)clock() >= nextTick);
+   return chrono::steady_clock::now() >= timeNextDraw;
+}
+
+/************************************************************************
+ * INTERFACE : WAIT TO DRAW
+ * Wait until it is time to draw. The OS only promises to wake us up
+ * some time after we ask, often a millisecond or more late, so we sleep
+ * until we are close and then spin (politely) the rest of the way.
+ *************************************************************************/
+void Interface::waitToDraw()
+{
+   // how close we let the sleep get before we start to spin
+#ifdef _WIN32
+   const chrono::microseconds SPIN_TIME(16000);  // the scheduler ticks at 15.6ms
+#else // LINUX, XCODE
+   const chrono::microseconds SPIN_TIME(1500);
+#endif // LINUX, XCODE
+
+   chrono::steady_clock::time_point timeNow = chrono::steady_clock::now();
+   if (timeNextDraw - timeNow > SPIN_TIME)
+      this_thread::sleep_until(timeNextDraw - SPIN_TIME);
+
+   while (chrono::steady_clock::now() < timeNextDraw)
+      this_thread::yield();
 }
 
 /************************************************************************
  * INTERFACE : SET NEXT DRAW TIME
  * What time should we draw the buffer again?  This is a function of
- * the current time and the frames per second.
+ * the time we were supposed to draw and the frames per second, so small
+ * delays do not add up. If we fell more than a frame behind, start over
+ * from now. This also records how long the frame took.
  *************************************************************************/
 void Interface::setNextDrawTime()
 {
-   nextTick = (unsigned int)clock() + static_cast<unsigned int> (timePeriod * CLOCKS_PER_SEC);
+   chrono::steady_clock::time_point timeNow = chrono::steady_clock::now();
+   chrono::steady_clock::duration period =
+      chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(timePeriod));
+
+   // how long did this frame take?
+   if (timeLastDraw != chrono::steady_clock::time_point())
+   {
+      bool isLate = (timeNow - timeNextDraw) > period / 2;
+      frameStats.record(chrono::duration<double>(timeNow - timeLastDraw).count(), isLate);
+   }
+   timeLastDraw = timeNow;
+
+   timeNextDraw += period;
+   if (timeNextDraw < timeNow)
+      timeNextDraw = timeNow + period;
+}
+
+/************************************************************************
+ * INTERFACE : ADVANCE SIMULATION
+ * Add the wall time since the last frame to the time warp and run one
+ * fixed simulation step for every time step it holds. Every step is
+ * the same length so the physics is the same no matter how fast or
+ * slow the frames are. If the simulation falls too far behind (a long
+ * hitch, or steps that take longer than they simulate) we drop the
+ * backlog rather than spiral ever further behind. Warping, the steps
+ * get half the frame and the rest is left for drawing.
+ *************************************************************************/
+int Interface::advanceSimulation()
+{
+   const double BUDGET = 0.5;      // of the frame, while warping
+
+   // how much wall time has passed?
+   chrono::steady_clock::time_point timeNow = chrono::steady_clock::now();
+   double elapsed = chrono::duration<double>(timeNow - timePrevious).count();
+   timePrevious = timeNow;
+   timeWarp.begin(elapsed, timeStep);
+
+   // take as many fixed steps as the wall clock calls for
+   int steps = 0;
+   while (timeWarp.isStepDue(chrono::duration<double>(chrono::steady_clock::now() - timeNow).count(),
+                             timePeriod * BUDGET))
+   {
+      pollKeyEvents();
+      stepCallBack(this, p);
+      timeWarp.step();
+      steps++;
+
+      // each key press is seen by exactly one step
+      keyEvent();
+   }
+
+   interpolation = timeWarp.end();
+   assert(0.0 <= interpolation && interpolation <= 1.0);
+   return steps;
+}
+
+/************************************************************************
+ * INTERFACE : DRAW TIME WARP
+ * Say how fast the simulation is running, top right of the window
+ * wherever the camera is. The name comes from TimeWarp::getName(),
+ * which is NULL in real time
+ *************************************************************************/
+void Interface::drawTimeWarp(ogstream & gout, const char * name) const
+{
+   if (name == NULL)
+      return;
+
+   gout.setViewport(viewport);
+   gout.drawText(viewport.toMeters(viewport.getWidth() - 50.0, viewport.getHeight() - 20.0), name);
+}
+
+/************************************************************************
+ * INTERFACE : SET STEPS PER SECOND
+ * How many fixed simulation steps per second of wall time. This, not
+ * the frame rate, dictates the speed of the game. We default to 30.
+ *    INPUT  value        The number of steps per second.
+ *************************************************************************/
+void Interface::setStepsPerSecond(double value)
+{
+   assert(value > 0.0);
+   timeStep = (1 / value);
 }
 
 /************************************************************************
@@ -240,6 +532,49 @@ void Interface::setFramesPerSecond(double value)
 	timePeriod = (1 / value);
 }
 
+/************************************************************************
+ * FRAME STATS : AVERAGE, MINIMUM, MAXIMUM, DEVIATION
+ * Summarize the recent frame times
+ *************************************************************************/
+double FrameStats::getAverage() const
+{
+   if (count == 0)
+      return 0.0;
+   double sum = 0.0;
+   for (int i = 0; i < count; i++)
+      sum += times[i];
+   return sum / count;
+}
+
+double FrameStats::getMinimum() const
+{
+   if (count == 0)
+      return 0.0;
+   double minimum = times[0];
+   for (int i = 1; i < count; i++)
+      minimum = min(minimum, times[i]);
+   return minimum;
+}
+
+double FrameStats::getMaximum() const
+{
+   double maximum = 0.0;
+   for (int i = 0; i < count; i++)
+      maximum = max(maximum, times[i]);
+   return maximum;
+}
+
+double FrameStats::getDeviation() const
+{
+   if (count < 2)
+      return 0.0;
+   double average = getAverage();
+   double sum = 0.0;
+   for (int i = 0; i < count; i++)
+      sum += (times[i] - average) * (times[i] - average);
+   return sqrt(sum / (count - 1));
+}
+
 /***************************************************
  * STATICS
  * All the static member variables need to be initialized
@@ -250,11 +585,28 @@ int          Interface::isUpPress    = 0;
 int          Interface::isLeftPress  = 0;
 int          Interface::isRightPress = 0;
 bool         Interface::isSpacePress = false;
+bool         Interface::isSkipPress  = false;
+SpscQueue <KeyEvent, 256> Interface::keyEvents;
+KeyEvent     Interface::keyPending;
+bool         Interface::isKeyPending = false;
+chrono::steady_clock::time_point Interface::timeInput;
+FrameStats   Interface::inputLatency;
 bool         Interface::initialized  = false;
 double       Interface::timePeriod   = 1.0 / 30; // default to 30 frames/second
-unsigned int Interface::nextTick     = 0;        // redraw now please
+chrono::steady_clock::time_point Interface::timeNextDraw; // redraw now please
+chrono::steady_clock::time_point Interface::timeLastDraw;
+FrameStats   Interface::frameStats;
+double       Interface::timeStep     = 1.0 / 30; // default to 30 steps/second
+TimeWarp     Interface::timeWarp;
+double       Interface::interpolation = 1.0;
+chrono::steady_clock::time_point Interface::timePrevious;
 void *       Interface::p            = NULL;
 void (*Interface::callBack)(const Interface *, void *) = NULL;
+void (*Interface::stepCallBack)(const Interface *, void *) = NULL;
+SimulationThread * Interface::pSimulation = NULL;
+Position     Interface::posUpperRight;
+Viewport     Interface::viewport;
+Camera       Interface::camera;
 
 /************************************************************************
  * INTEFACE : INITIALIZE
@@ -266,18 +618,22 @@ void (*Interface::callBack)(const Interface *, void *) = NULL;
  *           title:      The text for the titlebar of the window
  *************************************************************************/
 void Interface::initialize(int argc, char ** argv, const char * title,
-						   const Position & posUpperRight)
+						   const Viewport & viewport)
 {
    if (initialized)
 	  return;
+   Interface::viewport = viewport;
+   Interface::camera = Camera(viewport);
+   Interface::posUpperRight = viewport.getUpperRight();
+   int width  = (int)viewport.getWidth();
+   int height = (int)viewport.getHeight();
    
    // set up the random number generator
    srand((unsigned int)time(NULL));
 
    // create the window
    glutInit(&argc, argv);
-   glutInitWindowSize((int)posUpperRight.getPixelsX()-1,
-					  (int)posUpperRight.getPixelsY()-1);   // size of the window
+   glutInitWindowSize(width - 1, height - 1);      // size of the window
 			
    glutInitWindowPosition( 10, 10);                // initial position
    glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGB);    // double buffering
@@ -286,9 +642,9 @@ void Interface::initialize(int argc, char ** argv, const char * title,
    
    // set up the drawing style: B/W and 2D
    glClearColor(1.0, 1.0, 1.0, 0);            // White is the background color
-   gluOrtho2D(0, (int)posUpperRight.getPixelsX(),    // range of x values: (0, width)
-			  0, (int)posUpperRight.getPixelsY());   // range of y values: (0, height)
-   glutReshapeWindow((int)posUpperRight.getPixelsX(), (int)posUpperRight.getPixelsY());
+   gluOrtho2D(0, width,                       // range of x values: (0, width)
+			  0, height);                     // range of y values: (0, height)
+   glutReshapeWindow(width, height);
 
    // register the callbacks so OpenGL knows how to call us
    glutDisplayFunc(   drawCallback    );
@@ -296,6 +652,8 @@ void Interface::initialize(int argc, char ** argv, const char * title,
    glutKeyboardFunc(  keyboardCallback);
    glutSpecialFunc(   keyDownCallback );
    glutSpecialUpFunc( keyUpCallback   );
+   glutMouseFunc(     mouseCallback   );
+   glutMotionFunc(    motionCallback  );
 #ifdef __APPLE__
    glutWMCloseFunc(   closeCallback   );
 #endif
@@ -322,9 +680,56 @@ void Interface::run(void (*callBack)(const Interface *, void *), void *p)
    this->p = p;
    this->callBack = callBack;
 
+   TRACE_THREAD("main");
+   Profiler::setFrameThread();
    glutMainLoop();
 
    return;
 }
 
+/************************************************************************
+ * INTERFACE : RUN
+ *            Start the main graphics loop with a fixed simulation step
+ * INPUT stepCallBack: Called once for every fixed step of simulated time,
+ *                   possibly several times (or not at all) in a frame.
+ *                   Read input and move the game pieces here.
+ *       callBack:   Called once every frame to draw. Use
+ *                   getInterpolation() to draw between the last two steps.
+ *       p:          Void point to whatever the caller wants.
+ *************************************************************************/
+void Interface::run(void (*stepCallBack)(const Interface *, void *),
+                    void (*callBack)(const Interface *, void *), void *p)
+{
+   this->stepCallBack = stepCallBack;
+   timePrevious = chrono::steady_clock::now();
+   timeWarp = TimeWarp();
 
+   run(callBack, p);
+}
+
+/************************************************************************
+ * INTERFACE : RUN THREADED
+ *            Start the main graphics loop with the simulation on its
+ *            own thread
+ * INPUT stepCallBack:   Called on the simulation thread once for every
+ *                       fixed step. Read input and move the game pieces.
+ *       recordCallBack: Called on the simulation thread after every step
+ *                       to draw into the given ogstream, which records
+ *                       rather than drawing. Never touch OpenGL here.
+ *       p:              Void point to whatever the caller wants. Only the
+ *                       simulation thread uses it.
+ *************************************************************************/
+void Interface::runThreaded(void (*stepCallBack)(const Interface *, void *),
+                            void (*recordCallBack)(const Interface *, void *, ogstream &),
+                            void *p)
+{
+   // it lives as long as the program does: glutMainLoop() never returns
+   static SimulationThread simulation(stepCallBack, recordCallBack, p);
+   pSimulation = &simulation;
+   this->p = p;
+
+   simulation.start();
+   Profiler::setFrameThread();
+   glutMainLoop();
+   simulation.stop();
+}
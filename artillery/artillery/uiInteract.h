@@ -12,16 +12,75 @@
  *    3. callback     - Specified in Run, this user-provided
  *                      function will get called with every frame
  *    4. isDown()     - Is a given key pressed on this loop?
+ *    F3 shows where the time in each frame goes (see profiler.h)
+ *    T runs the simulation faster (see timeWarp.h)
  **********************************************/
 
 #ifndef uiInteract_h
 #define uiInteract_h
 
 #include "position.h"
+#include "viewport.h"  // for Viewport
+#include "camera.h"    // for Camera
+#include "timeWarp.h"  // for TimeWarp
+#include "lockFree.h" // for SpscQueue
+#include <chrono>    // for steady_clock
 #include <algorithm> // used for min() and max() (specifically required by Visual Studio)
 using std::min;
 using std::max;
 
+class ogstream;
+class SimulationThread;
+
+/********************************************
+ * FRAME STATS
+ * The last few timings of something that
+ * happens once a frame, such as the time
+ * between frames reaching the screen or the
+ * latency of the input, in seconds
+ ********************************************/
+class FrameStats
+{
+public:
+   FrameStats() : count(0), next(0), late(0) {}
+
+   // remember how long a frame took and whether it missed its time
+   void record(double seconds, bool isLate)
+   {
+      times[next] = seconds;
+      next = (next + 1) % CAPACITY;
+      if (count < CAPACITY)
+         count++;
+      if (isLate)
+         late++;
+   }
+
+   int    getCount()   const { return count; }
+   int    getLate()    const { return late;  }   // since the start
+   double getAverage() const;
+   double getMinimum() const;
+   double getMaximum() const;
+   double getDeviation() const;                  // the jitter
+
+private:
+   static const int CAPACITY = 120;              // four seconds at 30 fps
+   double times[CAPACITY];
+   int count;
+   int next;
+   int late;
+};
+
+/********************************************
+ * KEY EVENT
+ * A key was pressed or released, and when
+ ********************************************/
+struct KeyEvent
+{
+   int  key;
+   bool fDown;
+   std::chrono::steady_clock::time_point time;
+};
+
 /********************************************
  * INTERFACE
  * All the data necessary to keep our graphics
@@ -34,33 +93,105 @@ public:
 
    // Constructor if you want to set up the window with anything but
    // the default parameters
+   Interface(int argc, char ** argv, const char * title, const Viewport & viewport)
+   {
+	  initialize(argc, argv, title, viewport);
+   }
+
+   // The same, with the window size in pixels at the zoom Position has
    Interface(int argc, char ** argv, const char * title, const Position & posUpperRight)
    {
-	  initialize(argc, argv, title, posUpperRight);
+	  initialize(argc, argv, title, Viewport(posUpperRight.getPixelsX(),
+	                                         posUpperRight.getPixelsY(),
+	                                         posUpperRight.getZoom()));
    }
 
    // This will set the game in motion
    void run(void (*callBack)(const Interface *, void *), void *p);
 
+   // Set the game in motion with the simulation advancing in fixed steps
+   // (stepCallBack, as many as the wall clock calls for) independent of
+   // how often the screen is drawn (callBack, once per frame)
+   void run(void (*stepCallBack)(const Interface *, void *),
+            void (*callBack)(const Interface *, void *), void *p);
+
+   // Set the game in motion with the simulation on its own thread. After
+   // every step, recordCallBack draws into the given ogstream (on the
+   // simulation thread) and the newest recording is put on the screen
+   void runThreaded(void (*stepCallBack)(const Interface *, void *),
+                    void (*recordCallBack)(const Interface *, void *, ogstream &),
+                    void *p);
+
    // Is it time to redraw the screen
    bool isTimeToDraw();
 
    // Set the next draw time based on current time and time period
    void setNextDrawTime();
 
-   // Retrieve the next tick time... the time of the next draw.
-   unsigned int getNextTick() { return nextTick; };
+   // Retrieve the time of the next draw.
+   std::chrono::steady_clock::time_point getNextDrawTime() { return timeNextDraw; };
+
+   // Wait until it is time to draw. Sleep most of the way, then spin
+   // the last little bit because the OS will not wake us up on time
+   void waitToDraw();
+
+   // How long the recent frames took
+   const FrameStats & getFrameStats() const { return frameStats; };
 
    // How many frames per second are we configured for?
    void setFramesPerSecond(double value);
    
    // Key event indicating a key has been pressed or not.  The callbacks
-   // should be the only onces to call this
+   // put these in a queue; pollKeyEvents() takes them out and applies them
    void keyEvent(int key, bool fDown);
    void keyEvent();
+   static bool queueKeyEvent(int key, bool fDown);
+
+   // Apply the queued key events to the key state. Whoever runs the
+   // simulation calls this, and only that thread reads the key state
+   void pollKeyEvents();
+
+   // The time of the oldest key event applied since the last call, for
+   // measuring the latency from the key to the screen. Zero if none
+   std::chrono::steady_clock::time_point takeInputTime();
+
+   // The frame showing the response to input at timeInput is on the screen
+   void recordInputLatency(std::chrono::steady_clock::time_point timeInput);
+
+   // How long from a key press to the screen showing the response
+   const FrameStats & getInputLatency() const { return inputLatency; };
+
+   // The size of the window
+   const Position & getUpperRight() const { return posUpperRight; };
+
+   // Where the field is in the window before the camera moves
+   const Viewport & getViewport() const { return viewport; };
+
+   // Where the camera is looking. Only the thread with the window may
+   // look at this: the mouse and the keys move it between frames
+   const Camera & getCamera() const { return camera; };
 
    // Current frame rate
    double frameRate() const { return timePeriod;   };
+
+   // How long, in seconds, is one simulation step?
+   void setStepsPerSecond(double value);
+   double stepPeriod() const { return timeStep; };
+
+   // How far between the last two simulation steps is this frame? Draw
+   // things at previous + (current - previous) * interpolation. 0 to 1.
+   double getInterpolation() const { return interpolation; };
+
+   // Run the simulation steps that are due. Returns the number run
+   int advanceSimulation();
+
+   // How fast the simulation runs against the wall clock. Only whoever
+   // runs the simulation may look at this: T changes it between steps
+   const TimeWarp & getTimeWarp() const { return timeWarp; };
+   TimeWarp & getTimeWarp() { return timeWarp; };
+
+   // Say how fast, top right, given the time warp's name. Nothing for NULL
+   void drawTimeWarp(ogstream & gout, const char * name) const;
    
    // Get various key events
    int  isDown()      const { return isDownPress;  };
@@ -68,22 +199,49 @@ public:
    int  isLeft()      const { return isLeftPress;  };
    int  isRight()     const { return isRightPress; };
    bool isSpace()     const { return isSpacePress; };
+   bool isSkip()      const { return isSkipPress;  };   // finish the flight now
    
    static void *p;                   // for client
    static void (*callBack)(const Interface *, void *);
+   static void (*stepCallBack)(const Interface *, void *);
+   static SimulationThread * pSimulation;   // when the simulation has its own thread
 
 private:
-   void initialize(int argc, char ** argv, const char * title, const Position & posUpperRight);
+   void initialize(int argc, char ** argv, const char * title, const Viewport & viewport);
 
    static bool         initialized;  // only run the constructor once!
+   static Position     posUpperRight;// size of the window
+   static Viewport     viewport;     // from the field to the window
+   static Camera       camera;       // panned and zoomed from viewport
    static double       timePeriod;   // interval between frame draws
-   static unsigned int nextTick;     // time (from clock()) of our next draw
+   static std::chrono::steady_clock::time_point timeNextDraw; // when to draw next
+   static std::chrono::steady_clock::time_point timeLastDraw; // when we last drew
+   static FrameStats   frameStats;   // how long the recent frames took
+
+   static double       timeStep;     // simulated seconds in one step
+   static TimeWarp     timeWarp;     // simulated time not yet stepped
+   static double       interpolation;// accumulator / timeStep
+   static std::chrono::steady_clock::time_point timePrevious; // last frame
 
+   // Only the thread running the simulation touches the key state. The
+   // OpenGL callbacks only ever touch the queue.
    static int  isDownPress;          // is the down arrow currently pressed?
    static int  isUpPress;            //    "   up         "
    static int  isLeftPress;          //    "   left       "
    static int  isRightPress;         //    "   right      "
    static bool isSpacePress;         //    "   space      "
+   static bool isSkipPress;          //    "   I          "
+
+   static SpscQueue <KeyEvent, 256> keyEvents;   // callbacks -> simulation
+   static KeyEvent keyPending;       // a release held for the next poll
+   static bool     isKeyPending;
+   static std::chrono::steady_clock::time_point timeInput; // oldest unshown key
+   static FrameStats inputLatency;   // from the key to the screen
+
+   friend void keyboardCallback(unsigned char key, int x, int y);
+   friend void keyDownCallback(int key, int x, int y);
+   friend void mouseCallback(int button, int state, int x, int y);
+   friend void motionCallback(int x, int y);
 };
 
 
@@ -120,6 +278,13 @@ void keyUpCallback(int key, int x, int y);
  ***************************************************************/
 void keyboardCallback(unsigned char key, int x, int y);
 
+/***************************************************************
+ * MOUSE CALLBACK
+ * The wheel zooms about the pointer and the left button drags
+ ***************************************************************/
+void mouseCallback(int button, int state, int x, int y);
+void motionCallback(int x, int y);
+
 /************************************************************************
  * RUN
  * Set the game in action.  We will get control back in our drawCallback
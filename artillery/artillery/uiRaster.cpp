@@ -0,0 +1,509 @@
+/***********************************************************************
+ * Source File:
+ *    User Interface Raster : draw without a screen
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    A software rasterizer behind the ogstream interface, and the code
+ *    to write its frames out as PPM, PNG, or raw RGBA video.
+ ************************************************************************/
+
+#include "uiRaster.h"
+#include "uiRecord.h"   // for DrawBuffer
+#include <cassert>
+#include <cmath>        // for floor()
+#include <fstream>
+
+using namespace std;
+
+/*************************************************************************
+ * FONT
+ * A 5x7 bitmap font, one byte per row with the top row first and the
+ * left-most pixel in bit 4. Lowercase letters use the uppercase shapes.
+ *************************************************************************/
+const int FONT_WIDTH   = 5;
+const int FONT_HEIGHT  = 7;
+const int FONT_ADVANCE = 6;
+
+struct Glyph
+{
+   char ch;
+   unsigned char rows[FONT_HEIGHT];
+};
+
+const Glyph font[] =
+{
+   { ' ', {0x00,0x00,0x00,0x00,0x00,0x00,0x00} },
+   { '0', {0x0E,0x11,0x13,0x15,0x19,0x11,0x0E} },
+   { '1', {0x04,0x0C,0x04,0x04,0x04,0x04,0x0E} },
+   { '2', {0x0E,0x11,0x01,0x02,0x04,0x08,0x1F} },
+   { '3', {0x1F,0x02,0x04,0x02,0x01,0x11,0x0E} },
+   { '4', {0x02,0x06,0x0A,0x12,0x1F,0x02,0x02} },
+   { '5', {0x1F,0x10,0x1E,0x01,0x01,0x11,0x0E} },
+   { '6', {0x06,0x08,0x10,0x1E,0x11,0x11,0x0E} },
+   { '7', {0x1F,0x01,0x02,0x04,0x08,0x08,0x08} },
+   { '8', {0x0E,0x11,0x11,0x0E,0x11,0x11,0x0E} },
+   { '9', {0x0E,0x11,0x11,0x0F,0x01,0x02,0x0C} },
+   { 'A', {0x0E,0x11,0x11,0x1F,0x11,0x11,0x11} },
+   { 'B', {0x1E,0x11,0x11,0x1E,0x11,0x11,0x1E} },
+   { 'C', {0x0E,0x11,0x10,0x10,0x10,0x11,0x0E} },
+   { 'D', {0x1C,0x12,0x11,0x11,0x11,0x12,0x1C} },
+   { 'E', {0x1F,0x10,0x10,0x1E,0x10,0x10,0x1F} },
+   { 'F', {0x1F,0x10,0x10,0x1E,0x10,0x10,0x10} },
+   { 'G', {0x0E,0x11,0x10,0x17,0x11,0x11,0x0F} },
+   { 'H', {0x11,0x11,0x11,0x1F,0x11,0x11,0x11} },
+   { 'I', {0x0E,0x04,0x04,0x04,0x04,0x04,0x0E} },
+   { 'J', {0x07,0x02,0x02,0x02,0x02,0x12,0x0C} },
+   { 'K', {0x11,0x12,0x14,0x18,0x14,0x12,0x11} },
+   { 'L', {0x10,0x10,0x10,0x10,0x10,0x10,0x1F} },
+   { 'M', {0x11,0x1B,0x15,0x15,0x11,0x11,0x11} },
+   { 'N', {0x11,0x11,0x19,0x15,0x13,0x11,0x11} },
+   { 'O', {0x0E,0x11,0x11,0x11,0x11,0x11,0x0E} },
+   { 'P', {0x1E,0x11,0x11,0x1E,0x10,0x10,0x10} },
+   { 'Q', {0x0E,0x11,0x11,0x11,0x15,0x12,0x0D} },
+   { 'R', {0x1E,0x11,0x11,0x1E,0x14,0x12,0x11} },
+   { 'S', {0x0F,0x10,0x10,0x0E,0x01,0x01,0x1E} },
+   { 'T', {0x1F,0x04,0x04,0x04,0x04,0x04,0x04} },
+   { 'U', {0x11,0x11,0x11,0x11,0x11,0x11,0x0E} },
+   { 'V', {0x11,0x11,0x11,0x11,0x11,0x0A,0x04} },
+   { 'W', {0x11,0x11,0x11,0x15,0x15,0x15,0x0A} },
+   { 'X', {0x11,0x11,0x0A,0x04,0x0A,0x11,0x11} },
+   { 'Y', {0x11,0x11,0x11,0x0A,0x04,0x04,0x04} },
+   { 'Z', {0x1F,0x01,0x02,0x04,0x08,0x10,0x1F} },
+   { '.', {0x00,0x00,0x00,0x00,0x00,0x0C,0x0C} },
+   { ',', {0x00,0x00,0x00,0x00,0x0C,0x04,0x08} },
+   { ':', {0x00,0x0C,0x0C,0x00,0x0C,0x0C,0x00} },
+   { '-', {0x00,0x00,0x00,0x1F,0x00,0x00,0x00} },
+   { '+', {0x00,0x04,0x04,0x1F,0x04,0x04,0x00} },
+   { '=', {0x00,0x00,0x1F,0x00,0x1F,0x00,0x00} },
+   { '%', {0x18,0x19,0x02,0x04,0x08,0x13,0x03} },
+   { '/', {0x00,0x01,0x02,0x04,0x08,0x10,0x00} },
+   { '(', {0x02,0x04,0x08,0x08,0x08,0x04,0x02} },
+   { ')', {0x08,0x04,0x02,0x02,0x02,0x04,0x08} },
+   { '!', {0x04,0x04,0x04,0x04,0x04,0x00,0x04} },
+   { '\'',{0x04,0x04,0x08,0x00,0x00,0x00,0x00} },
+   { '?', {0x0E,0x11,0x01,0x02,0x04,0x00,0x04} }   // also anything unknown
+};
+
+/*************************************************************************
+ * FIND GLYPH
+ * Look up the bitmap for a character
+ *************************************************************************/
+static const Glyph & findGlyph(char ch)
+{
+   if (ch >= 'a' && ch <= 'z')
+      ch = ch - 'a' + 'A';
+
+   const int num = sizeof(font) / sizeof(font[0]);
+   for (int i = 0; i < num; i++)
+      if (font[i].ch == ch)
+         return font[i];
+   return font[num - 1];
+}
+
+/*************************************************************************
+ * TO CHANNEL
+ * Convert a color percentage into a byte
+ *************************************************************************/
+static unsigned char toChannel(double percent)
+{
+   if (percent <= 0.0)
+      return 0;
+   if (percent >= 1.0)
+      return 255;
+   return (unsigned char)(percent * 255.0 + 0.5);
+}
+
+/*************************************************************************
+ * TO PIXEL
+ * The pixel a coordinate falls in
+ *************************************************************************/
+inline int toPixel(double pixels)
+{
+   return (int)floor(pixels);
+}
+
+/*************************************************************************
+ * RASTER : CONSTRUCTOR
+ * The frame buffer is the size of the viewport
+ *************************************************************************/
+ogstreamRaster :: ogstreamRaster(const Viewport & viewport) :
+   ogstream(viewport),
+   width((int)viewport.getWidth()),
+   height((int)viewport.getHeight())
+{
+   assert(width > 0 && height > 0);
+   frame.resize((size_t)width * height * 4);
+   clear();
+}
+
+ogstreamRaster :: ogstreamRaster(const Viewport & viewport, const Position & pos) :
+   ogstream(viewport, pos),
+   width((int)viewport.getWidth()),
+   height((int)viewport.getHeight())
+{
+   assert(width > 0 && height > 0);
+   frame.resize((size_t)width * height * 4);
+   clear();
+}
+
+/*************************************************************************
+ * RASTER : CLEAR
+ * Paint the whole frame one color
+ *************************************************************************/
+void ogstreamRaster :: clear(double red, double green, double blue)
+{
+   unsigned char r = toChannel(red);
+   unsigned char g = toChannel(green);
+   unsigned char b = toChannel(blue);
+   for (size_t i = 0; i < frame.size(); i += 4)
+   {
+      frame[i + 0] = r;
+      frame[i + 1] = g;
+      frame[i + 2] = b;
+      frame[i + 3] = 255;
+   }
+}
+
+/*************************************************************************
+ * RASTER : GET PIXEL
+ * The RGBA bytes of one pixel, (0, 0) being the bottom left
+ *************************************************************************/
+const unsigned char * ogstreamRaster :: getPixel(int x, int y) const
+{
+   assert(x >= 0 && x < width && y >= 0 && y < height);
+   return &frame[((size_t)(height - 1 - y) * width + x) * 4];
+}
+
+/*************************************************************************
+ * RASTER : PLOT
+ * Set one pixel, ignoring anything off the screen
+ *************************************************************************/
+inline void ogstreamRaster :: plot(int x, int y,
+                                   unsigned char red, unsigned char green, unsigned char blue)
+{
+   if (x < 0 || x >= width || y < 0 || y >= height)
+      return;
+   unsigned char * p = &frame[((size_t)(height - 1 - y) * width + x) * 4];
+   p[0] = red;
+   p[1] = green;
+   p[2] = blue;
+   p[3] = 255;
+}
+
+/*************************************************************************
+ * RASTER : LINE
+ * Bresenham's line between two pixels, both ends included
+ *************************************************************************/
+void ogstreamRaster :: line(int x0, int y0, int x1, int y1,
+                            unsigned char red, unsigned char green, unsigned char blue)
+{
+   int dx =  (x1 > x0 ? x1 - x0 : x0 - x1);
+   int dy = -(y1 > y0 ? y1 - y0 : y0 - y1);
+   int sx = (x0 < x1 ? 1 : -1);
+   int sy = (y0 < y1 ? 1 : -1);
+   int error = dx + dy;
+
+   while (true)
+   {
+      plot(x0, y0, red, green, blue);
+      if (x0 == x1 && y0 == y1)
+         break;
+      int error2 = 2 * error;
+      if (error2 >= dy)
+      {
+         error += dy;
+         x0 += sx;
+      }
+      if (error2 <= dx)
+      {
+         error += dx;
+         y0 += sy;
+      }
+   }
+}
+
+/*************************************************************************
+ * RASTER : FILL
+ * Fill a rectangle given in pixels. Like OpenGL, a pixel is filled
+ * when its center is inside the rectangle
+ *************************************************************************/
+void ogstreamRaster :: fill(double x0, double y0, double x1, double y1,
+                            unsigned char red, unsigned char green, unsigned char blue)
+{
+   int xMin = toPixel(min(x0, x1) + 0.5);
+   int xMax = toPixel(max(x0, x1) + 0.5);
+   int yMin = toPixel(min(y0, y1) + 0.5);
+   int yMax = toPixel(max(y0, y1) + 0.5);
+
+   xMin = max(xMin, 0);
+   yMin = max(yMin, 0);
+   xMax = min(xMax, width);
+   yMax = min(yMax, height);
+
+   for (int y = yMin; y < yMax; y++)
+      for (int x = xMin; x < xMax; x++)
+         plot(x, y, red, green, blue);
+}
+
+/*************************************************************************
+ * RASTER : DRAW LINE
+ *************************************************************************/
+void ogstreamRaster :: drawLine(const Position & begin, const Position & end,
+                                double red, double green, double blue)
+{
+   const Viewport & viewport = getViewport();
+   line(toPixel(viewport.toPixelsX(begin.getMetersX())), toPixel(viewport.toPixelsY(begin.getMetersY())),
+        toPixel(viewport.toPixelsX(end.getMetersX())),   toPixel(viewport.toPixelsY(end.getMetersY())),
+        toChannel(red), toChannel(green), toChannel(blue));
+}
+
+/*************************************************************************
+ * RASTER : DRAW RECTANGLE
+ *************************************************************************/
+void ogstreamRaster :: drawRectangle(const Position & begin, const Position & end,
+                                     double red, double green, double blue)
+{
+   const Viewport & viewport = getViewport();
+   fill(viewport.toPixelsX(begin.getMetersX()), viewport.toPixelsY(begin.getMetersY()),
+        viewport.toPixelsX(end.getMetersX()),   viewport.toPixelsY(end.getMetersY()),
+        toChannel(red), toChannel(green), toChannel(blue));
+}
+
+/*************************************************************************
+ * RASTER : DRAW PROJECTILE
+ * A square three pixels on a side, black when it is fired and graying
+ * with age, the same as the OpenGL version
+ *************************************************************************/
+void ogstreamRaster :: drawProjectile(const Position & pos, double age)
+{
+   const double size = 3.0;
+   const double tailLength = 5.0;
+   double xPixels = getViewport().toPixelsX(pos.getMetersX());
+   double yPixels = getViewport().toPixelsY(pos.getMetersY());
+   unsigned char color = toChannel(age / tailLength);
+   fill(xPixels - size / 2.0, yPixels - size / 2.0,
+        xPixels + size / 2.0, yPixels + size / 2.0,
+        color, color, color);
+}
+
+/*************************************************************************
+ * RASTER : DRAW HOWITZER
+ * The same lines as the OpenGL version
+ *************************************************************************/
+void ogstreamRaster :: drawHowitzer(const Position & pos, double angle, double age)
+{
+   Position strip[HOWITZER_STRIP];
+   Position flash[HOWITZER_FLASH][2];
+   getHowitzerShape(pos, angle, strip, flash);
+
+   for (int i = 1; i < HOWITZER_STRIP; i++)
+      drawLine(strip[i - 1], strip[i]);
+
+   // the muzzle flash lasts two seconds
+   if (age > 0.0 && age < 2.0)
+      for (int i = 0; i < HOWITZER_FLASH; i++)
+      {
+         double color = (10.0 - (double)i) / 10.0;
+         drawLine(flash[i][0], flash[i][1], 1.0, color, color);
+      }
+}
+
+/*************************************************************************
+ * RASTER : DRAW TARGET
+ * A green square ten pixels on a side
+ *************************************************************************/
+void ogstreamRaster :: drawTarget(const Position & pos)
+{
+   const double size = 10.0;
+   double xPixels = getViewport().toPixelsX(pos.getMetersX());
+   double yPixels = getViewport().toPixelsY(pos.getMetersY());
+   fill(xPixels - size / 2.0, yPixels - size / 2.0,
+        xPixels + size / 2.0, yPixels + size / 2.0,
+        toChannel(0.2), toChannel(0.75), toChannel(0.2));
+}
+
+/*************************************************************************
+ * RASTER : DRAW TEXT
+ * Black text with the bottom of the letters on the given point,
+ * which is where a GLUT bitmap font puts them
+ *************************************************************************/
+void ogstreamRaster :: drawText(const Position & topLeft, const char * text)
+{
+   int xLeft   = toPixel(getViewport().toPixelsX(topLeft.getMetersX()));
+   int yBottom = toPixel(getViewport().toPixelsY(topLeft.getMetersY()));
+
+   for (const char * p = text; *p; p++, xLeft += FONT_ADVANCE)
+   {
+      const Glyph & glyph = findGlyph(*p);
+      for (int row = 0; row < FONT_HEIGHT; row++)
+         for (int column = 0; column < FONT_WIDTH; column++)
+            if (glyph.rows[row] & (0x10 >> column))
+               plot(xLeft + column, yBottom + FONT_HEIGHT - 1 - row, 0, 0, 0);
+   }
+}
+
+/*************************************************************************
+ * RASTER : DRAW CACHE
+ * Nothing to compile, just draw each primitive
+ *************************************************************************/
+void ogstreamRaster :: drawCache(const DrawCache & cache)
+{
+   cache.replay(*this);
+}
+
+/*************************************************************************
+ * RASTER : DRAW BUFFER
+ * Nothing to batch, just draw each command
+ *************************************************************************/
+void ogstreamRaster :: drawBuffer(const DrawBuffer & buffer)
+{
+   buffer.replay(*this);
+}
+
+/*************************************************************************
+ * RASTER : WRITE PPM
+ * A binary (P6) portable pixmap. Every image viewer can read these
+ *************************************************************************/
+bool ogstreamRaster :: writePPM(ostream & out) const
+{
+   out << "P6\n" << width << " " << height << "\n255\n";
+   for (size_t i = 0; i < frame.size(); i += 4)
+      out.write((const char *)&frame[i], 3);
+   return out.good();
+}
+
+bool ogstreamRaster :: writePPM(const char * fileName) const
+{
+   ofstream fout(fileName, ios::binary);
+   if (!fout.is_open())
+      return false;
+   return writePPM(fout);
+}
+
+/*************************************************************************
+ * PNG helpers: the CRC-32 that guards every chunk and the Adler-32 that
+ * guards the compressed data
+ *************************************************************************/
+static unsigned long crc32(unsigned long crc, const unsigned char * data, size_t size)
+{
+   static unsigned long table[256];
+   static bool initialized = false;
+   if (!initialized)
+   {
+      for (unsigned long n = 0; n < 256; n++)
+      {
+         unsigned long c = n;
+         for (int k = 0; k < 8; k++)
+            c = (c & 1) ? 0xEDB88320UL ^ (c >> 1) : c >> 1;
+         table[n] = c;
+      }
+      initialized = true;
+   }
+
+   crc ^= 0xFFFFFFFFUL;
+   for (size_t i = 0; i < size; i++)
+      crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+   return crc ^ 0xFFFFFFFFUL;
+}
+
+static void putBigEndian(vector <unsigned char> & out, unsigned long value)
+{
+   out.push_back((unsigned char)(value >> 24));
+   out.push_back((unsigned char)(value >> 16));
+   out.push_back((unsigned char)(value >>  8));
+   out.push_back((unsigned char)(value >>  0));
+}
+
+static void writeChunk(ostream & out, const char * type, const vector <unsigned char> & data)
+{
+   vector <unsigned char> chunk;
+   putBigEndian(chunk, (unsigned long)data.size());
+   chunk.insert(chunk.end(), type, type + 4);
+   chunk.insert(chunk.end(), data.begin(), data.end());
+   putBigEndian(chunk, crc32(0, &chunk[4], chunk.size() - 4));
+   out.write((const char *)&chunk[0], chunk.size());
+}
+
+/*************************************************************************
+ * RASTER : WRITE PNG
+ * An RGBA PNG. The image data is stored rather than compressed so we
+ * need no library; the files are bigger but writing them is fast
+ *************************************************************************/
+bool ogstreamRaster :: writePNG(ostream & out) const
+{
+   static const unsigned char signature[8] = { 137, 'P', 'N', 'G', '\r', '\n', 26, '\n' };
+   out.write((const char *)signature, sizeof(signature));
+
+   // header: size, 8 bits per channel, RGBA, no interlace
+   vector <unsigned char> header;
+   putBigEndian(header, (unsigned long)width);
+   putBigEndian(header, (unsigned long)height);
+   header.push_back(8);
+   header.push_back(6);
+   header.push_back(0);
+   header.push_back(0);
+   header.push_back(0);
+   writeChunk(out, "IHDR", header);
+
+   // every row is preceded by its filter type, which is none
+   size_t rowSize = (size_t)width * 4;
+   vector <unsigned char> raw;
+   raw.reserve((rowSize + 1) * height);
+   for (int row = 0; row < height; row++)
+   {
+      raw.push_back(0);
+      raw.insert(raw.end(), frame.begin() + row * rowSize, frame.begin() + (row + 1) * rowSize);
+   }
+
+   // zlib stream made of stored deflate blocks
+   vector <unsigned char> data;
+   data.reserve(raw.size() + raw.size() / 65535 * 5 + 16);
+   data.push_back(0x78);
+   data.push_back(0x01);
+   unsigned long a = 1;
+   unsigned long b = 0;
+   size_t offset = 0;
+   do
+   {
+      size_t size = min(raw.size() - offset, (size_t)65535);
+      data.push_back(offset + size == raw.size() ? 1 : 0);
+      data.push_back((unsigned char)(size & 0xFF));
+      data.push_back((unsigned char)(size >> 8));
+      data.push_back((unsigned char)(~size & 0xFF));
+      data.push_back((unsigned char)((~size >> 8) & 0xFF));
+      for (size_t i = offset; i < offset + size; i++)
+      {
+         a = (a + raw[i]) % 65521;
+         b = (b + a) % 65521;
+      }
+      data.insert(data.end(), raw.begin() + offset, raw.begin() + offset + size);
+      offset += size;
+   }
+   while (offset < raw.size());
+   putBigEndian(data, (b << 16) | a);
+   writeChunk(out, "IDAT", data);
+
+   writeChunk(out, "IEND", vector <unsigned char>());
+   return out.good();
+}
+
+bool ogstreamRaster :: writePNG(const char * fileName) const
+{
+   ofstream fout(fileName, ios::binary);
+   if (!fout.is_open())
+      return false;
+   return writePNG(fout);
+}
+
+/*************************************************************************
+ * RASTER : WRITE RAW
+ * Append the frame to a stream of raw RGBA frames, top row first. Pipe
+ * it into a video encoder, for example:
+ *    ffmpeg -f rawvideo -pix_fmt rgba -s 700x500 -r 30 -i - shot.mp4
+ *************************************************************************/
+bool ogstreamRaster :: writeRaw(ostream & out) const
+{
+   out.write((const char *)&frame[0], frame.size());
+   return out.good();
+}
@@ -0,0 +1,73 @@
+/***********************************************************************
+ * Header File:
+ *    User Interface Raster : draw without a screen
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    A graphics stream that draws into an in-memory RGBA frame buffer
+ *    on the CPU. No window, X server, or OpenGL context is needed, so
+ *    frames can be rendered on build and batch machines and written out
+ *    as PPM or PNG images or as a raw video stream.
+ ************************************************************************/
+
+#ifndef uiRaster_h
+#define uiRaster_h
+
+#include "uiDraw.h"   // for ogstream
+#include <iostream>
+#include <vector>
+
+/*************************************************************************
+ * GRAPHICS STREAM RASTER
+ * Implements every ogstream draw method with a software rasterizer.
+ * The frame buffer is the size of the viewport and uses the same
+ * coordinates as the OpenGL window: pixel (0, 0) is the bottom left corner.
+ *************************************************************************/
+class ogstreamRaster : public ogstream
+{
+public:
+   ogstreamRaster(const Viewport & viewport);
+   ogstreamRaster(const Viewport & viewport, const Position & pos);
+   ~ogstreamRaster() { flush(); }
+
+   // start a new frame, white like the OpenGL window
+   void clear(double red = 1.0, double green = 1.0, double blue = 1.0);
+
+   // the ogstream interface
+   void drawLine(const Position & begin, const Position & end,
+                 double red = 0.0, double green = 0.0, double blue = 0.0);
+   void drawRectangle(const Position & begin, const Position & end,
+                      double red = 0.0, double green = 0.0, double blue = 0.0);
+   void drawProjectile(const Position & pos, double age = 0.0);
+   void drawHowitzer(const Position & pos, double angle, double age);
+   void drawTarget(const Position & pos);
+   void drawText(const Position & topLeft, const char * text);
+   void drawCache(const DrawCache & cache);
+   void drawBuffer(const DrawBuffer & buffer);
+
+   // get at the frame
+   int getWidth()  const { return width;  }
+   int getHeight() const { return height; }
+   const unsigned char * getPixel(int x, int y) const;
+   const std::vector <unsigned char> & getFrame() const { return frame; }
+
+   // write the frame out. Each returns false if the write failed
+   bool writePPM(std::ostream & out) const;
+   bool writePPM(const char * fileName) const;
+   bool writePNG(std::ostream & out) const;
+   bool writePNG(const char * fileName) const;
+   bool writeRaw(std::ostream & out) const;   // append to an RGBA video stream
+
+private:
+   void plot(int x, int y, unsigned char red, unsigned char green, unsigned char blue);
+   void line(int x0, int y0, int x1, int y1,
+             unsigned char red, unsigned char green, unsigned char blue);
+   void fill(double x0, double y0, double x1, double y1,
+             unsigned char red, unsigned char green, unsigned char blue);
+
+   int width;
+   int height;
+   std::vector <unsigned char> frame;     // RGBA, top row first
+};
+
+#endif /* uiRaster_h */
@@ -0,0 +1,190 @@
+/***********************************************************************
+ * Source File:
+ *    User Interface Record : remember what to draw for later
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    Recording draw commands into a buffer and playing them back.
+ *    Nothing in here touches OpenGL; the batched OpenGL playback
+ *    lives with the rest of the OpenGL code in uiDraw.cpp
+ ************************************************************************/
+
+#include "uiRecord.h"
+#include <cassert>
+#include <cstring>    // for strlen()
+
+using namespace std;
+
+/*************************************************************************
+ * TO CHANNEL
+ * Convert a color percentage into a byte
+ *************************************************************************/
+inline unsigned char toChannel(double percent)
+{
+   if (percent <= 0.0)
+      return 0;
+   if (percent >= 1.0)
+      return 255;
+   return (unsigned char)(percent * 255.0 + 0.5);
+}
+
+/*************************************************************************
+ * DRAW BUFFER :: ADD
+ * Append a command with two positions and a color
+ *************************************************************************/
+void DrawBuffer :: add(DrawCommand::Type type, const Position & begin, const Position & end,
+                       double red, double green, double blue)
+{
+   DrawCommand command;
+   command.type   = type;
+   command.red    = toChannel(red);
+   command.green  = toChannel(green);
+   command.blue   = toChannel(blue);
+   command.x0     = (float)begin.getMetersX();
+   command.y0     = (float)begin.getMetersY();
+   command.x1     = (float)end.getMetersX();
+   command.y1     = (float)end.getMetersY();
+   command.index  = 0;
+   command.length = 0;
+   commands.push_back(command);
+}
+
+/*************************************************************************
+ * DRAW BUFFER :: ADD PROJECTILE
+ * The age goes where the end point would be
+ *************************************************************************/
+void DrawBuffer :: addProjectile(const Position & pos, double age)
+{
+   add(DrawCommand::PROJECTILE, pos, pos, 0.0, 0.0, 0.0);
+   commands.back().x1 = (float)age;
+}
+
+/*************************************************************************
+ * DRAW BUFFER :: ADD HOWITZER
+ * The angle and age go where the end point would be
+ *************************************************************************/
+void DrawBuffer :: addHowitzer(const Position & pos, double angle, double age)
+{
+   add(DrawCommand::HOWITZER, pos, pos, 0.0, 0.0, 0.0);
+   commands.back().x1 = (float)angle;
+   commands.back().y1 = (float)age;
+}
+
+/*************************************************************************
+ * DRAW BUFFER :: ADD TEXT
+ * The characters go in the text arena, the command remembers where
+ *************************************************************************/
+void DrawBuffer :: addText(const Position & topLeft, const char * text)
+{
+   assert(text != NULL);
+   size_t length = strlen(text);
+
+   add(DrawCommand::TEXT, topLeft, topLeft, 0.0, 0.0, 0.0);
+   commands.back().index  = (unsigned int)this->text.size();
+   commands.back().length = (unsigned int)length;
+   this->text.insert(this->text.end(), text, text + length + 1);
+}
+
+/*************************************************************************
+ * DRAW BUFFER :: ADD CACHE
+ * We only remember where the cache is, so it must not be destroyed
+ * or rebuilt until the buffer has been played back
+ *************************************************************************/
+void DrawBuffer :: addCache(const DrawCache & cache)
+{
+   add(DrawCommand::CACHE, Position(), Position(), 0.0, 0.0, 0.0);
+   commands.back().index = (unsigned int)caches.size();
+   caches.push_back(&cache);
+}
+
+/*************************************************************************
+ * DRAW BUFFER :: CLEAR
+ * Nothing recorded points at a copy any more, so this is when the copies
+ * of caches that were not drawn last time go. Caches come and go with
+ * the game, and an old one is never drawn again
+ *************************************************************************/
+void DrawBuffer :: clear()
+{
+   commands.clear();
+   text.clear();
+   caches.clear();
+
+   size_t iKept = 0;
+   for (size_t i = 0; i < copies.size(); i++)
+      if (copies[i].isUsed)
+      {
+         copies[i].isUsed = false;
+         if (iKept != i)
+            copies[iKept] = move(copies[i]);
+         iKept++;
+      }
+   copies.resize(iKept);
+}
+
+/*************************************************************************
+ * DRAW BUFFER :: ADD CACHE COPY
+ * The copy we already have if the cache is the same generation it was
+ * then. If not, copy it over the old one in place: whoever compiled the
+ * old one sees the generation change and compiles it again. The copy is
+ * found by the cache's id rather than where it is, since a new cache may
+ * be made where an old one was
+ *************************************************************************/
+void DrawBuffer :: addCacheCopy(const DrawCache & cache)
+{
+   CacheCopy * pCopy = NULL;
+   for (vector <CacheCopy> :: iterator it = copies.begin(); it != copies.end(); ++it)
+      if (it->id == cache.getId())
+         pCopy = &*it;
+
+   if (pCopy == NULL)
+   {
+      CacheCopy copy = { cache.getId(), cache.getGeneration(), false, unique_ptr <DrawCache> (new DrawCache(cache)) };
+      copies.push_back(move(copy));
+      pCopy = &copies.back();
+   }
+   else if (pCopy->generation != cache.getGeneration())
+   {
+      *pCopy->cache = cache;
+      pCopy->generation = cache.getGeneration();
+   }
+   pCopy->isUsed = true;
+   addCache(*pCopy->cache);
+}
+
+/*************************************************************************
+ * DRAW BUFFER :: REPLAY
+ * Send every command, in order, through a graphics stream
+ *************************************************************************/
+void DrawBuffer :: replay(ogstream & gout) const
+{
+   for (vector <DrawCommand> :: const_iterator it = commands.begin(); it != commands.end(); ++it)
+   {
+      const DrawCommand & command = *it;
+      switch (command.type)
+      {
+         case DrawCommand::LINE:
+            gout.drawLine(getBegin(command), getEnd(command),
+                          command.red / 255.0, command.green / 255.0, command.blue / 255.0);
+            break;
+         case DrawCommand::RECTANGLE:
+            gout.drawRectangle(getBegin(command), getEnd(command),
+                               command.red / 255.0, command.green / 255.0, command.blue / 255.0);
+            break;
+         case DrawCommand::PROJECTILE:
+            gout.drawProjectile(getBegin(command), (double)command.x1);
+            break;
+         case DrawCommand::HOWITZER:
+            gout.drawHowitzer(getBegin(command), (double)command.x1, (double)command.y1);
+            break;
+         case DrawCommand::TARGET:
+            gout.drawTarget(getBegin(command));
+            break;
+         case DrawCommand::TEXT:
+            gout.drawText(getBegin(command), getText(command));
+            break;
+         case DrawCommand::CACHE:
+            gout.drawCache(getCache(command));
+            break;
+      }
+   }
+}
@@ -0,0 +1,178 @@
+/***********************************************************************
+ * Header File:
+ *    User Interface Record : remember what to draw for later
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    A graphics stream that, instead of drawing, appends compact draw
+ *    commands to a buffer. The buffer can be filled on any thread and
+ *    replayed later on the thread that owns the graphics, either through
+ *    OpenGL (batched) or through any other ogstream.
+ ************************************************************************/
+
+#ifndef uiRecord_h
+#define uiRecord_h
+
+#include "uiDraw.h"   // for ogstream and DrawCache
+#include <memory>     // for unique_ptr
+#include <vector>
+
+/*************************************************************************
+ * DRAW COMMAND
+ * One thing to draw. Coordinates are in meters so the buffer does
+ * not depend on the zoom that was in effect when it was recorded
+ *************************************************************************/
+struct DrawCommand
+{
+   enum Type : unsigned char
+   {
+      LINE, RECTANGLE, PROJECTILE, HOWITZER, TARGET, TEXT, CACHE
+   };
+
+   Type type;
+   unsigned char red;       // 0 - 255
+   unsigned char green;
+   unsigned char blue;
+   float x0;                // position, start of a line, or corner
+   float y0;
+   float x1;                // end of a line or opposite corner,
+   float y1;                //    or angle and age for the howitzer
+   unsigned int index;      // offset of the text, or which cache
+   unsigned int length;     // length of the text
+};
+
+/*************************************************************************
+ * DRAW BUFFER
+ * A reusable list of draw commands. clear() keeps the memory so, once
+ * the buffer has grown to the size of a frame, recording allocates nothing.
+ * It keeps its copies of caches too, so a cache that has not changed
+ * since the last frame is not copied again. A copy that goes a frame
+ * without being drawn is dropped
+ *************************************************************************/
+class DrawBuffer
+{
+public:
+   DrawBuffer()
+   {
+      commands.reserve(256);
+      text.reserve(1024);
+   }
+
+   // forget the commands but keep the memory, and the copies of caches
+   // that were drawn since the last clear()
+   void clear();
+
+   bool   empty() const { return commands.empty(); }
+   size_t size()  const { return commands.size();  }
+   size_t sizeCacheCopies() const { return copies.size(); }
+
+   // record
+   void addLine(const Position & begin, const Position & end,
+                double red, double green, double blue)
+   {
+      add(DrawCommand::LINE, begin, end, red, green, blue);
+   }
+   void addRectangle(const Position & begin, const Position & end,
+                     double red, double green, double blue)
+   {
+      add(DrawCommand::RECTANGLE, begin, end, red, green, blue);
+   }
+   void addProjectile(const Position & pos, double age);
+   void addHowitzer(const Position & pos, double angle, double age);
+   void addTarget(const Position & pos)
+   {
+      add(DrawCommand::TARGET, pos, pos, 0.0, 0.0, 0.0);
+   }
+   void addText(const Position & topLeft, const char * text);
+   void addCache(const DrawCache & cache);
+   void addCacheCopy(const DrawCache & cache);
+
+   // play back one command at a time through any graphics stream
+   void replay(ogstream & gout) const;
+
+   // access for back-ends that want to batch the commands themselves
+   const std::vector <DrawCommand> & getCommands() const { return commands; }
+   const char * getText(const DrawCommand & command) const { return &text[command.index]; }
+   const DrawCache & getCache(const DrawCommand & command) const { return *caches[command.index]; }
+   static Position getBegin(const DrawCommand & command)
+   {
+      return Position((double)command.x0, (double)command.y0);
+   }
+   static Position getEnd(const DrawCommand & command)
+   {
+      return Position((double)command.x1, (double)command.y1);
+   }
+
+private:
+   void add(DrawCommand::Type type, const Position & begin, const Position & end,
+            double red, double green, double blue);
+
+   std::vector <DrawCommand>       commands;
+   std::vector <char>              text;    // every string, null terminated
+   std::vector <const DrawCache *> caches;  // must outlive the replay
+
+   // a copy of a cache as it was at one generation of it
+   struct CacheCopy
+   {
+      unsigned int id;                     // of the source
+      unsigned int generation;             // of the source, when copied
+      bool isUsed;                         // drawn since the last clear()
+      std::unique_ptr <DrawCache> cache;   // stays put, so caches may point at it
+   };
+   std::vector <CacheCopy> copies;         // the used ones are kept across clear()
+};
+
+/*************************************************************************
+ * GRAPHICS STREAM RECORD
+ * A graphics stream that records into a DrawBuffer rather than drawing.
+ * It never touches OpenGL so it is safe to use from any thread. The
+ * viewport only places the lines of streamed text; everything else is
+ * recorded in meters and placed by whoever plays it back
+ *************************************************************************/
+class ogstreamRecord : public ogstream
+{
+public:
+   ogstreamRecord(DrawBuffer & buffer) : buffer(buffer), isCopyingCaches(false) {}
+   ogstreamRecord(DrawBuffer & buffer, const Position & pos) :
+      ogstream(pos), buffer(buffer), isCopyingCaches(false) {}
+   ogstreamRecord(DrawBuffer & buffer, const Viewport & viewport) :
+      ogstream(viewport), buffer(buffer), isCopyingCaches(false) {}
+   ogstreamRecord(DrawBuffer & buffer, const Viewport & viewport, const Position & pos) :
+      ogstream(viewport, pos), buffer(buffer), isCopyingCaches(false) {}
+   ~ogstreamRecord() { flush(); }
+
+   // Normally a cache is recorded by reference. Copy it instead when the
+   // buffer may be played back after the cache has been rebuilt, such as
+   // when it is handed to another thread. The buffer keeps the copy, and
+   // only copies again when the cache's generation changes
+   void setCopyCaches(bool isCopyingCaches) { this->isCopyingCaches = isCopyingCaches; }
+
+   void drawLine(const Position & begin, const Position & end,
+                 double red = 0.0, double green = 0.0, double blue = 0.0)
+   {
+      buffer.addLine(begin, end, red, green, blue);
+   }
+   void drawRectangle(const Position & begin, const Position & end,
+                      double red = 0.0, double green = 0.0, double blue = 0.0)
+   {
+      buffer.addRectangle(begin, end, red, green, blue);
+   }
+   void drawProjectile(const Position & pos, double age = 0.0) { buffer.addProjectile(pos, age);        }
+   void drawHowitzer(const Position & pos, double angle, double age) { buffer.addHowitzer(pos, angle, age); }
+   void drawTarget(const Position & pos)                       { buffer.addTarget(pos);                }
+   void drawText(const Position & topLeft, const char * text)  { buffer.addText(topLeft, text);        }
+   void drawCache(const DrawCache & cache)
+   {
+      if (isCopyingCaches)
+         buffer.addCacheCopy(cache);
+      else
+         buffer.addCache(cache);
+   }
+   void drawBuffer(const DrawBuffer & other)                   { other.replay(*this);                  }
+
+private:
+   DrawBuffer & buffer;
+   bool isCopyingCaches;
+};
+
+#endif /* uiRecord_h */
@@ -0,0 +1,119 @@
+/***********************************************************************
+ * Header File:
+ *    Viewport : where the field is on the screen
+ * Author:
+ *    Amber Robbins
+ * Summary:
+ *    The transform from meters on the field to pixels on the screen:
+ *    how many meters a pixel covers, and which point on the field is
+ *    at the bottom left corner. Each graphics stream carries its own,
+ *    so a zoomed inset can be drawn beside the main view, and a thread
+ *    can draw without touching anyone else's zoom.
+ *
+ *    The physics never sees a viewport. Everything it knows is in meters.
+ ************************************************************************/
+
+#ifndef viewport_h
+#define viewport_h
+
+#include "position.h"
+#include <cassert>
+
+/*********************************************
+ * VIEWPORT
+ * Width and height are in pixels. The rest
+ * converts between the two, multiplying by a
+ * precomputed reciprocal rather than dividing
+ *********************************************/
+class Viewport
+{
+public:
+   // the field from the origin at the zoom Position has. That may not be
+   // set yet when this is a static, hence no assert
+   Viewport() : width(0.0), height(0.0), xOrigin(0.0), yOrigin(0.0),
+      metersFromPixels(Position().getZoom()),
+      pixelsFromMeters(metersFromPixels > 0.0 ? 1.0 / metersFromPixels : 0.0) {}
+   Viewport(double width, double height, double metersFromPixels,
+            double xOrigin = 0.0, double yOrigin = 0.0) :
+      width(width), height(height), xOrigin(xOrigin), yOrigin(yOrigin)
+   {
+      setZoom(metersFromPixels);
+   }
+
+   // meters on the field to pixels on the screen
+   double toPixelsX(double xMeters) const { return (xMeters - xOrigin) * pixelsFromMeters; }
+   double toPixelsY(double yMeters) const { return (yMeters - yOrigin) * pixelsFromMeters; }
+
+   // and back again
+   double toMetersX(double xPixels) const { return xOrigin + xPixels * metersFromPixels; }
+   double toMetersY(double yPixels) const { return yOrigin + yPixels * metersFromPixels; }
+   Position toMeters(double xPixels, double yPixels) const
+   {
+      return Position(toMetersX(xPixels), toMetersY(yPixels));
+   }
+
+   // a distance on the screen, as a distance on the field
+   double toMeters(double pixels) const { return pixels * metersFromPixels; }
+
+   // move a point on the field so many pixels on the screen
+   Position offset(const Position & pos, double dxPixels, double dyPixels) const
+   {
+      return Position(pos.getMetersX() + dxPixels * metersFromPixels,
+                      pos.getMetersY() + dyPixels * metersFromPixels);
+   }
+
+   // the size of the screen
+   double getWidth()  const { return width;  }
+   double getHeight() const { return height; }
+
+   // the corners of the screen, on the field
+   Position getBottomLeft() const { return Position(xOrigin, yOrigin); }
+   Position getUpperRight() const { return toMeters(width, height);     }
+
+   // the zoom
+   double getMetersFromPixels() const { return metersFromPixels; }
+   double getPixelsFromMeters() const { return pixelsFromMeters; }
+   void setZoom(double metersFromPixels)
+   {
+      assert(metersFromPixels > 0.0);
+      this->metersFromPixels = metersFromPixels;
+      this->pixelsFromMeters = 1.0 / metersFromPixels;
+   }
+
+   // put this point on the field at the bottom left of the screen
+   void setOrigin(const Position & pos)
+   {
+      xOrigin = pos.getMetersX();
+      yOrigin = pos.getMetersY();
+   }
+
+   // a viewport of the given size showing the field around center
+   // magnified by factor
+   Viewport inset(const Position & center, double factor,
+                  double width, double height) const
+   {
+      assert(factor > 0.0);
+      double metersFromPixelsInset = metersFromPixels / factor;
+      return Viewport(width, height, metersFromPixelsInset,
+                      center.getMetersX() - width  / 2.0 * metersFromPixelsInset,
+                      center.getMetersY() - height / 2.0 * metersFromPixelsInset);
+   }
+
+   // the same transform? Anything compiled for one is good for the other
+   bool operator == (const Viewport & rhs) const
+   {
+      return metersFromPixels == rhs.metersFromPixels &&
+             xOrigin == rhs.xOrigin && yOrigin == rhs.yOrigin;
+   }
+   bool operator != (const Viewport & rhs) const { return !(*this == rhs); }
+
+private:
+   double width;             // pixels
+   double height;
+   double xOrigin;           // meters at the bottom left corner
+   double yOrigin;
+   double metersFromPixels;  // the zoom
+   double pixelsFromMeters;  // 1 / metersFromPixels
+};
+
+#endif /* viewport_h */